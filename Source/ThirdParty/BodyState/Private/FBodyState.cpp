@@ -89,6 +89,10 @@ int32 FBodyState::GetDefaultDeviceID()
 {
 	return SkeletonStorage->GetDefaultDeviceID();
 } 
+void FBodyState::UpdateMergedSkeleton()
+{
+	SkeletonStorage->UpdateMergeSkeletonData();
+}
 int32 FBodyState::AttachMergingFunctionForSkeleton(
 		TFunction<void(UBodyStateSkeleton*, float)> InFunction, int32 SkeletonId /*= 0*/)
 	{
@@ -59,6 +59,7 @@ public:
 	virtual void SetupGlobalDeviceManager(IBodyStateDeviceManagerRawInterface* CallbackInterface) override;
 	virtual int32 RequestCombinedDevice(const TArray<FString>& DeviceSerials, const EBSDeviceCombinerClass CombinerClass) override;
 	virtual int32 GetDefaultDeviceID() override;
+	virtual void UpdateMergedSkeleton() override;
 
 private:
 	bool bActive = false;
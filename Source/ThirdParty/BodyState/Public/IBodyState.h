@@ -112,4 +112,9 @@ public:
 	{
 		return 0;
 	}
+
+	/** Runs the skeleton merge normally done on the input device tick, used for profiling */
+	virtual void UpdateMergedSkeleton()
+	{
+	}
 };
\ No newline at end of file
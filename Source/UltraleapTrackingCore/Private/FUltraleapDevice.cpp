@@ -10,10 +10,13 @@
 #include "BodyStateBPLibrary.h"
 #include "Engine/Engine.h"
 #include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
 #include "IBodyState.h"
 #include "IXRTrackingSystem.h"
 #include "LeapAsync.h"
 #include "LeapComponent.h"
+#include "LeapFrameHistory.h"
+#include "LeapGameThreadQueue.h"
 #include "LeapUtility.h"
 #include "Skeleton/BodyStateSkeleton.h"
 #include "UltraleapTrackingData.h"
@@ -21,7 +24,30 @@
 
 DECLARE_STATS_GROUP(TEXT("UltraleapMultiTracking"), STATGROUP_UltraleapMultiTracking, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("Multi Leap Game Input and Events"), STAT_MultiLeapInputTick, STATGROUP_UltraleapMultiTracking);
+DECLARE_CYCLE_STAT(TEXT("Multi Leap Gestures and Events"), STAT_MultiLeapEvents, STATGROUP_UltraleapMultiTracking);
 DECLARE_CYCLE_STAT(TEXT("Multi Leap BodyState Tick"), STAT_MultiLeapBodyStateTick, STATGROUP_UltraleapMultiTracking);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Skipped Ticks"), STAT_LeapSkippedTicks, STATGROUP_UltraleapMultiTracking);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Interpolation Only Ticks"), STAT_LeapInterpolationOnlyTicks, STATGROUP_UltraleapMultiTracking);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Poses Converted On Ingest"), STAT_LeapIngestedPoses, STATGROUP_UltraleapMultiTracking);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Skipped BodyState Updates"), STAT_LeapSkippedBodyStateUpdates, STATGROUP_UltraleapMultiTracking);
+
+DECLARE_STATS_GROUP(TEXT("UltraleapFramePacing"), STATGROUP_UltraleapFramePacing, STATCAT_Advanced);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Leap Observed Frame Rate"), STAT_LeapObservedFrameRate, STATGROUP_UltraleapFramePacing);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Leap Device Frame Rate"), STAT_LeapDeviceFrameRate, STATGROUP_UltraleapFramePacing);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Leap Frame Interval Jitter (ms)"), STAT_LeapFrameJitter, STATGROUP_UltraleapFramePacing);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Leap Delivery Delay (ms)"), STAT_LeapDeliveryDelay, STATGROUP_UltraleapFramePacing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Service Dropped Frames"), STAT_LeapServiceDroppedFrames, STATGROUP_UltraleapFramePacing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Missed Frame Ids"), STAT_LeapMissedFrameIds, STATGROUP_UltraleapFramePacing);
+
+static TAutoConsoleVariable<int32> CVarLeapIngestThreadConversion(TEXT("leap.IngestThreadConversion"), 1,
+	TEXT("Convert tracking frames to plugin poses on the LeapC thread as they arrive when they are used without "
+		 "interpolation, leaving only a copy for the game thread. 0 converts during capture."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarLeapSkipUnchangedFrames(TEXT("leap.SkipUnchangedFrames"), 1,
+	TEXT("Skip game thread processing for ticks where the device has no new tracking frame. Interpolated ticks still update "
+		 "the pose but skip the gesture and visibility checks. 0 processes every tick."),
+	ECVF_Default);
 
 #pragma region Utility
 bool FUltraleapDevice::bUseNewTrackingModeAPI = true;
@@ -52,30 +78,86 @@ FTransform FUltraleapDevice::ConvertUEDeviceOriginToBSTransform(const FTransform
 	return Ret;
 }
 // Function call Utility
-void FUltraleapDevice::CallFunctionOnComponents(TFunction<void(ULeapComponent*)> InFunction)
+void FUltraleapDevice::RefreshSubscribedEvents()
+{
+	check(IsInGameThread());
+
+	SubscribedEvents = ELeapEventSubscription::None;
+	for (const ULeapComponent* EventDelegate : EventDelegates)
+	{
+		SubscribedEvents |= EventDelegate->GetSubscriptionMask();
+	}
+}
+
+void FUltraleapDevice::CallFunctionOnComponents(const ELeapEventSubscription Events, TFunction<void(ULeapComponent*)> InFunction)
 {
 	// Callback optimization
-	if (EventDelegates.Num() <= 0)
+	if (EventDelegates.Num() <= 0 || (Events != ELeapEventSubscription::None && !EnumHasAnyFlags(SubscribedEvents, Events)))
 	{
 		return;
 	}
 
 	if (IsInGameThread())
 	{
-		for (ULeapComponent* EventDelegate : EventDelegates)
+		DispatchToComponents(Events, InFunction);
+	}
+	else
+	{
+		FLeapGameThreadQueue::Get().Enqueue(
+			this, [this, Events, InFunction = MoveTemp(InFunction)] { DispatchToComponents(Events, InFunction); });
+	}
+}
+
+void FUltraleapDevice::DispatchToComponents(const ELeapEventSubscription Events, const TFunction<void(ULeapComponent*)>& InFunction)
+{
+	for (ULeapComponent* EventDelegate : EventDelegates)
+	{
+		// the cached union may be a tick old, check the bindings as they are now
+		if (Events == ELeapEventSubscription::None || EventDelegate->IsSubscribedTo(Events))
 		{
 			InFunction(EventDelegate);
 		}
 	}
-	else
+}
+
+void FUltraleapDevice::CallHandFunctionOnComponents(const ELeapEventSubscription Events, const FLeapHandPose& Hand,
+	TFunction<void(ULeapComponent*, const FLeapHandData&)> InFunction)
+{
+	// only build the Blueprint hand if someone is listening
+	if (EventDelegates.Num() <= 0 || !EnumHasAnyFlags(SubscribedEvents, Events))
 	{
-		FLeapAsync::RunShortLambdaOnGameThread([this, InFunction] {
-			for (ULeapComponent* EventDelegate : EventDelegates)
-			{
-				InFunction(EventDelegate);
-			}
-		});
+		return;
 	}
+
+	FLeapHandData HandData;
+	Hand.ToHandData(HandData);
+	CallFunctionOnComponents(
+		Events, [HandData, InFunction = MoveTemp(InFunction)](ULeapComponent* Component) { InFunction(Component, HandData); });
+}
+
+FLeapFrameSnapshotRef FUltraleapDevice::GetCurrentFrameSnapshot()
+{
+	if (bCurrentFrameStale || !CurrentFrame.IsValid())
+	{
+		// Reusing the last frame keeps the nested arrays' allocations, but only if no listener still holds it
+		if (!CurrentFrame.IsValid() || !CurrentFrame.IsUnique())
+		{
+			CurrentFrame = MakeShared<FLeapFrameData, ESPMode::ThreadSafe>();
+		}
+		CurrentPose.ToFrameData(*CurrentFrame);
+		bCurrentFrameStale = false;
+	}
+	return CurrentFrame.ToSharedRef();
+}
+
+FLeapFrameData& FUltraleapDevice::GetMutableCurrentFrameData()
+{
+	GetCurrentFrameSnapshot();
+	if (!CurrentFrame.IsUnique())
+	{
+		CurrentFrame = MakeShared<FLeapFrameData, ESPMode::ThreadSafe>(*CurrentFrame);
+	}
+	return *CurrentFrame;
 }
 
 // UE v4.6 IM event wrappers
@@ -129,7 +211,17 @@ bool FUltraleapDevice::HandPinched(float Strength)
 
 int64 FUltraleapDevice::GetInterpolatedNow()
 {
-	return Leap->GetNow() + HandInterpolationTimeOffset;
+	return GetLeapTimeAtPlatformTime(FPlatformTime::Seconds()) + HandInterpolationTimeOffset;
+}
+
+int64 FUltraleapDevice::GetLeapTimeAtPlatformTime(const double PlatformSeconds)
+{
+	int64 LeapTime = 0;
+	if (ClockRebaser.Rebase(PlatformSeconds, LeapTime))
+	{
+		return LeapTime;
+	}
+	return Leap->GetNow() + (int64) ((PlatformSeconds - FPlatformTime::Seconds()) * 1000000.0);
 }
 
 // comes from service message loop
@@ -144,12 +236,29 @@ void FUltraleapDevice::InitOptions()
 
 void FUltraleapDevice::OnFrame(const LEAP_TRACKING_EVENT* Frame)
 {
+	FramePacing.RecordFrame(Frame, Leap ? Leap->GetNow() : 0);
+
+	// nullptr until the first Tick has published
+	const FIngestSettings* Settings = PublishedIngestSettings.Acquire();
+	// before the raw frame is handed over, so the capture finds the pose for any frame it sees
+	if (Settings && Settings->bEnabled && Frame)
+	{
+		FLeapFramePose& Pose = IngestedPoses.BeginWrite();
+		Pose.SetFromLeapFrame(Frame, Settings->MountTranslationOffset, Settings->MountRotationOffset, Settings->Scale);
+		IngestedPoses.EndWrite();
+	}
+
 	if (TrackingDeviceWrapper)
 	{
 		TrackingDeviceWrapper->HandleTrackingEvent(Frame);
 	}
 }
 
+void FUltraleapDevice::OnDroppedFrame(const LEAP_DROPPED_FRAME_EVENT* DroppedFrameEvent)
+{
+	FramePacing.RecordDroppedFrame(DroppedFrameEvent);
+}
+
 void FUltraleapDevice::OnImage(const LEAP_IMAGE_EVENT* ImageEvent)
 {
 	// Forward it to the handler
@@ -160,7 +269,7 @@ void FUltraleapDevice::OnImageCallback(UTexture2D* LeftCapturedTexture, UTexture
 {
 	// Handler has returned with batched easy-to-parse results, forward callback
 	// on game thread
-	CallFunctionOnComponents([LeftCapturedTexture, RightCapturedTexture](ULeapComponent* Component) {
+	CallFunctionOnComponents(ELeapEventSubscription::Images, [LeftCapturedTexture, RightCapturedTexture](ULeapComponent* Component) {
 		Component->OnImageEvent.Broadcast(LeftCapturedTexture, ELeapImageType::LEAP_IMAGE_LEFT);
 		Component->OnImageEvent.Broadcast(RightCapturedTexture, ELeapImageType::LEAP_IMAGE_RIGHT);
 	});
@@ -186,8 +295,8 @@ void FUltraleapDevice::OnPolicy(const uint32_t CurrentPolicies)
 
 	Options.Mode = UpdatedMode;
 
-	// Update mode for each component and broadcast current policies
-	CallFunctionOnComponents([&, UpdatedMode, Flags](ULeapComponent* Component) {
+	// Update mode for each component and broadcast current policies, every component tracks the mode
+	CallFunctionOnComponents(ELeapEventSubscription::None, [&, UpdatedMode, Flags](ULeapComponent* Component) {
 		Component->TrackingMode = UpdatedMode;
 		Component->OnLeapPoliciesUpdated.Broadcast(Flags);
 	});
@@ -207,8 +316,8 @@ void FUltraleapDevice::OnTrackingMode(const eLeapTrackingMode CurrentMode)
 			break;
 	}
 	ELeapMode UpdatedMode = Options.Mode;
-	// Update mode for each component and broadcast current policies
-	CallFunctionOnComponents([&, UpdatedMode](ULeapComponent* Component) {
+	// Update mode for each component and broadcast current policies, every component tracks the mode
+	CallFunctionOnComponents(ELeapEventSubscription::None, [&, UpdatedMode](ULeapComponent* Component) {
 		Component->TrackingMode = UpdatedMode;
 		Component->OnLeapTrackingModeUpdated.Broadcast(UpdatedMode);
 	});
@@ -365,6 +474,13 @@ FUltraleapDevice::~FUltraleapDevice()
 #endif
 
 	ShutdownLeap();
+
+	// queued callbacks must not reach a deleted device
+	if (IsInGameThread())
+	{
+		FLeapGameThreadQueue::Get().DiscardTarget(this);
+		FLeapGameThreadQueue::Get().DiscardOwner(this);
+	}
 }
 
 void FUltraleapDevice::Tick(float DeltaTime)
@@ -372,30 +488,122 @@ void FUltraleapDevice::Tick(float DeltaTime)
 	GameTimeInSec += DeltaTime;
 	FrameTimeInMicros = DeltaTime * 1000000;
 	DeltaTimeFromTick = DeltaTime;
-	
+	RefreshSubscribedEvents();
+
+	// One paired clock sample per frame keeps the rebaser's drift estimate current
+	FramePlatformTime = FPlatformTime::Seconds();
+	ClockRebaser.Update(FramePlatformTime, Leap->GetNow());
+
+	// The HMD pose is only read here on the game thread, CaptureInput may run on a task graph worker
+	if (!Options.bUseOpenXRAsSource)
+	{
+		SnapshotHandler.AddCurrentHMDSample(GetLeapTimeAtPlatformTime(FramePlatformTime));
+		if (Options.Mode == LEAP_MODE_VR && Options.bTransformOriginToHMD)
+		{
+			FrameHMDSample = BSHMDSnapshotHandler::CurrentHMDSample(Leap->GetNow());
+		}
+	}
+
+	if (FramePlatformTime - LastFramePacingSampleTime >= 1.0)
+	{
+		SampleFramePacing();
+	}
+	UpdateIngestSettings();
+}
+
+void FUltraleapDevice::UpdateIngestSettings()
+{
+	FIngestSettings& Settings = IngestSettings;
+	// interpolated and OpenXR frames are built at capture time, there's nothing to prepare
+	Settings.bEnabled = CVarLeapIngestThreadConversion.GetValueOnGameThread() != 0 && !Options.bUseInterpolation &&
+						!Options.bUseOpenXRAsSource && Leap->GetDeviceType() == IHandTrackingWrapper::DEVICE_TYPE_LEAP;
+	Settings.MountTranslationOffset = Options.HMDPositionOffset;
+	Settings.MountRotationOffset = Options.HMDRotationOffset.Quaternion();
+	// the world scale lookup needs the game thread
+	FrameLeapToUEScale = FLeapUtility::GetLeapToUEScale();
+	Settings.Scale = FrameLeapToUEScale;
+
+	PublishedIngestSettings.BeginWrite() = Settings;
+	PublishedIngestSettings.EndWrite();
+}
+
+const FLeapFramePose* FUltraleapDevice::AcquireIngestedPose(const LEAP_TRACKING_EVENT* Frame)
+{
+	if (!IngestSettings.bEnabled)
+	{
+		return nullptr;
+	}
+	const FLeapFramePose* Pose = IngestedPoses.Acquire();
+	// the two buffers are handed over separately, a pose for another frame than Frame is converted here instead
+	if (!Pose || Pose->FrameId != (int32) Frame->tracking_frame_id || Pose->TimeStamp != Frame->info.timestamp)
+	{
+		return nullptr;
+	}
+	return Pose;
+}
+
+void FUltraleapDevice::SampleFramePacing()
+{
+	LastFramePacingSampleTime = FramePlatformTime;
+
+	FLeapFramePacingStats& Pacing = Stats.FramePacing;
+	FramePacing.Sample(Pacing);
+	// a service round trip, hence only once a second
+	Pacing.DeviceFrameRate = Leap->GetDeviceFrameRate();
+
+	SET_FLOAT_STAT(STAT_LeapObservedFrameRate, Pacing.ObservedFrameRate);
+	SET_FLOAT_STAT(STAT_LeapDeviceFrameRate, Pacing.DeviceFrameRate);
+	SET_FLOAT_STAT(STAT_LeapFrameJitter, Pacing.FrameIntervalJitterInMS);
+	SET_FLOAT_STAT(STAT_LeapDeliveryDelay, Pacing.DeliveryDelayInMS);
+	SET_DWORD_STAT(STAT_LeapServiceDroppedFrames,
+		Pacing.DroppedInPreprocessingQueue + Pacing.DroppedInTrackingQueue + Pacing.DroppedOther);
+	SET_DWORD_STAT(STAT_LeapMissedFrameIds, Pacing.MissedFrameIds);
 }
 
 // Main loop event emitter
 void FUltraleapDevice::SendControllerEvents()
 {
+	CaptureInput();
+	EmitInputEvents();
+}
+bool FUltraleapDevice::CanCaptureOffGameThread()
+{
+	// OpenXR hand data comes from the XR system
+	return !Options.bUseOpenXRAsSource && Leap->GetDeviceType() != IHandTrackingWrapper::DEVICE_TYPE_OPENXR;
+}
+void FUltraleapDevice::CaptureInput()
+{
+	bInputEventsPending = false;
 	CaptureAndEvaluateInput();
 }
+void FUltraleapDevice::EmitInputEvents()
+{
+	if (!bInputEventsPending)
+	{
+		return;
+	}
+	bInputEventsPending = false;
+	EmitEvents();
+}
 void FUltraleapDevice::GetLatestFrameData(FLeapFrameData& OutData,const bool ApplyDeviceOriginIn /* = false */)
 {
-	OutData = CurrentFrame;
+	OutData = GetCurrentFrameData();
 
 	if (ApplyDeviceOriginIn)
 	{
 		ApplyDeviceOrigin(OutData);
 	}
 }
+FLeapFrameSnapshotPtr FUltraleapDevice::GetLatestFrameSnapshot()
+{
+	return GetCurrentFrameSnapshot();
+}
 void FUltraleapDevice::ApplyDeviceOrigin(FLeapFrameData& OutData)
 {
 	// in BS Space
 	const FTransform& Origin = GetDeviceOrigin();
 
-	OutData.RotateFrame(Origin.GetRotation().Rotator());
-	OutData.TranslateFrame(Origin.GetLocation());
+	OutData.TransformFrame(FTransform(Origin.GetRotation(), Origin.GetLocation()));
 }
 void FUltraleapDevice::CaptureAndEvaluateInput()
 {
@@ -415,74 +623,158 @@ void FUltraleapDevice::CaptureAndEvaluateInput()
 	{
 		return;
 	}
+
+	// The game usually ticks faster than the device tracks, most ticks see the frame the previous one did
+	const bool bNewSourceFrame = Frame->tracking_frame_id != LastSourceFrameId || Frame->info.timestamp != LastSourceTimeStamp;
+	const bool bSourceFrameEmpty = Frame->nHands == 0;
+	const bool bWasSourceFrameEmpty = bLastSourceFrameEmpty;
+	LastSourceFrameId = Frame->tracking_frame_id;
+	LastSourceTimeStamp = Frame->info.timestamp;
+	bLastSourceFrameEmpty = bSourceFrameEmpty;
+
+	const bool bInterpolationOnly = !bNewSourceFrame && CVarLeapSkipUnchangedFrames.GetValueOnAnyThread() != 0;
+	if (bInterpolationOnly)
+	{
+		// Unless it's interpolated to the query time or moved with the HMD, the result would be last tick's exactly
+		const bool bDependsOnQueryTime = Options.bUseInterpolation ||
+			(Options.Mode == LEAP_MODE_VR && Options.bTransformOriginToHMD && !Options.bUseOpenXRAsSource);
+		if (!bDependsOnQueryTime || (bSourceFrameEmpty && bWasSourceFrameEmpty))
+		{
+			INC_DWORD_STAT(STAT_LeapSkippedTicks);
+			return;
+		}
+		INC_DWORD_STAT(STAT_LeapInterpolationOnlyTicks);
+	}
+
+	HandInterpolationTimeOffset = Options.HandInterpFactor * FrameTimeInMicros;
+	FingerInterpolationTimeOffset = Options.FingerInterpFactor * FrameTimeInMicros;
+
 	if (!Options.bUseOpenXRAsSource)
 	{
 		TimeWarpTimeStamp = Frame->info.timestamp;
-		int64 LeapTimeNow = 0;
-		LeapTimeNow = Leap->GetNow();
-		SnapshotHandler.AddCurrentHMDSample(LeapTimeNow);
-
-		HandInterpolationTimeOffset = Options.HandInterpFactor * FrameTimeInMicros;
-		FingerInterpolationTimeOffset = Options.FingerInterpFactor * FrameTimeInMicros;
+		// Map this game frame's time into LeapC time rather than sampling LeapGetNow whenever capture happens to run
+		const int64 LeapTimeNow =
+			GetLeapTimeAtPlatformTime(FramePlatformTime > 0 ? FramePlatformTime : FPlatformTime::Seconds());
 
-		// interpolation not supported in OpenXR
 		if (Options.bUseInterpolation)
 		{
 			// Let's interpolate the frame using leap function
-
-			// Get the future interpolated finger frame
-			Frame = Leap->GetInterpolatedFrameAtTime(LeapTimeNow + FingerInterpolationTimeOffset);
-
-			if (!Frame)
-			{
-				return;
-			}
-			CurrentFrame.SetFromLeapFrame(Frame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
-
-			// Get the future interpolated hand frame, farther than fingers to provide
-			// lower latency
-			Frame = Leap->GetInterpolatedFrameAtTime(LeapTimeNow + HandInterpolationTimeOffset);
-			if (!Frame)
+			// Future interpolated finger frame, and hand frame farther than fingers to provide lower latency
+			LEAP_TRACKING_EVENT* FingerFrame = nullptr;
+			LEAP_TRACKING_EVENT* HandFrame = nullptr;
+			if (!Leap->GetInterpolatedFramesAtTimes(LeapTimeNow + FingerInterpolationTimeOffset,
+					LeapTimeNow + HandInterpolationTimeOffset, FingerFrame, HandFrame))
 			{
 				return;
 			}
-			CurrentFrame.SetInterpolationPartialFromLeapFrame(Frame,Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
+			// scale from Tick, the world scale lookup isn't safe where capture may run
+			CurrentPose.SetFromLeapFrame(
+				FingerFrame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion(), FrameLeapToUEScale);
+			CurrentPose.SetInterpolationPartialFromLeapFrame(
+				HandFrame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion(), FrameLeapToUEScale);
 
 			// Track our extrapolation time in stats
-			Stats.FrameExtrapolationInMS = (CurrentFrame.TimeStamp - TimeWarpTimeStamp) / 1000.f;
+			Stats.FrameExtrapolationInMS = (CurrentPose.TimeStamp - TimeWarpTimeStamp) / 1000.f;
 		}
 		else
 		{
-			CurrentFrame.SetFromLeapFrame(Frame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
+			const FLeapFramePose* IngestedPose = AcquireIngestedPose(Frame);
+			if (IngestedPose)
+			{
+				INC_DWORD_STAT(STAT_LeapIngestedPoses);
+				CurrentPose.CopyFrom(*IngestedPose);
+			}
+			else
+			{
+				CurrentPose.SetFromLeapFrame(
+					Frame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion(), FrameLeapToUEScale);
+			}
 			Stats.FrameExtrapolationInMS = 0;
 		}
 	}
+	else if (Options.bUseInterpolation)
+	{
+		// OpenXR can't interpolate, the wrapper predicts from the hands it has sampled, on its own (world time) clock
+		const int64 SourceTimeNow = Leap->GetNow();
+		LEAP_TRACKING_EVENT* FingerFrame = nullptr;
+		LEAP_TRACKING_EVENT* HandFrame = nullptr;
+		if (!Leap->GetInterpolatedFramesAtTimes(SourceTimeNow + FingerInterpolationTimeOffset,
+				SourceTimeNow + HandInterpolationTimeOffset, FingerFrame, HandFrame))
+		{
+			return;
+		}
+		CurrentPose.SetFromLeapFrame(FingerFrame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
+		CurrentPose.SetInterpolationPartialFromLeapFrame(
+			HandFrame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
+
+		Stats.FrameExtrapolationInMS = (CurrentPose.TimeStamp - Frame->info.timestamp) / 1000.f;
+	}
 	else
 	{
-		CurrentFrame.SetFromLeapFrame(Frame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
+		CurrentPose.SetFromLeapFrame(Frame, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion());
 		Stats.FrameExtrapolationInMS = 0;
 	}
 
-	ParseEvents();
+	bSourceFrameUnchanged = bInterpolationOnly;
+	TransformCurrentPose();
+	bInputEventsPending = true;
+}
+
+bool FUltraleapDevice::SamplePoseAtTime(const int64 TimeStamp, FLeapFramePose& OutPose)
+{
+	const FLeapFrameHistory* History = Leap->GetFrameHistory();
+	if (!History)
+	{
+		return false;
+	}
+	// on the stack, combiners sharing this device sample it concurrently
+	FLeapFrameHistory::FFrame Frame;
+	const LEAP_TRACKING_EVENT* Event = History->Interpolate(TimeStamp, Frame);
+	if (!Event)
+	{
+		return false;
+	}
+	OutPose.SetFromLeapFrame(Event, Options.HMDPositionOffset, Options.HMDRotationOffset.Quaternion(), FrameLeapToUEScale);
+	TransformPose(OutPose);
+	return true;
 }
 
 void FUltraleapDevice::ParseEvents()
+{
+	TransformCurrentPose();
+	EmitEvents();
+}
+
+void FUltraleapDevice::TransformCurrentPose()
+{
+	// CurrentPose was just captured or combined
+	OnCurrentPoseChanged();
+
+	TransformPose(CurrentPose);
+
+	// apply any tracking system specific changes to the hand
+	// e.g. Pinch and Grasp simulation for OpenXR, the only wrapper that implements it
+	if (Leap->GetDeviceType() == IHandTrackingWrapper::DEVICE_TYPE_OPENXR)
+	{
+		FLeapFrameData& Frame = GetMutableCurrentFrameData();
+		Leap->PostLeapHandUpdate(Frame);
+		CurrentPose.SetGestureStrengthsFromFrameData(Frame);
+	}
+}
+
+void FUltraleapDevice::TransformPose(FLeapFramePose& Pose)
 {
 	// Are we in HMD mode? add our HMD snapshot
 	// Note with Open XR, the data is already transformed for the HMD/player camera
 	if (Options.Mode == LEAP_MODE_VR && Options.bTransformOriginToHMD && !Options.bUseOpenXRAsSource)
 	{
 		// Correction for HMD offset and rotation has already been applied in call
-		// to CaptureAndEvaluateInput through CurrentFrame->SetFromLeapFrame()
-
-		BodyStateHMDSnapshot SnapshotNow = SnapshotHandler.LastHMDSample();
+		// to CaptureAndEvaluateInput through CurrentPose.SetFromLeapFrame()
 
-		if (IsInGameThread())
-		{
-			SnapshotNow = BSHMDSnapshotHandler::CurrentHMDSample(Leap->GetNow());
-		}
+		// always the pose sampled in Tick, so the same frame gets the same HMD transform on whichever thread it is captured
+		const BodyStateHMDSnapshot& SnapshotNow = FrameHMDSample;
 
-		FRotator FinalHMDRotation = SnapshotNow.Orientation.Rotator();
+		FQuat FinalHMDRotation = SnapshotNow.Orientation;
 		FVector FinalHMDTranslation = SnapshotNow.Position;
 
 		// Determine time-warp, only relevant for VR
@@ -500,13 +792,13 @@ void FUltraleapDevice::ParseEvents()
 
 			FinalHMDTranslation += WarpTranslation;
 
-			FinalHMDRotation = FLeapUtility::CombineRotators(WarpRotation, FinalHMDRotation);
-			CurrentFrame.FinalRotationAdjustment = FinalHMDRotation;
+			// same as FLeapUtility::CombineRotators(WarpRotation, FinalHMDRotation)
+			FinalHMDRotation = FinalHMDRotation * WarpRotation.Quaternion();
+			Pose.FinalRotationAdjustment = FinalHMDRotation.Rotator();
 		}
 
 		// Rotate our frame by time warp difference
-		CurrentFrame.RotateFrame(FinalHMDRotation);
-		CurrentFrame.TranslateFrame(FinalHMDTranslation);
+		Pose.Transform(FTransform(FinalHMDRotation, FinalHMDTranslation));
 
 		// store device origin for combiner
 		// Ideally this should include the HMD offset
@@ -514,33 +806,54 @@ void FUltraleapDevice::ParseEvents()
 	}
 	else if (Options.Mode == LEAP_MODE_SCREENTOP)
 	{
-		FRotator ScreentopToDesktop(-90, 0, 180);
-		CurrentFrame.RotateFrame(ScreentopToDesktop.GetInverse());
+		static const FQuat DesktopFromScreentop = FRotator(-90, 0, 180).GetInverse().Quaternion();
+		Pose.Rotate(DesktopFromScreentop);
 	}
+}
+
+void FUltraleapDevice::EmitEvents()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MultiLeapEvents);
+
 	if (LastLeapTime == 0)
 		LastLeapTime = Leap->GetNow();
-	
-	// apply any tracking system specific changes to the hand
-	// e.g. Pinch and Grasp simulation for OpenXR
-	Leap->PostLeapHandUpdate(CurrentFrame);
 
-	CheckHandVisibility();
-	CheckGrabGesture();
-	CheckPinchGesture();
+	// The hand set and gesture strengths come from the source frame, only check them when it changed
+	if (!bSourceFrameUnchanged)
+	{
+		CheckHandVisibility();
+		CheckGrabGesture();
+		CheckPinchGesture();
+	}
 
 	// Emit tracking data if it is being captured
-	CallFunctionOnComponents(
-		[this](ULeapComponent* Component)
-		{
-			// Scale input?
-			// FinalFrameData.ScaleByWorldScale(Component->GetWorld()->GetWorldSettings()->WorldToMeters
-			// / 100.f);
-			Component->OnLeapTrackingData.Broadcast(CurrentFrame);
-		});
+	if (EnumHasAnyFlags(SubscribedEvents, ELeapEventSubscription::TrackingData))
+	{
+		// one frame shared by every listener
+		const FLeapFrameSnapshotRef Snapshot = GetCurrentFrameSnapshot();
+		CallFunctionOnComponents(ELeapEventSubscription::TrackingData,
+			[Snapshot](ULeapComponent* Component)
+			{
+				// Scale input?
+				// FinalFrameData.ScaleByWorldScale(Component->GetWorld()->GetWorldSettings()->WorldToMeters
+				// / 100.f);
+				Component->OnLeapFrameSnapshot.Broadcast(Snapshot);
+				// Blueprint listeners get their own copy of the parameters, don't pay for it when there are none
+				if (Component->OnLeapTrackingData.IsBound())
+				{
+					Component->OnLeapTrackingData.Broadcast(*Snapshot);
+				}
+			});
+	}
 
 	// It's now the past data
-	PastFrame = CurrentFrame;
-	LastLeapTime = Leap->GetNow();
+	PastPose = CurrentPose;
+	// the time based checks accumulate from here, ticks that skipped them leave it so the next check gets the whole gap
+	if (!bSourceFrameUnchanged)
+	{
+		LastLeapTime = Leap->GetNow();
+	}
+	bSourceFrameUnchanged = false;
 }
 
 void FUltraleapDevice::CheckHandVisibility()
@@ -556,11 +869,12 @@ void FUltraleapDevice::CheckHandVisibility()
 		{
 			TimeSinceLastRightVisible = TimeSinceLastRightVisible + (Leap->GetNow() - LastLeapTime);
 		}
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
+			const FLeapHandPose& Hand = CurrentPose.Hands[HandIndex];
 			if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 			{
-				if (CurrentFrame.LeftHandVisible)
+				if (CurrentPose.LeftHandVisible)
 				{
 					TimeSinceLastLeftVisible = 0;
 					LastLeftHand = Hand;
@@ -568,16 +882,18 @@ void FUltraleapDevice::CheckHandVisibility()
 					{
 						IsLeftVisible = true;
 						const bool LeftVisible = true;
-						CallFunctionOnComponents([this, LeftVisible](ULeapComponent* Component)
+						CallFunctionOnComponents(ELeapEventSubscription::HandVisibility,
+							[this, LeftVisible](ULeapComponent* Component)
 							{ Component->OnLeftHandVisibilityChanged.Broadcast(LeftVisible); });
-						CallFunctionOnComponents(
-							[Hand](ULeapComponent* Component) { Component->OnHandBeginTracking.Broadcast(Hand); });
+						CallHandFunctionOnComponents(ELeapEventSubscription::HandTracking, Hand,
+							[](ULeapComponent* Component, const FLeapHandData& HandData)
+							{ Component->OnHandBeginTracking.Broadcast(HandData); });
 					}
 				}
 			}
 			else if (Hand.HandType == EHandType::LEAP_HAND_RIGHT)
 			{
-				if (CurrentFrame.RightHandVisible)
+				if (CurrentPose.RightHandVisible)
 				{
 					TimeSinceLastRightVisible = 0;
 					LastRightHand = Hand;
@@ -585,10 +901,12 @@ void FUltraleapDevice::CheckHandVisibility()
 					{
 						IsRightVisible = true;
 						const bool RightVisible = true;
-						CallFunctionOnComponents([this, RightVisible](ULeapComponent* Component)
+						CallFunctionOnComponents(ELeapEventSubscription::HandVisibility,
+							[this, RightVisible](ULeapComponent* Component)
 							{ Component->OnRightHandVisibilityChanged.Broadcast(RightVisible); });
-						CallFunctionOnComponents(
-							[Hand](ULeapComponent* Component) { Component->OnHandBeginTracking.Broadcast(Hand); });
+						CallHandFunctionOnComponents(ELeapEventSubscription::HandTracking, Hand,
+							[](ULeapComponent* Component, const FLeapHandData& HandData)
+							{ Component->OnHandBeginTracking.Broadcast(HandData); });
 					}
 				}
 			}
@@ -598,19 +916,23 @@ void FUltraleapDevice::CheckHandVisibility()
 		if (IsLeftVisible && TimeSinceLastLeftVisible > VisibilityTimeout)
 		{
 			IsLeftVisible = false;
-			const FLeapHandData EndHand = LastLeftHand;
-			CallFunctionOnComponents([EndHand](ULeapComponent* Component) { Component->OnHandEndTracking.Broadcast(EndHand); });
+			CallHandFunctionOnComponents(ELeapEventSubscription::HandTracking, LastLeftHand,
+				[](ULeapComponent* Component, const FLeapHandData& HandData)
+				{ Component->OnHandEndTracking.Broadcast(HandData); });
 			const bool LeftVisible = false;
-			CallFunctionOnComponents(
-				[this, LeftVisible](ULeapComponent* Component) { Component->OnLeftHandVisibilityChanged.Broadcast(LeftVisible); });
+			CallFunctionOnComponents(ELeapEventSubscription::HandVisibility,
+				[this, LeftVisible](ULeapComponent* Component)
+				{ Component->OnLeftHandVisibilityChanged.Broadcast(LeftVisible); });
 		}
 		if (IsRightVisible && TimeSinceLastRightVisible > VisibilityTimeout)
 		{
 			IsRightVisible = false;
-			const FLeapHandData EndHand = LastRightHand;
-			CallFunctionOnComponents([EndHand](ULeapComponent* Component) { Component->OnHandEndTracking.Broadcast(EndHand); });
+			CallHandFunctionOnComponents(ELeapEventSubscription::HandTracking, LastRightHand,
+				[](ULeapComponent* Component, const FLeapHandData& HandData)
+				{ Component->OnHandEndTracking.Broadcast(HandData); });
 			const bool RightVisible = false;
-			CallFunctionOnComponents([this, RightVisible](ULeapComponent* Component)
+			CallFunctionOnComponents(ELeapEventSubscription::HandVisibility,
+				[this, RightVisible](ULeapComponent* Component)
 				{ Component->OnRightHandVisibilityChanged.Broadcast(RightVisible); });
 		}
 	}
@@ -621,58 +943,51 @@ void FUltraleapDevice::CheckHandVisibility()
 		//== change can happen when chirality is incorrect and changes
 		// Hand end tracking must be called first before we call begin tracking
 		// Add each hand to visible hands
-		// CurrentFrame.Hands;
 		TArray<int32> VisibleHands;
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
-			VisibleHands.Add(Hand.Id);
+			VisibleHands.Add(CurrentPose.Hands[HandIndex].Id);
 		}
 		if (VisibleHands.Num() <= PastVisibleHands.Num())
 		{
 			for (auto HandId : PastVisibleHands)
 			{
 				// Not visible anymore? lost hand
-				if (!VisibleHands.Contains(HandId))
+				const FLeapHandPose* Hand = PastPose.HandForId(HandId);
+				if (!VisibleHands.Contains(HandId) && Hand)
 				{
-					const FLeapHandData Hand = PastFrame.HandForId(HandId);
-					CallFunctionOnComponents([Hand](ULeapComponent* Component) { Component->OnHandEndTracking.Broadcast(Hand); });
+					CallHandFunctionOnComponents(ELeapEventSubscription::HandTracking, *Hand,
+						[](ULeapComponent* Component, const FLeapHandData& HandData)
+						{ Component->OnHandEndTracking.Broadcast(HandData); });
 				}
 			}
 		}
 
 		// Check for hand visibility changes
-		if (PastFrame.LeftHandVisible != CurrentFrame.LeftHandVisible)
+		if (PastPose.LeftHandVisible != CurrentPose.LeftHandVisible)
 		{
-			const bool LeftVisible = CurrentFrame.LeftHandVisible;
-			CallFunctionOnComponents(
-				[this, LeftVisible](ULeapComponent* Component) { Component->OnLeftHandVisibilityChanged.Broadcast(LeftVisible); });
+			const bool LeftVisible = CurrentPose.LeftHandVisible;
+			CallFunctionOnComponents(ELeapEventSubscription::HandVisibility,
+				[this, LeftVisible](ULeapComponent* Component)
+				{ Component->OnLeftHandVisibilityChanged.Broadcast(LeftVisible); });
 		}
-		if (PastFrame.RightHandVisible != CurrentFrame.RightHandVisible)
+		if (PastPose.RightHandVisible != CurrentPose.RightHandVisible)
 		{
-			const bool RightVisible = CurrentFrame.RightHandVisible;
-			CallFunctionOnComponents([this, RightVisible](ULeapComponent* Component)
+			const bool RightVisible = CurrentPose.RightHandVisible;
+			CallFunctionOnComponents(ELeapEventSubscription::HandVisibility,
+				[this, RightVisible](ULeapComponent* Component)
 				{ Component->OnRightHandVisibilityChanged.Broadcast(RightVisible); });
 		}
 
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
-			FLeapHandData PastHand;
-
-			// Hand list is tiny, typically 1-3, just enum until you find the matching
-			// one
-			for (auto& EnumPastHand : PastFrame.Hands)
-			{
-				if (Hand.Id == EnumPastHand.Id)
-				{
-					// Same id? same hand
-					PastHand = EnumPastHand;
-				}
-			}
-
+			const FLeapHandPose& Hand = CurrentPose.Hands[HandIndex];
 			if (!PastVisibleHands.Contains(Hand.Id))	// or if the hand changed type?
 			{
 				// New hand
-				CallFunctionOnComponents([Hand](ULeapComponent* Component) { Component->OnHandBeginTracking.Broadcast(Hand); });
+				CallHandFunctionOnComponents(ELeapEventSubscription::HandTracking, Hand,
+					[](ULeapComponent* Component, const FLeapHandData& HandData)
+					{ Component->OnHandBeginTracking.Broadcast(HandData); });
 			}
 		}
 		PastVisibleHands = VisibleHands;
@@ -691,9 +1006,9 @@ void FUltraleapDevice::CheckPinchGesture()
 		{
 			TimeSinceLastRightPinch = TimeSinceLastRightPinch + (Leap->GetNow() - LastLeapTime);
 		}
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
-			const FLeapHandData& FinalHandData = Hand;
+			const FLeapHandPose& Hand = CurrentPose.Hands[HandIndex];
 			if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 			{
 				if ((!IsLeftGrabbing && (!IsLeftPinching && (Hand.PinchStrength > StartPinchThreshold))) ||
@@ -704,16 +1019,18 @@ void FUltraleapDevice::CheckPinchGesture()
 					{
 						IsLeftPinching = true;
 						EmitKeyDownEventForKey(EKeysLeap::LeapPinchL);
-						CallFunctionOnComponents(
-							[FinalHandData](ULeapComponent* Component) { Component->OnHandPinched.Broadcast(FinalHandData); });
+						CallHandFunctionOnComponents(ELeapEventSubscription::HandPinch, Hand,
+							[](ULeapComponent* Component, const FLeapHandData& HandData)
+							{ Component->OnHandPinched.Broadcast(HandData); });
 					}
 				}
 				else if (IsLeftPinching && (TimeSinceLastLeftPinch > PinchTimeout))
 				{
 					IsLeftPinching = false;
 					EmitKeyUpEventForKey(EKeysLeap::LeapPinchL);
-					CallFunctionOnComponents(
-						[FinalHandData](ULeapComponent* Component) { Component->OnHandUnpinched.Broadcast(FinalHandData); });
+					CallHandFunctionOnComponents(ELeapEventSubscription::HandPinch, Hand,
+						[](ULeapComponent* Component, const FLeapHandData& HandData)
+						{ Component->OnHandUnpinched.Broadcast(HandData); });
 				}
 			}
 			else if (Hand.HandType == EHandType::LEAP_HAND_RIGHT)
@@ -726,40 +1043,34 @@ void FUltraleapDevice::CheckPinchGesture()
 					{
 						IsRightPinching = true;
 						EmitKeyDownEventForKey(EKeysLeap::LeapPinchR);
-						CallFunctionOnComponents(
-							[FinalHandData](ULeapComponent* Component) { Component->OnHandPinched.Broadcast(FinalHandData); });
+						CallHandFunctionOnComponents(ELeapEventSubscription::HandPinch, Hand,
+							[](ULeapComponent* Component, const FLeapHandData& HandData)
+							{ Component->OnHandPinched.Broadcast(HandData); });
 					}
 				}
 				else if (IsRightPinching && (TimeSinceLastRightPinch > PinchTimeout))
 				{
 					IsRightPinching = false;
 					EmitKeyUpEventForKey(EKeysLeap::LeapPinchR);
-					CallFunctionOnComponents(
-						[FinalHandData](ULeapComponent* Component) { Component->OnHandUnpinched.Broadcast(FinalHandData); });
+					CallHandFunctionOnComponents(ELeapEventSubscription::HandPinch, Hand,
+						[](ULeapComponent* Component, const FLeapHandData& HandData)
+						{ Component->OnHandUnpinched.Broadcast(HandData); });
 				}
 			}
 		}
 	}
 	else
 	{
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
-			FLeapHandData PastHand;
+			const FLeapHandPose& Hand = CurrentPose.Hands[HandIndex];
 
-			// Hand list is tiny, typically 1-3, just enum until you find the matching
-			// one
-			for (auto& EnumPastHand : PastFrame.Hands)
-			{
-				if (Hand.Id == EnumPastHand.Id)
-				{
-					// Same id? same hand
-					PastHand = EnumPastHand;
-				}
-			}
+			// Same id? same hand
+			const FLeapHandPose* PastHand = PastPose.HandForId(Hand.Id);
+			const float PastPinchStrength = PastHand ? PastHand->PinchStrength : 0.f;
 
-			const FLeapHandData& FinalHandData = Hand;
 			// Pinch
-			if (Hand.PinchStrength > StartPinchThreshold && PastHand.PinchStrength <= StartPinchThreshold)
+			if (Hand.PinchStrength > StartPinchThreshold && PastPinchStrength <= StartPinchThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -769,11 +1080,12 @@ void FUltraleapDevice::CheckPinchGesture()
 				{
 					EmitKeyDownEventForKey(EKeysLeap::LeapPinchR);
 				}
-				CallFunctionOnComponents(
-					[FinalHandData](ULeapComponent* Component) { Component->OnHandPinched.Broadcast(FinalHandData); });
+				CallHandFunctionOnComponents(ELeapEventSubscription::HandPinch, Hand,
+					[](ULeapComponent* Component, const FLeapHandData& HandData)
+					{ Component->OnHandPinched.Broadcast(HandData); });
 			}
 			// Unpinch (TODO: Adjust values)
-			else if (Hand.PinchStrength <= EndPinchThreshold && PastHand.PinchStrength > EndPinchThreshold)
+			else if (Hand.PinchStrength <= EndPinchThreshold && PastPinchStrength > EndPinchThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -783,8 +1095,9 @@ void FUltraleapDevice::CheckPinchGesture()
 				{
 					EmitKeyUpEventForKey(EKeysLeap::LeapPinchR);
 				}
-				CallFunctionOnComponents(
-					[FinalHandData](ULeapComponent* Component) { Component->OnHandUnpinched.Broadcast(FinalHandData); });
+				CallHandFunctionOnComponents(ELeapEventSubscription::HandPinch, Hand,
+					[](ULeapComponent* Component, const FLeapHandData& HandData)
+					{ Component->OnHandUnpinched.Broadcast(HandData); });
 			}
 		}
 	}
@@ -802,9 +1115,9 @@ void FUltraleapDevice::CheckGrabGesture()
 		{
 			TimeSinceLastRightGrab = TimeSinceLastRightGrab + (Leap->GetNow() - LastLeapTime);
 		}
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
-			const FLeapHandData& FinalHandData = Hand;
+			const FLeapHandPose& Hand = CurrentPose.Hands[HandIndex];
 			if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 			{
 				if ((!IsLeftGrabbing && (Hand.GrabStrength > StartGrabThreshold)) ||
@@ -815,16 +1128,18 @@ void FUltraleapDevice::CheckGrabGesture()
 					{
 						IsLeftGrabbing = true;
 						EmitKeyDownEventForKey(EKeysLeap::LeapGrabL);
-						CallFunctionOnComponents(
-							[FinalHandData](ULeapComponent* Component) { Component->OnHandGrabbed.Broadcast(FinalHandData); });
+						CallHandFunctionOnComponents(ELeapEventSubscription::HandGrab, Hand,
+							[](ULeapComponent* Component, const FLeapHandData& HandData)
+							{ Component->OnHandGrabbed.Broadcast(HandData); });
 					}
 				}
 				else if (IsLeftGrabbing && (TimeSinceLastLeftGrab > GrabTimeout))
 				{
 					IsLeftGrabbing = false;
 					EmitKeyUpEventForKey(EKeysLeap::LeapGrabL);
-					CallFunctionOnComponents(
-						[FinalHandData](ULeapComponent* Component) { Component->OnHandReleased.Broadcast(FinalHandData); });
+					CallHandFunctionOnComponents(ELeapEventSubscription::HandGrab, Hand,
+						[](ULeapComponent* Component, const FLeapHandData& HandData)
+						{ Component->OnHandReleased.Broadcast(HandData); });
 				}
 			}
 			else if (Hand.HandType == EHandType::LEAP_HAND_RIGHT)
@@ -837,40 +1152,33 @@ void FUltraleapDevice::CheckGrabGesture()
 					{
 						IsRightGrabbing = true;
 						EmitKeyDownEventForKey(EKeysLeap::LeapGrabR);
-						CallFunctionOnComponents(
-							[FinalHandData](ULeapComponent* Component) { Component->OnHandGrabbed.Broadcast(FinalHandData); });
+						CallHandFunctionOnComponents(ELeapEventSubscription::HandGrab, Hand,
+							[](ULeapComponent* Component, const FLeapHandData& HandData)
+							{ Component->OnHandGrabbed.Broadcast(HandData); });
 					}
 				}
 				else if (IsRightGrabbing && (TimeSinceLastRightGrab > GrabTimeout))
 				{
 					IsRightGrabbing = false;
 					EmitKeyUpEventForKey(EKeysLeap::LeapGrabR);
-					CallFunctionOnComponents(
-						[FinalHandData](ULeapComponent* Component) { Component->OnHandReleased.Broadcast(FinalHandData); });
+					CallHandFunctionOnComponents(ELeapEventSubscription::HandGrab, Hand,
+						[](ULeapComponent* Component, const FLeapHandData& HandData)
+						{ Component->OnHandReleased.Broadcast(HandData); });
 				}
 			}
 		}
 	}
 	else
 	{
-		for (auto& Hand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
-			FLeapHandData PastHand;
+			const FLeapHandPose& Hand = CurrentPose.Hands[HandIndex];
 
-			// Hand list is tiny, typically 1-3, just enum until you find the matching
-			// one
-			for (auto& EnumPastHand : PastFrame.Hands)
-			{
-				if (Hand.Id == EnumPastHand.Id)
-				{
-					// Same id? same hand
-					PastHand = EnumPastHand;
-				}
-			}
-
-			const FLeapHandData& FinalHandData = Hand;
+			// Same id? same hand
+			const FLeapHandPose* PastHand = PastPose.HandForId(Hand.Id);
+			const float PastGrabStrength = PastHand ? PastHand->GrabStrength : 0.f;
 
-			if (Hand.GrabStrength > StartGrabThreshold && PastHand.GrabStrength <= StartGrabThreshold)
+			if (Hand.GrabStrength > StartGrabThreshold && PastGrabStrength <= StartGrabThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -880,11 +1188,12 @@ void FUltraleapDevice::CheckGrabGesture()
 				{
 					EmitKeyDownEventForKey(EKeysLeap::LeapGrabR);
 				}
-				CallFunctionOnComponents(
-					[FinalHandData](ULeapComponent* Component) { Component->OnHandGrabbed.Broadcast(FinalHandData); });
+				CallHandFunctionOnComponents(ELeapEventSubscription::HandGrab, Hand,
+					[](ULeapComponent* Component, const FLeapHandData& HandData)
+					{ Component->OnHandGrabbed.Broadcast(HandData); });
 			}
 			// Release
-			else if (Hand.GrabStrength <= EndGrabThreshold && PastHand.GrabStrength > EndGrabThreshold)
+			else if (Hand.GrabStrength <= EndGrabThreshold && PastGrabStrength > EndGrabThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -894,8 +1203,9 @@ void FUltraleapDevice::CheckGrabGesture()
 				{
 					EmitKeyUpEventForKey(EKeysLeap::LeapGrabR);
 				}
-				CallFunctionOnComponents(
-					[FinalHandData](ULeapComponent* Component) { Component->OnHandReleased.Broadcast(FinalHandData); });
+				CallHandFunctionOnComponents(ELeapEventSubscription::HandGrab, Hand,
+					[](ULeapComponent* Component, const FLeapHandData& HandData)
+					{ Component->OnHandReleased.Broadcast(HandData); });
 			}
 		}
 	}
@@ -928,6 +1238,7 @@ void FUltraleapDevice::AddEventDelegate(const ULeapComponent* EventDelegate)
 		{
 			EventDelegates.Add((ULeapComponent*) EventDelegate);
 		}
+		RefreshSubscribedEvents();
 
 		UE_LOG(UltraleapTrackingLog, Log, TEXT("AddEventDelegate (%d)."), EventDelegates.Num());
 	}
@@ -936,6 +1247,7 @@ void FUltraleapDevice::AddEventDelegate(const ULeapComponent* EventDelegate)
 void FUltraleapDevice::RemoveEventDelegate(const ULeapComponent* EventDelegate)
 {
 	EventDelegates.Remove((ULeapComponent*) EventDelegate);
+	RefreshSubscribedEvents();
 	// UE_LOG(UltraleapTrackingLog, Log, TEXT("RemoveEventDelegate (%d)."),
 	// EventDelegates.Num());
 }
@@ -958,8 +1270,8 @@ void FUltraleapDevice::ShutdownLeap()
 
 void FUltraleapDevice::AreHandsVisible(bool& LeftHandIsVisible, bool& RightHandIsVisible)
 {
-	LeftHandIsVisible = CurrentFrame.LeftHandVisible;
-	RightHandIsVisible = CurrentFrame.RightHandVisible;
+	LeftHandIsVisible = CurrentPose.LeftHandVisible;
+	RightHandIsVisible = CurrentPose.RightHandVisible;
 }
 
 void FUltraleapDevice::SetSwizzles(
@@ -1016,6 +1328,14 @@ void FUltraleapDevice::UpdateInput(int32 DeviceID, class UBodyStateSkeleton* Ske
 	SCOPE_CYCLE_COUNTER(STAT_MultiLeapBodyStateTick);
 	// UE_LOG(UltraleapTrackingLog, Log, TEXT("Update requested for %d"),
 	// DeviceID);
+	if (Skeleton == LastUpdatedSkeleton && PoseGeneration == SkeletonPoseGeneration)
+	{
+		INC_DWORD_STAT(STAT_LeapSkippedBodyStateUpdates);
+		return;
+	}
+	LastUpdatedSkeleton = Skeleton;
+	SkeletonPoseGeneration = PoseGeneration;
+
 	bool bLeftIsTracking = false;
 	bool bRightIsTracking = false;
 
@@ -1023,14 +1343,15 @@ void FUltraleapDevice::UpdateInput(int32 DeviceID, class UBodyStateSkeleton* Ske
 		FScopeLock ScopeLock(&Skeleton->BoneDataLock);
 
 		// Update our skeleton with new data
-		for (auto LeapHand : CurrentFrame.Hands)
+		for (int32 HandIndex = 0; HandIndex < CurrentPose.NumHands; ++HandIndex)
 		{
+			const FLeapHandPose& LeapHand = CurrentPose.Hands[HandIndex];
 			if (LeapHand.HandType == EHandType::LEAP_HAND_LEFT)
 			{
 				UBodyStateArm* LeftArm = Skeleton->LeftArm();
 
-				LeftArm->LowerArm->SetPosition(LeapHand.Arm.PrevJoint);
-				LeftArm->LowerArm->SetOrientation(LeapHand.Arm.Rotation);
+				LeftArm->LowerArm->SetPosition(LeapHand.PrevJoints[FLeapHandPose::ArmIndex]);
+				LeftArm->LowerArm->SetOrientation(LeapHand.Rotations[FLeapHandPose::ArmIndex].Rotator());
 
 				// Set hand data
 				SetBSHandFromLeapHand(LeftArm->Hand, LeapHand);
@@ -1043,8 +1364,8 @@ void FUltraleapDevice::UpdateInput(int32 DeviceID, class UBodyStateSkeleton* Ske
 			{
 				UBodyStateArm* RightArm = Skeleton->RightArm();
 
-				RightArm->LowerArm->SetPosition(LeapHand.Arm.PrevJoint);
-				RightArm->LowerArm->SetOrientation(LeapHand.Arm.Rotation);
+				RightArm->LowerArm->SetPosition(LeapHand.PrevJoints[FLeapHandPose::ArmIndex]);
+				RightArm->LowerArm->SetOrientation(LeapHand.Rotations[FLeapHandPose::ArmIndex].Rotator());
 
 				// Set hand data
 				SetBSHandFromLeapHand(RightArm->Hand, LeapHand);
@@ -1116,47 +1437,50 @@ void FUltraleapDevice::UpdateInput(int32 DeviceID, class UBodyStateSkeleton* Ske
 	}
 #endif
 }
-void FUltraleapDevice::SetBSFingerFromLeapDigit(UBodyStateFinger* Finger, const FLeapDigitData& LeapDigit)
+void FUltraleapDevice::SetBSFingerFromLeapDigit(UBodyStateFinger* Finger, const FLeapHandPose& LeapHand, const int32 Digit)
 {
-	Finger->Metacarpal->SetPosition(LeapDigit.Metacarpal.PrevJoint);
-	Finger->Metacarpal->SetOrientation(LeapDigit.Metacarpal.Rotation);
+	const int32 Metacarpal = FLeapHandPose::BoneIndex(Digit, 0);
+
+	Finger->Metacarpal->SetPosition(LeapHand.PrevJoints[Metacarpal]);
+	Finger->Metacarpal->SetOrientation(LeapHand.Rotations[Metacarpal].Rotator());
 
-	Finger->Proximal->SetPosition(LeapDigit.Proximal.PrevJoint);
-	Finger->Proximal->SetOrientation(LeapDigit.Proximal.Rotation);
+	Finger->Proximal->SetPosition(LeapHand.PrevJoints[Metacarpal + 1]);
+	Finger->Proximal->SetOrientation(LeapHand.Rotations[Metacarpal + 1].Rotator());
 
-	Finger->Intermediate->SetPosition(LeapDigit.Intermediate.PrevJoint);
-	Finger->Intermediate->SetOrientation(LeapDigit.Intermediate.Rotation);
+	Finger->Intermediate->SetPosition(LeapHand.PrevJoints[Metacarpal + 2]);
+	Finger->Intermediate->SetOrientation(LeapHand.Rotations[Metacarpal + 2].Rotator());
 
-	Finger->Distal->SetPosition(LeapDigit.Distal.PrevJoint);
-	Finger->Distal->SetOrientation(LeapDigit.Distal.Rotation);
+	Finger->Distal->SetPosition(LeapHand.PrevJoints[Metacarpal + 3]);
+	Finger->Distal->SetOrientation(LeapHand.Rotations[Metacarpal + 3].Rotator());
 
-	Finger->bIsExtended = LeapDigit.IsExtended;
+	Finger->bIsExtended = LeapHand.IsExtended[Digit];
 }
 
-void FUltraleapDevice::SetBSThumbFromLeapThumb(UBodyStateFinger* Finger, const FLeapDigitData& LeapDigit)
+void FUltraleapDevice::SetBSThumbFromLeapThumb(UBodyStateFinger* Finger, const FLeapHandPose& LeapHand)
 {
-	Finger->Metacarpal->SetPosition(LeapDigit.Proximal.PrevJoint);
-	Finger->Metacarpal->SetOrientation(LeapDigit.Proximal.Rotation);
+	// the leap thumb metacarpal has zero length, BodyState's thumb starts at the proximal
+	Finger->Metacarpal->SetPosition(LeapHand.PrevJoints[1]);
+	Finger->Metacarpal->SetOrientation(LeapHand.Rotations[1].Rotator());
 
-	Finger->Proximal->SetPosition(LeapDigit.Intermediate.PrevJoint);
-	Finger->Proximal->SetOrientation(LeapDigit.Intermediate.Rotation);
+	Finger->Proximal->SetPosition(LeapHand.PrevJoints[2]);
+	Finger->Proximal->SetOrientation(LeapHand.Rotations[2].Rotator());
 
-	Finger->Distal->SetPosition(LeapDigit.Distal.PrevJoint);
-	Finger->Distal->SetOrientation(LeapDigit.Distal.Rotation);
+	Finger->Distal->SetPosition(LeapHand.PrevJoints[3]);
+	Finger->Distal->SetOrientation(LeapHand.Rotations[3].Rotator());
 
-	Finger->bIsExtended = LeapDigit.IsExtended;
+	Finger->bIsExtended = LeapHand.IsExtended[0];
 }
 
-void FUltraleapDevice::SetBSHandFromLeapHand(UBodyStateHand* Hand, const FLeapHandData& LeapHand)
+void FUltraleapDevice::SetBSHandFromLeapHand(UBodyStateHand* Hand, const FLeapHandPose& LeapHand)
 {
-	SetBSThumbFromLeapThumb(Hand->ThumbFinger(), LeapHand.Thumb);
-	SetBSFingerFromLeapDigit(Hand->IndexFinger(), LeapHand.Index);
-	SetBSFingerFromLeapDigit(Hand->MiddleFinger(), LeapHand.Middle);
-	SetBSFingerFromLeapDigit(Hand->RingFinger(), LeapHand.Ring);
-	SetBSFingerFromLeapDigit(Hand->PinkyFinger(), LeapHand.Pinky);
-
-	Hand->Wrist->SetPosition(LeapHand.Arm.NextJoint);
-	Hand->Wrist->SetOrientation(LeapHand.Palm.Orientation);
+	SetBSThumbFromLeapThumb(Hand->ThumbFinger(), LeapHand);
+	SetBSFingerFromLeapDigit(Hand->IndexFinger(), LeapHand, 1);
+	SetBSFingerFromLeapDigit(Hand->MiddleFinger(), LeapHand, 2);
+	SetBSFingerFromLeapDigit(Hand->RingFinger(), LeapHand, 3);
+	SetBSFingerFromLeapDigit(Hand->PinkyFinger(), LeapHand, 4);
+
+	Hand->Wrist->SetPosition(LeapHand.NextJoints[FLeapHandPose::ArmIndex]);
+	Hand->Wrist->SetOrientation(LeapHand.PalmOrientation.Rotator());
 }
 
 #pragma endregion BodyState
@@ -14,7 +14,11 @@
 #include "IInputDevice.h"
 #include "IXRTrackingSystem.h"
 #include "LeapC.h"
+#include "LeapClockRebaser.h"
 #include "LeapComponent.h"
+#include "LeapFramePacing.h"
+#include "LeapFrameTripleBuffer.h"
+#include "LeapHandPose.h"
 #include "LeapImage.h"
 #include "LeapLiveLink.h"
 #include "LeapUtility.h"
@@ -36,7 +40,14 @@ public:
 
 	/** Main input capture and event parsing 'tick' */
 	void CaptureAndEvaluateInput();
+	/** TransformCurrentPose then EmitEvents, for a CurrentPose set from outside the capture */
 	void ParseEvents();
+	/** HMD and mode transforms of CurrentPose, safe off the game thread */
+	void TransformCurrentPose();
+	/** The HMD and mode part of TransformCurrentPose, for poses other than CurrentPose */
+	void TransformPose(FLeapFramePose& Pose);
+	/** Gesture and visibility checks, key events and component broadcasts. Game thread only */
+	void EmitEvents();
 
 	// IHandTrackingDevice implementation
 	virtual void AddEventDelegate(const ULeapComponent* EventDelegate) override;
@@ -45,7 +56,16 @@ public:
 	virtual void Tick(float DeltaTime) override;
 	/** Poll for controller state and send events if needed */
 	virtual void SendControllerEvents() override;
+	virtual bool CanCaptureOffGameThread() override;
+	virtual void CaptureInput() override;
+	virtual void EmitInputEvents() override;
 	virtual void GetLatestFrameData(FLeapFrameData& OutData,const bool ApplyDeviceOrigin = false) override;
+	virtual FLeapFrameSnapshotPtr GetLatestFrameSnapshot() override;
+	virtual int64 GetCapturedTimeStamp() override
+	{
+		return CurrentPose.TimeStamp;
+	}
+	virtual bool SamplePoseAtTime(const int64 TimeStamp, FLeapFramePose& OutPose) override;
 	FLeapOptions GetOptions() override;
 	FLeapStats GetStats() override;
 	virtual ELeapDeviceType GetDeviceType()
@@ -92,11 +112,36 @@ public:
 	FCriticalSection LeapSection;
 
 	static FTransform ConvertUEDeviceOriginToBSTransform(const FTransform& TransformUE, const bool Direction);
+
+	// drives individual pipeline stages
+	friend class FLeapPipelineBenchmark;
 	
 protected:
-	FLeapFrameData CurrentFrame;
+	// Internal working frame, everything up to the Blueprint boundary runs on this
+	FLeapFramePose CurrentPose;
+	// Blueprint facing copy of CurrentPose, only built when read (see GetCurrentFrameSnapshot). Handed out as an
+	// immutable snapshot, so it is rebuilt in place only while nobody else holds a reference
+	TSharedPtr<FLeapFrameData, ESPMode::ThreadSafe> CurrentFrame;
+	bool bCurrentFrameStale = true;
+	// CaptureInput produced a pose that EmitInputEvents hasn't processed yet
+	bool bInputEventsPending = false;
 	float DeltaTimeFromTick;
 
+	FLeapFrameSnapshotRef GetCurrentFrameSnapshot();
+	const FLeapFrameData& GetCurrentFrameData()
+	{
+		return *GetCurrentFrameSnapshot();
+	}
+	/** Detaches from any outstanding snapshot before returning the frame for modification */
+	FLeapFrameData& GetMutableCurrentFrameData();
+	void OnCurrentPoseChanged()
+	{
+		bCurrentFrameStale = true;
+		++PoseGeneration;
+	}
+	// Bumped whenever CurrentPose changes, UpdateInput skips rewriting a skeleton that already holds this generation
+	uint32 PoseGeneration = 0;
+
 private:
 	bool UseTimeBasedVisibilityCheck = false;
 	bool UseTimeBasedGestureCheck = false;
@@ -123,16 +168,31 @@ private:
 	int64_t TimeSinceLastRightVisible = 10000;
 	int64_t VisibilityTimeout = 1000000;	// 1 Second
 	int64_t LastLeapTime = 0;
-	FLeapHandData LastLeftHand;
-	FLeapHandData LastRightHand;
+	// Source frame change detection, see CaptureAndEvaluateInput
+	int64_t LastSourceFrameId = -1;
+	int64_t LastSourceTimeStamp = 0;
+	bool bLastSourceFrameEmpty = false;
+	// Set for ticks that only re-interpolate the previous source frame, EmitEvents skips the gesture checks
+	bool bSourceFrameUnchanged = false;
+	uint32 SkeletonPoseGeneration = 0;
+	class UBodyStateSkeleton* LastUpdatedSkeleton = nullptr;
+	FLeapHandPose LastLeftHand;
+	FLeapHandPose LastRightHand;
 	FTransform DeviceOrigin;
 
 	// Private UProperties
 	
 	TArray<ULeapComponent*> EventDelegates;	   // delegate storage
+	// Union of the components' subscription masks, refreshed each tick on the game thread
+	ELeapEventSubscription SubscribedEvents = ELeapEventSubscription::None;
+	void RefreshSubscribedEvents();
 
 	// Private utility methods
-	void CallFunctionOnComponents(TFunction<void(ULeapComponent*)> InFunction);	   // lambda multi-cast convenience wrapper
+	// lambda multi-cast convenience wrapper, only components subscribed to any of Events are called. None calls every component
+	void CallFunctionOnComponents(const ELeapEventSubscription Events, TFunction<void(ULeapComponent*)> InFunction);
+	void DispatchToComponents(const ELeapEventSubscription Events, const TFunction<void(ULeapComponent*)>& InFunction);
+	void CallHandFunctionOnComponents(const ELeapEventSubscription Events, const FLeapHandPose& Hand,
+		TFunction<void(ULeapComponent*, const FLeapHandData&)> InFunction);
 	bool EmitKeyUpEventForKey(FKey Key, int32 User, bool Repeat);
 	bool EmitKeyDownEventForKey(FKey Key, int32 User, bool Repeat);
 	bool EmitAnalogInputEventForKey(FKey Key, float Value, int32 User, bool Repeat);
@@ -143,6 +203,8 @@ private:
 	void CheckGrabGesture();
 
 	int64 GetInterpolatedNow();
+	/** Drift compensated mapping through ClockRebaser, falls back to LeapGetNow based offsets until it has a sample */
+	int64 GetLeapTimeAtPlatformTime(const double PlatformSeconds);
 
 	// Internal states
 	FLeapOptions Options;
@@ -164,15 +226,45 @@ private:
 	LeapUtilityTimer FrameTimer;
 	double GameTimeInSec;
 	int64 FrameTimeInMicros;
+	// FPlatformTime::Seconds at the start of this game frame (Tick), interpolation targets are relative to it
+	double FramePlatformTime = 0;
+	FLeapClockRebaser ClockRebaser;
+
+	// Service frame delivery, recorded on the LeapC thread and folded into Stats once a second
+	FLeapFramePacing FramePacing;
+	double LastFramePacingSampleTime = 0;
+	void SampleFramePacing();
+
+	// Ingest thread conversion (leap.IngestThreadConversion). Frames that are used as they arrive (no interpolation)
+	// are converted to poses on the LeapC thread in OnFrame, the capture then only copies the newest one
+	struct FIngestSettings
+	{
+		bool bEnabled = false;
+		FVector MountTranslationOffset = FVector::ZeroVector;
+		FQuat MountRotationOffset = FQuat::Identity;
+		float Scale = 1.f;
+	};
+	// written in Tick and read by the capture that follows it
+	FIngestSettings IngestSettings;
+	// the same settings handed to the LeapC thread, which reads them for every frame without taking a lock
+	TLeapTripleBuffer<FIngestSettings> PublishedIngestSettings;
+	TLeapTripleBuffer<FLeapFramePose> IngestedPoses;
+	// LeapC to UE scale including world scale, looked up in Tick for captures off the game thread. mm to cm until then
+	float FrameLeapToUEScale = 0.1f;
+	void UpdateIngestSettings();
+	/** Converted pose of Frame if the LeapC thread already made it, nullptr otherwise */
+	const FLeapFramePose* AcquireIngestedPose(const LEAP_TRACKING_EVENT* Frame);
 
 	// Game thread Data
 	
-	FLeapFrameData PastFrame;
+	FLeapFramePose PastPose;
 
 	TArray<int32> PastVisibleHands;
 
 	// Time warp support
 	BSHMDSnapshotHandler SnapshotHandler;
+	// HMD pose read on the game thread in Tick before capture is dispatched, every TransformPose of the tick uses it
+	BodyStateHMDSnapshot FrameHMDSample;
 
 	// Image handling
 	TSharedPtr<FLeapImage> LeapImageHandler;
@@ -188,6 +280,7 @@ private:
 	// LeapWrapper Callbacks
 	// Per device
 	virtual void OnFrame(const LEAP_TRACKING_EVENT* frame) override;
+	virtual void OnDroppedFrame(const LEAP_DROPPED_FRAME_EVENT* DroppedFrameEvent) override;
 	virtual void OnImage(const LEAP_IMAGE_EVENT* image_event) override;
 	virtual void OnPolicy(const uint32_t current_policies) override;
 	virtual void OnTrackingMode(const eLeapTrackingMode current_tracking_mode) override;
@@ -203,9 +296,9 @@ private:
 #endif
 
 	// Convenience Converters - Todo: wrap into separate class?
-	void SetBSFingerFromLeapDigit(class UBodyStateFinger* Finger, const FLeapDigitData& LeapDigit);
-	void SetBSThumbFromLeapThumb(class UBodyStateFinger* Finger, const FLeapDigitData& LeapDigit);
-	void SetBSHandFromLeapHand(class UBodyStateHand* Hand, const FLeapHandData& LeapHand);
+	void SetBSFingerFromLeapDigit(class UBodyStateFinger* Finger, const FLeapHandPose& LeapHand, const int32 Digit);
+	void SetBSThumbFromLeapThumb(class UBodyStateFinger* Finger, const FLeapHandPose& LeapHand);
+	void SetBSHandFromLeapHand(class UBodyStateHand* Hand, const FLeapHandPose& LeapHand);
 
 	void SwitchTrackingSource(const bool UseOpenXRAsSource);
 
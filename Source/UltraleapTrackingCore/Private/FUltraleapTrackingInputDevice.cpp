@@ -15,6 +15,7 @@
 #include "IXRTrackingSystem.h"
 #include "LeapAsync.h"
 #include "LeapComponent.h"
+#include "LeapGameThreadQueue.h"
 #include "LeapUtility.h"
 #include "Skeleton/BodyStateSkeleton.h"
 #include "UltraleapTrackingData.h"
@@ -27,7 +28,8 @@ DECLARE_CYCLE_STAT(TEXT("Leap BodyState Tick"), STAT_LeapBodyStateTick, STATGROU
 
 #pragma region Utility
 // Function call Utility
-void FUltraleapTrackingInputDevice::CallFunctionOnComponents(TFunction<void(ULeapComponent*)> InFunction)
+void FUltraleapTrackingInputDevice::CallFunctionOnComponents(
+	const ELeapEventSubscription Events, TFunction<void(ULeapComponent*)> InFunction)
 {
 	// Callback optimization
 	if (EventDelegates.Num() <= 0)
@@ -37,19 +39,24 @@ void FUltraleapTrackingInputDevice::CallFunctionOnComponents(TFunction<void(ULea
 
 	if (IsInGameThread())
 	{
-		for (ULeapComponent* EventDelegate : EventDelegates)
-		{
-			InFunction(EventDelegate);
-		}
+		DispatchToComponents(Events, InFunction);
 	}
 	else
 	{
-		FLeapAsync::RunShortLambdaOnGameThread([this, InFunction] {
-			for (ULeapComponent* EventDelegate : EventDelegates)
-			{
-				InFunction(EventDelegate);
-			}
-		});
+		FLeapGameThreadQueue::Get().Enqueue(
+			this, [this, Events, InFunction = MoveTemp(InFunction)] { DispatchToComponents(Events, InFunction); });
+	}
+}
+
+void FUltraleapTrackingInputDevice::DispatchToComponents(
+	const ELeapEventSubscription Events, const TFunction<void(ULeapComponent*)>& InFunction)
+{
+	for (ULeapComponent* EventDelegate : EventDelegates)
+	{
+		if (EventDelegate->IsSubscribedTo(Events))
+		{
+			InFunction(EventDelegate);
+		}
 	}
 }
 
@@ -87,23 +94,25 @@ bool FUltraleapTrackingInputDevice::EmitAnalogInputEventForKey(FKey Key, float V
 // comes from service message loop
 void FUltraleapTrackingInputDevice::OnConnect()
 {
-	FLeapAsync::RunShortLambdaOnGameThread([&] {
+	FLeapGameThreadQueue::Get().Enqueue(this, [this] {
 		UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapService: OnConnect."));
 
 		IsWaitingForConnect = false;
 
 		//SetOptions(Options);
 
-		CallFunctionOnComponents([&](ULeapComponent* Component) { Component->OnLeapServiceConnected.Broadcast(); });
+		CallFunctionOnComponents(
+			ELeapEventSubscription::Service, [&](ULeapComponent* Component) { Component->OnLeapServiceConnected.Broadcast(); });
 	});
 }
 // comes from service message loop
 void FUltraleapTrackingInputDevice::OnConnectionLost()
 {
-	FLeapAsync::RunShortLambdaOnGameThread([&] {
+	FLeapGameThreadQueue::Get().Enqueue(this, [this] {
 		UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapService: OnConnectionLost."));
 
-		CallFunctionOnComponents([&](ULeapComponent* Component) { Component->OnLeapServiceDisconnected.Broadcast(); });
+		CallFunctionOnComponents(
+			ELeapEventSubscription::Service, [&](ULeapComponent* Component) { Component->OnLeapServiceDisconnected.Broadcast(); });
 	});
 }
 // already proxied onto game thread in wrapper
@@ -114,7 +123,7 @@ void FUltraleapTrackingInputDevice::OnDeviceFound(const LEAP_DEVICE_INFO* Props)
 
 	AttachedDevices.AddUnique(FString(Props->serial));
 
-	CallFunctionOnComponents(
+	CallFunctionOnComponents(ELeapEventSubscription::Device,
 		[&](ULeapComponent* Component) { Component->OnLeapDeviceAttached.Broadcast(FString(Props->serial)); });
 }
 // comes from service message loop
@@ -122,12 +131,12 @@ void FUltraleapTrackingInputDevice::OnDeviceLost(const char* Serial)
 {
 	const FString SerialString = FString(ANSI_TO_TCHAR(Serial));
 
-	FLeapAsync::RunShortLambdaOnGameThread([&, SerialString] {
+	FLeapGameThreadQueue::Get().Enqueue(this, [this, SerialString] {
 		UE_LOG(UltraleapTrackingLog, Warning, TEXT("OnDeviceLost %s."), *SerialString);
 
 		AttachedDevices.Remove(SerialString);
 
-		CallFunctionOnComponents(
+		CallFunctionOnComponents(ELeapEventSubscription::Device,
 			[SerialString](ULeapComponent* Component) { Component->OnLeapDeviceDetached.Broadcast(SerialString); });
 	});
 }
@@ -212,10 +221,20 @@ FUltraleapTrackingInputDevice::~FUltraleapTrackingInputDevice()
 {
 	IBodyState::Get().SetupGlobalDeviceManager(nullptr);
 	ShutdownLeap();
+
+	// service callbacks still queued must not reach a deleted input device
+	if (IsInGameThread())
+	{
+		FLeapGameThreadQueue::Get().DiscardTarget(this);
+		FLeapGameThreadQueue::Get().DiscardOwner(this);
+	}
 }
 
 void FUltraleapTrackingInputDevice::Tick(float DeltaTime)
 {
+	// the single point where queued LeapC callbacks reach the game thread
+	FLeapGameThreadQueue::Get().Drain();
+
 	if (Connector)
 	{
 		Connector->TickDevices(DeltaTime);
@@ -101,7 +101,9 @@ private:
 	TArray<ULeapComponent*> EventDelegates;	   // delegate storage
 
 	// Private utility methods
-	void CallFunctionOnComponents(TFunction<void(ULeapComponent*)> InFunction);	   // lambda multi-cast convenience wrapper
+	// lambda multi-cast convenience wrapper, only components subscribed to any of Events are called
+	void CallFunctionOnComponents(const ELeapEventSubscription Events, TFunction<void(ULeapComponent*)> InFunction);
+	void DispatchToComponents(const ELeapEventSubscription Events, const TFunction<void(ULeapComponent*)>& InFunction);
 	bool EmitKeyUpEventForKey(FKey Key, int32 User, bool Repeat);
 	bool EmitKeyDownEventForKey(FKey Key, int32 User, bool Repeat);
 	bool EmitAnalogInputEventForKey(FKey Key, float Value, int32 User, bool Repeat);
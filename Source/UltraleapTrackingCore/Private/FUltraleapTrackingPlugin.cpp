@@ -181,7 +181,7 @@ void* FUltraleapTrackingPlugin::GetLeapHandle()
 	// Load LeapC DLL
 	FString LeapCLibraryPath;
 
-#if PLATFORM_WINDOWS
+#if PLATFORM_WINDOWS && !ULTRALEAP_LEAPC_STUB
 	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(FString("UltraleapTracking"));
 
 	if (Plugin != nullptr)
@@ -191,7 +191,7 @@ void* FUltraleapTrackingPlugin::GetLeapHandle()
 
 		NewLeapDLLHandle = !LeapCLibraryPath.IsEmpty() ? FPlatformProcess::GetDllHandle(*LeapCLibraryPath) : nullptr;
 	}
-#endif	  // PLATFORM_WINDOWS
+#endif	  // PLATFORM_WINDOWS && !ULTRALEAP_LEAPC_STUB
 
 	if (NewLeapDLLHandle != nullptr)
 	{
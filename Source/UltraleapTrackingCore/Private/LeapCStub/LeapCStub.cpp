@@ -0,0 +1,878 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapCStub.h"
+
+#if ULTRALEAP_LEAPC_STUB
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "LeapSyntheticHands.h"
+#include "LeapUtility.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+/**
+ * In-process replacement for the LeapC API surface the plugin uses.
+ * A single simulated service owns the devices, each connection gets its own event queue.
+ * Recordings use a plugin native format ("LSTB"), they are not compatible with service .lmt files.
+ */
+
+static const uint32 StubMaxHands = 4;
+static const uint32 StubRecordingMagic = 0x4254534C;	// "LSTB"
+static const uint32 StubRecordingVersion = 1;
+
+struct _LEAP_DEVICE
+{
+	uint32 ID = 0;
+	TArray<ANSICHAR> Serial;
+	bool bAttached = false;
+	bool bSubscribed = false;
+	int64 NextFrameTime = 0;
+	int64 FrameID = 0;
+	int32 RecordingFrameIndex = 0;
+
+	bool bHasFrame = false;
+	LEAP_TRACKING_EVENT LatestFrame;
+	LEAP_HAND LatestHands[StubMaxHands];
+};
+
+struct FStubEvent
+{
+	eLeapEventType Type;
+	uint32 DeviceID;
+	uint32 Value;
+};
+
+struct _LEAP_CONNECTION
+{
+	bool bOpen = false;
+	bool bMultiDeviceAware = false;
+	uint64 Policy = 0;
+	TArray<FStubEvent> PendingEvents;
+
+	// storage for the message last returned from LeapPollConnection, valid until the next poll
+	LEAP_CONNECTION_EVENT ConnectionEvent;
+	LEAP_CONNECTION_LOST_EVENT ConnectionLostEvent;
+	LEAP_DEVICE_EVENT DeviceEvent;
+	LEAP_POLICY_EVENT PolicyEvent;
+	LEAP_TRACKING_MODE_EVENT TrackingModeEvent;
+	LEAP_TRACKING_EVENT TrackingEvent;
+	LEAP_HAND TrackingHands[StubMaxHands];
+};
+
+struct _LEAP_RECORDING
+{
+	uint32 Mode = 0;
+	// reading
+	TArray<uint8> Data;
+	int64 ReadOffset = 0;
+	// writing
+	FArchive* Writer = nullptr;
+};
+
+struct _LEAP_CLOCK_REBASER
+{
+	int64 Offset = 0;
+	bool bHasSample = false;
+};
+
+namespace
+{
+struct FStubRecordedFrame
+{
+	LEAP_TRACKING_EVENT Event;
+	LEAP_HAND Hands[StubMaxHands];
+};
+
+/** The simulated tracking service */
+class FStubService
+{
+public:
+	static FStubService& Get()
+	{
+		static FStubService Service;
+		return Service;
+	}
+
+	FCriticalSection Lock;
+	TArray<TUniquePtr<_LEAP_DEVICE>> Devices;
+	TArray<_LEAP_CONNECTION*> Connections;
+	float FrameRate = 120.0f;
+	TArray<FStubRecordedFrame> RecordedFrames;
+	uint32 NextDeviceID = 1;
+	int32 InitialDevices = 1;
+
+	FStubService()
+	{
+		FParse::Value(FCommandLine::Get(), TEXT("LeapStubDevices="), InitialDevices);
+		FParse::Value(FCommandLine::Get(), TEXT("LeapStubFrameRate="), FrameRate);
+		FString RecordingPath;
+		if (FParse::Value(FCommandLine::Get(), TEXT("LeapStubRecording="), RecordingPath))
+		{
+			LoadRecording(RecordingPath);
+		}
+		for (int32 Index = 0; Index < InitialDevices; ++Index)
+		{
+			CreateDevice();
+		}
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapC stub: %d devices at %.1fHz, %s frames."), InitialDevices, FrameRate,
+			RecordedFrames.Num() ? TEXT("recorded") : TEXT("synthetic"));
+	}
+
+	int64 FrameInterval() const
+	{
+		return FrameRate > 0 ? (int64) (1000000.0f / FrameRate) : 0;
+	}
+
+	// Lock must be held
+	_LEAP_DEVICE* CreateDevice()
+	{
+		TUniquePtr<_LEAP_DEVICE> Device = MakeUnique<_LEAP_DEVICE>();
+		Device->ID = NextDeviceID++;
+		const FString Serial = FString::Printf(TEXT("STUB%08u"), Device->ID);
+		Device->Serial.SetNumZeroed(Serial.Len() + 1);
+		FMemory::Memcpy(Device->Serial.GetData(), TCHAR_TO_ANSI(*Serial), Serial.Len());
+		Device->bAttached = true;
+		Device->NextFrameTime = LeapGetNow();
+		_LEAP_DEVICE* Ret = Device.Get();
+		Devices.Add(MoveTemp(Device));
+		return Ret;
+	}
+
+	_LEAP_DEVICE* FindDevice(const uint32 DeviceID)
+	{
+		for (TUniquePtr<_LEAP_DEVICE>& Device : Devices)
+		{
+			if (Device->ID == DeviceID)
+			{
+				return Device.Get();
+			}
+		}
+		return nullptr;
+	}
+
+	void Broadcast(const eLeapEventType Type, const uint32 DeviceID, const uint32 Value = 0)
+	{
+		for (_LEAP_CONNECTION* Connection : Connections)
+		{
+			if (Connection->bOpen)
+			{
+				Connection->PendingEvents.Add({Type, DeviceID, Value});
+			}
+		}
+	}
+
+	// Lock must be held
+	void UpdateFrame(_LEAP_DEVICE& Device, const int64 TimeStamp)
+	{
+		Device.FrameID++;
+		if (RecordedFrames.Num())
+		{
+			const FStubRecordedFrame& Source = RecordedFrames[Device.RecordingFrameIndex];
+			Device.RecordingFrameIndex = (Device.RecordingFrameIndex + 1) % RecordedFrames.Num();
+			Device.LatestFrame = Source.Event;
+			FMemory::Memcpy(Device.LatestHands, Source.Hands, sizeof(LEAP_HAND) * Source.Event.nHands);
+			Device.LatestFrame.info.frame_id = Device.FrameID;
+			Device.LatestFrame.tracking_frame_id = Device.FrameID;
+			Device.LatestFrame.info.timestamp = TimeStamp;
+		}
+		else
+		{
+			FLeapSyntheticHands::BuildFrame(Device.LatestFrame, Device.LatestHands, Device.FrameID, TimeStamp, Device.ID);
+		}
+		Device.LatestFrame.pHands = Device.LatestHands;
+		Device.bHasFrame = true;
+	}
+
+	// Lock must be held
+	bool LoadRecording(const FString& Path)
+	{
+		RecordedFrames.Reset();
+		// indices into the previous recording, which may have been longer
+		for (TUniquePtr<_LEAP_DEVICE>& Device : Devices)
+		{
+			Device->RecordingFrameIndex = 0;
+		}
+		if (Path.IsEmpty())
+		{
+			return true;
+		}
+		LEAP_RECORDING Recording = nullptr;
+		LEAP_RECORDING_PARAMETERS Params;
+		Params.mode = eLeapRecordingFlags_Reading;
+		if (LeapRecordingOpen(&Recording, TCHAR_TO_UTF8(*Path), Params) != eLeapRS_Success)
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapC stub could not load recording %s."), *Path);
+			return false;
+		}
+		uint64_t Size = 0;
+		while (LeapRecordingReadSize(Recording, &Size) == eLeapRS_Success && Size > 0 && Size <= sizeof(FStubRecordedFrame))
+		{
+			FStubRecordedFrame& Frame = RecordedFrames.AddDefaulted_GetRef();
+			LeapRecordingRead(Recording, &Frame.Event, Size);
+			FMemory::Memmove(Frame.Hands, Frame.Event.pHands, sizeof(LEAP_HAND) * Frame.Event.nHands);
+		}
+		LeapRecordingClose(&Recording);
+		return RecordedFrames.Num() > 0;
+	}
+};
+
+uint64 FrameSize(const LEAP_TRACKING_EVENT& Frame)
+{
+	return sizeof(LEAP_TRACKING_EVENT) + sizeof(LEAP_HAND) * Frame.nHands;
+}
+
+// what LeapInterpolateFrameEx writes, synthetic frames are built fresh rather than copied from LatestFrame. Lock must be held
+uint64 InterpolatedFrameSize(const FStubService& Service, const _LEAP_DEVICE& Device)
+{
+	if (Service.RecordedFrames.Num() == 0)
+	{
+		return sizeof(LEAP_TRACKING_EVENT) + sizeof(LEAP_HAND) * FLeapSyntheticHands::NumHands;
+	}
+	return FrameSize(Device.LatestFrame);
+}
+
+// copies into a caller buffer laid out as event followed by hands
+void CopyFrameToBuffer(const LEAP_TRACKING_EVENT& Frame, LEAP_TRACKING_EVENT* Buffer, const int64 TimeStamp)
+{
+	*Buffer = Frame;
+	LEAP_HAND* Hands = (LEAP_HAND*) (Buffer + 1);
+	FMemory::Memcpy(Hands, Frame.pHands, sizeof(LEAP_HAND) * Frame.nHands);
+	Buffer->pHands = Hands;
+	Buffer->info.timestamp = TimeStamp;
+}
+}	 // namespace
+
+#pragma region Stub Scripting
+
+uint32 FLeapCStub::AddDevice()
+{
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	_LEAP_DEVICE* Device = Service.CreateDevice();
+	Service.Broadcast(eLeapEventType_Device, Device->ID);
+	return Device->ID;
+}
+
+void FLeapCStub::RemoveDevice(const uint32 DeviceID)
+{
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	_LEAP_DEVICE* Device = Service.FindDevice(DeviceID);
+	if (Device && Device->bAttached)
+	{
+		// device objects stay alive so outstanding handles remain safe
+		Device->bAttached = false;
+		Device->bSubscribed = false;
+		Service.Broadcast(eLeapEventType_DeviceLost, DeviceID);
+	}
+}
+
+void FLeapCStub::SetFrameRate(const float FrameRateHz)
+{
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	Service.FrameRate = FrameRateHz;
+}
+
+bool FLeapCStub::SetFrameSource(const FString& RecordingPath)
+{
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	return Service.LoadRecording(RecordingPath);
+}
+
+static FAutoConsoleCommand LeapStubAddDeviceCommand(TEXT("leap.Stub.AddDevice"), TEXT("LeapC stub: attach a simulated device"),
+	FConsoleCommandDelegate::CreateLambda([]() { FLeapCStub::AddDevice(); }));
+
+static FAutoConsoleCommand LeapStubRemoveDeviceCommand(TEXT("leap.Stub.RemoveDevice"),
+	TEXT("LeapC stub: detach a simulated device. Usage: leap.Stub.RemoveDevice <DeviceID>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		if (Args.Num() > 0)
+		{
+			FLeapCStub::RemoveDevice(FCString::Atoi(*Args[0]));
+		}
+	}));
+
+static FAutoConsoleCommand LeapStubFrameRateCommand(TEXT("leap.Stub.FrameRate"),
+	TEXT("LeapC stub: frames per second per device, 0 = as fast as polled. Usage: leap.Stub.FrameRate <Hz>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		if (Args.Num() > 0)
+		{
+			FLeapCStub::SetFrameRate(FCString::Atof(*Args[0]));
+		}
+	}));
+
+static FAutoConsoleCommand LeapStubFrameSourceCommand(TEXT("leap.Stub.FrameSource"),
+	TEXT("LeapC stub: serve frames from a stub recording, no argument for synthetic hands. Usage: leap.Stub.FrameSource [Path]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args) { FLeapCStub::SetFrameSource(Args.Num() > 0 ? Args[0] : FString()); }));
+
+#pragma endregion Stub Scripting
+
+#pragma region LeapC API
+
+extern "C" {
+
+int64_t LEAP_CALL LeapGetNow(void)
+{
+	return (int64_t) (FPlatformTime::Seconds() * 1000000.0);
+}
+
+eLeapRS LEAP_CALL LeapCreateConnection(const LEAP_CONNECTION_CONFIG* pConfig, LEAP_CONNECTION* phConnection)
+{
+	if (!phConnection)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	_LEAP_CONNECTION* Connection = new _LEAP_CONNECTION();
+	Connection->bMultiDeviceAware = pConfig && (pConfig->flags & eLeapConnectionConfig_MultiDeviceAware);
+	Service.Connections.Add(Connection);
+	*phConnection = Connection;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapOpenConnection(LEAP_CONNECTION hConnection)
+{
+	if (!hConnection)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	hConnection->bOpen = true;
+	hConnection->PendingEvents.Add({eLeapEventType_Connection, 0, 0});
+	for (TUniquePtr<_LEAP_DEVICE>& Device : Service.Devices)
+	{
+		if (Device->bAttached)
+		{
+			hConnection->PendingEvents.Add({eLeapEventType_Device, Device->ID, 0});
+		}
+	}
+	return eLeapRS_Success;
+}
+
+void LEAP_CALL LeapCloseConnection(LEAP_CONNECTION hConnection)
+{
+	if (!hConnection)
+	{
+		return;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	hConnection->bOpen = false;
+	hConnection->PendingEvents.Reset();
+}
+
+void LEAP_CALL LeapDestroyConnection(LEAP_CONNECTION hConnection)
+{
+	if (!hConnection)
+	{
+		return;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	Service.Connections.Remove(hConnection);
+	delete hConnection;
+}
+
+eLeapRS LEAP_CALL LeapSetAllocator(LEAP_CONNECTION hConnection, const LEAP_ALLOCATOR* allocator)
+{
+	// the stub never hands out allocated buffers (no images)
+	return hConnection ? eLeapRS_Success : eLeapRS_InvalidArgument;
+}
+
+eLeapRS LEAP_CALL LeapPollConnection(LEAP_CONNECTION hConnection, uint32_t timeout, LEAP_CONNECTION_MESSAGE* evt)
+{
+	if (!hConnection || !evt)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FStubService& Service = FStubService::Get();
+	const int64 Deadline = LeapGetNow() + (int64) timeout * 1000;
+
+	while (true)
+	{
+		int64 WaitUntil = Deadline;
+		{
+			FScopeLock ScopeLock(&Service.Lock);
+			if (!hConnection->bOpen)
+			{
+				return eLeapRS_NotConnected;
+			}
+
+			FMemory::Memzero(*evt);
+			evt->size = sizeof(LEAP_CONNECTION_MESSAGE);
+
+			if (hConnection->PendingEvents.Num())
+			{
+				const FStubEvent Event = hConnection->PendingEvents[0];
+				hConnection->PendingEvents.RemoveAt(0, 1, false);
+				evt->type = Event.Type;
+				evt->device_id = Event.DeviceID;
+
+				switch (Event.Type)
+				{
+					case eLeapEventType_Connection:
+						hConnection->ConnectionEvent.flags = 0;
+						evt->connection_event = &hConnection->ConnectionEvent;
+						break;
+					case eLeapEventType_ConnectionLost:
+						hConnection->ConnectionLostEvent.flags = 0;
+						evt->connection_lost_event = &hConnection->ConnectionLostEvent;
+						break;
+					case eLeapEventType_Device:
+					case eLeapEventType_DeviceLost:
+						hConnection->DeviceEvent.flags = 0;
+						hConnection->DeviceEvent.device.handle = Service.FindDevice(Event.DeviceID);
+						hConnection->DeviceEvent.device.id = Event.DeviceID;
+						hConnection->DeviceEvent.status = Event.Type == eLeapEventType_Device ? eLeapDeviceStatus_Streaming : 0;
+						evt->device_event = &hConnection->DeviceEvent;
+						break;
+					case eLeapEventType_Policy:
+						hConnection->PolicyEvent.reserved = 0;
+						hConnection->PolicyEvent.current_policy = Event.Value;
+						evt->policy_event = &hConnection->PolicyEvent;
+						break;
+					case eLeapEventType_TrackingMode:
+						hConnection->TrackingModeEvent.reserved = 0;
+						hConnection->TrackingModeEvent.current_tracking_mode = (eLeapTrackingMode) Event.Value;
+						evt->tracking_mode_event = &hConnection->TrackingModeEvent;
+						break;
+					default:
+						evt->type = eLeapEventType_None;
+						break;
+				}
+				return eLeapRS_Success;
+			}
+
+			// earliest due frame across the devices this connection receives
+			const int64 Now = LeapGetNow();
+			_LEAP_DEVICE* DueDevice = nullptr;
+			bool bFirst = true;
+			for (TUniquePtr<_LEAP_DEVICE>& Device : Service.Devices)
+			{
+				if (!Device->bAttached)
+				{
+					continue;
+				}
+				const bool bReceives = hConnection->bMultiDeviceAware ? Device->bSubscribed : bFirst;
+				bFirst = false;
+				if (bReceives && (!DueDevice || Device->NextFrameTime < DueDevice->NextFrameTime))
+				{
+					DueDevice = Device.Get();
+				}
+			}
+
+			if (DueDevice)
+			{
+				if (DueDevice->NextFrameTime <= Now)
+				{
+					const int64 Interval = Service.FrameInterval();
+					// don't try to catch up after a stall, resume pacing from now
+					DueDevice->NextFrameTime =
+						DueDevice->NextFrameTime + Interval < Now ? Now + Interval : DueDevice->NextFrameTime + Interval;
+					Service.UpdateFrame(*DueDevice, Now);
+
+					hConnection->TrackingEvent = DueDevice->LatestFrame;
+					FMemory::Memcpy(hConnection->TrackingHands, DueDevice->LatestHands, sizeof(LEAP_HAND) * DueDevice->LatestFrame.nHands);
+					hConnection->TrackingEvent.pHands = hConnection->TrackingHands;
+					evt->type = eLeapEventType_Tracking;
+					evt->device_id = DueDevice->ID;
+					evt->tracking_event = &hConnection->TrackingEvent;
+					return eLeapRS_Success;
+				}
+				WaitUntil = FMath::Min(WaitUntil, DueDevice->NextFrameTime);
+			}
+		}
+
+		const int64 Now = LeapGetNow();
+		if (Now >= Deadline)
+		{
+			return eLeapRS_Timeout;
+		}
+		FPlatformProcess::Sleep(FMath::Max<int64>(WaitUntil - Now, 0) / 1000000.0f);
+	}
+}
+
+eLeapRS LEAP_CALL LeapOpenDevice(LEAP_DEVICE_REF rDevice, LEAP_DEVICE* phDevice)
+{
+	if (!rDevice.handle || !phDevice)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	*phDevice = (LEAP_DEVICE) rDevice.handle;
+	return eLeapRS_Success;
+}
+
+void LEAP_CALL LeapCloseDevice(LEAP_DEVICE hDevice)
+{
+}
+
+eLeapRS LEAP_CALL LeapSubscribeEvents(LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice)
+{
+	if (!hConnection || !hDevice)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FScopeLock ScopeLock(&FStubService::Get().Lock);
+	hDevice->bSubscribed = hDevice->bAttached;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapUnsubscribeEvents(LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice)
+{
+	if (!hConnection || !hDevice)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FScopeLock ScopeLock(&FStubService::Get().Lock);
+	hDevice->bSubscribed = false;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapGetDeviceInfo(LEAP_DEVICE hDevice, LEAP_DEVICE_INFO* info)
+{
+	if (!hDevice || !info)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	const uint32_t Required = hDevice->Serial.Num();
+	const bool bFits = info->serial && info->serial_length >= Required;
+
+	info->status = hDevice->bAttached ? eLeapDeviceStatus_Streaming : 0;
+	info->caps = 0;
+	info->pid = eLeapDevicePID_Peripheral;
+	info->baseline = 40000;
+	info->h_fov = FMath::DegreesToRadians(140.0f);
+	info->v_fov = FMath::DegreesToRadians(120.0f);
+	info->range = 800000;
+	info->serial_length = Required;
+	if (!bFits)
+	{
+		return eLeapRS_InsufficientBuffer;
+	}
+	FMemory::Memcpy(info->serial, hDevice->Serial.GetData(), Required);
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapGetDeviceFrameRateEx(LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice, float* framesPerSecond)
+{
+	if (!hConnection || !hDevice || !framesPerSecond)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	*framesPerSecond = Service.FrameRate;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapGetDeviceFrameRate(LEAP_CONNECTION hConnection, float* framesPerSecond)
+{
+	FStubService& Service = FStubService::Get();
+	// held across the Ex call as well, the lock is recursive
+	FScopeLock ScopeLock(&Service.Lock);
+	_LEAP_DEVICE* Device = Service.Devices.Num() ? Service.Devices[0].Get() : nullptr;
+	return LeapGetDeviceFrameRateEx(hConnection, Device, framesPerSecond);
+}
+
+const char* LEAP_CALL LeapDevicePIDToString(eLeapDevicePID pid)
+{
+	switch (pid)
+	{
+		case eLeapDevicePID_Peripheral:
+			return "peripheral";
+		case eLeapDevicePID_Dragonfly:
+			return "dragonfly";
+		case eLeapDevicePID_Nightcrawler:
+			return "nightcrawler";
+		case eLeapDevicePID_Rigel:
+			return "rigel";
+		case eLeapDevicePID_SIR170:
+			return "SIR170";
+		case eLeapDevicePID_3Di:
+			return "3Di";
+		case eLeapDevicePID_LMC2:
+			return "LMC2";
+		default:
+			return "unknown";
+	}
+}
+
+eLeapRS LEAP_CALL LeapSetPolicyFlags(LEAP_CONNECTION hConnection, uint64_t set, uint64_t clear)
+{
+	if (!hConnection)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FScopeLock ScopeLock(&FStubService::Get().Lock);
+	hConnection->Policy = (hConnection->Policy | set) & ~clear;
+	hConnection->PendingEvents.Add({eLeapEventType_Policy, 0, (uint32) hConnection->Policy});
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapSetPolicyFlagsEx(LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice, uint64_t set, uint64_t clear)
+{
+	if (!hConnection)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FScopeLock ScopeLock(&FStubService::Get().Lock);
+	hConnection->Policy = (hConnection->Policy | set) & ~clear;
+	hConnection->PendingEvents.Add({eLeapEventType_Policy, hDevice ? hDevice->ID : 0, (uint32) hConnection->Policy});
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapSetTrackingMode(LEAP_CONNECTION hConnection, eLeapTrackingMode mode)
+{
+	return LeapSetTrackingModeEx(hConnection, nullptr, mode);
+}
+
+eLeapRS LEAP_CALL LeapSetTrackingModeEx(LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice, eLeapTrackingMode mode)
+{
+	if (!hConnection)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FScopeLock ScopeLock(&FStubService::Get().Lock);
+	hConnection->PendingEvents.Add({eLeapEventType_TrackingMode, hDevice ? hDevice->ID : 0, (uint32) mode});
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapGetFrameSizeEx(LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice, int64_t timestamp, uint64_t* pncbEvent)
+{
+	if (!hConnection || !hDevice || !pncbEvent)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	if (!hDevice->bHasFrame)
+	{
+		Service.UpdateFrame(*hDevice, timestamp);
+	}
+	*pncbEvent = InterpolatedFrameSize(Service, *hDevice);
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapGetFrameSize(LEAP_CONNECTION hConnection, int64_t timestamp, uint64_t* pncbEvent)
+{
+	FStubService& Service = FStubService::Get();
+	// held across the Ex call as well, the lock is recursive
+	FScopeLock ScopeLock(&Service.Lock);
+	_LEAP_DEVICE* Device = Service.Devices.Num() ? Service.Devices[0].Get() : nullptr;
+	return LeapGetFrameSizeEx(hConnection, Device, timestamp, pncbEvent);
+}
+
+eLeapRS LEAP_CALL LeapInterpolateFrameEx(
+	LEAP_CONNECTION hConnection, LEAP_DEVICE hDevice, int64_t timestamp, LEAP_TRACKING_EVENT* pEvent, uint64_t ncbEvent)
+{
+	if (!hConnection || !hDevice || !pEvent)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	FStubService& Service = FStubService::Get();
+	FScopeLock ScopeLock(&Service.Lock);
+	if (!hDevice->bHasFrame)
+	{
+		Service.UpdateFrame(*hDevice, timestamp);
+	}
+	if (ncbEvent < InterpolatedFrameSize(Service, *hDevice))
+	{
+		return eLeapRS_InsufficientBuffer;
+	}
+	if (Service.RecordedFrames.Num() == 0)
+	{
+		// synthetic hands are a function of time, so this is an exact "interpolation"
+		FLeapSyntheticHands::BuildFrame(*pEvent, (LEAP_HAND*) (pEvent + 1), hDevice->FrameID, timestamp, hDevice->ID);
+		return eLeapRS_Success;
+	}
+	CopyFrameToBuffer(hDevice->LatestFrame, pEvent, timestamp);
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapInterpolateFrame(LEAP_CONNECTION hConnection, int64_t timestamp, LEAP_TRACKING_EVENT* pEvent, uint64_t ncbEvent)
+{
+	FStubService& Service = FStubService::Get();
+	// held across the Ex call as well, the lock is recursive
+	FScopeLock ScopeLock(&Service.Lock);
+	_LEAP_DEVICE* Device = Service.Devices.Num() ? Service.Devices[0].Get() : nullptr;
+	return LeapInterpolateFrameEx(hConnection, Device, timestamp, pEvent, ncbEvent);
+}
+
+eLeapRS LEAP_CALL LeapCreateClockRebaser(LEAP_CLOCK_REBASER* phClockRebaser)
+{
+	if (!phClockRebaser)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	*phClockRebaser = new _LEAP_CLOCK_REBASER();
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapUpdateRebase(LEAP_CLOCK_REBASER hClockRebaser, int64_t userClock, int64_t leapClock)
+{
+	if (!hClockRebaser)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	hClockRebaser->Offset = leapClock - userClock;
+	hClockRebaser->bHasSample = true;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapRebaseClock(LEAP_CLOCK_REBASER hClockRebaser, int64_t userClock, int64_t* pLeapClock)
+{
+	if (!hClockRebaser || !pLeapClock || !hClockRebaser->bHasSample)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	*pLeapClock = userClock + hClockRebaser->Offset;
+	return eLeapRS_Success;
+}
+
+void LEAP_CALL LeapDestroyClockRebaser(LEAP_CLOCK_REBASER hClockRebaser)
+{
+	delete hClockRebaser;
+}
+
+eLeapRS LEAP_CALL LeapRecordingOpen(LEAP_RECORDING* ppRecording, const char* filePath, LEAP_RECORDING_PARAMETERS params)
+{
+	if (!ppRecording || !filePath)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	const FString Path = UTF8_TO_TCHAR(filePath);
+	TUniquePtr<_LEAP_RECORDING> Recording = MakeUnique<_LEAP_RECORDING>();
+	Recording->Mode = params.mode;
+
+	if (params.mode & eLeapRecordingFlags_Writing)
+	{
+		Recording->Writer = IFileManager::Get().CreateFileWriter(*Path);
+		if (!Recording->Writer)
+		{
+			return eLeapRS_UnknownError;
+		}
+		uint32 Magic = StubRecordingMagic;
+		uint32 Version = StubRecordingVersion;
+		*Recording->Writer << Magic << Version;
+	}
+	else
+	{
+		if (!FFileHelper::LoadFileToArray(Recording->Data, *Path) || Recording->Data.Num() < 8)
+		{
+			return eLeapRS_UnknownError;
+		}
+		const uint32* Header = (const uint32*) Recording->Data.GetData();
+		if (Header[0] != StubRecordingMagic || Header[1] != StubRecordingVersion)
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapC stub: %s is not a stub recording."), *Path);
+			return eLeapRS_UnknownError;
+		}
+		Recording->ReadOffset = 8;
+	}
+	*ppRecording = Recording.Release();
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapRecordingClose(LEAP_RECORDING* ppRecording)
+{
+	if (!ppRecording || !*ppRecording)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	if ((*ppRecording)->Writer)
+	{
+		(*ppRecording)->Writer->Close();
+		delete (*ppRecording)->Writer;
+	}
+	delete *ppRecording;
+	*ppRecording = nullptr;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapRecordingGetStatus(LEAP_RECORDING pRecording, LEAP_RECORDING_STATUS* pstatus)
+{
+	if (!pRecording || !pstatus)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	pstatus->mode = pRecording->Mode;
+	return eLeapRS_Success;
+}
+
+// stored per frame as: uint32 nHands, LEAP_TRACKING_EVENT, LEAP_HAND[nHands]
+eLeapRS LEAP_CALL LeapRecordingReadSize(LEAP_RECORDING pRecording, uint64_t* pncbEvent)
+{
+	if (!pRecording || !pncbEvent)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	*pncbEvent = 0;
+	if (pRecording->ReadOffset + (int64) sizeof(uint32) > pRecording->Data.Num())
+	{
+		return eLeapRS_Success;
+	}
+	const uint32 NumHands = *(const uint32*) (pRecording->Data.GetData() + pRecording->ReadOffset);
+	*pncbEvent = sizeof(LEAP_TRACKING_EVENT) + sizeof(LEAP_HAND) * NumHands;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapRecordingRead(LEAP_RECORDING pRecording, LEAP_TRACKING_EVENT* pEvent, uint64_t ncbEvent)
+{
+	uint64_t Size = 0;
+	if (!pEvent || LeapRecordingReadSize(pRecording, &Size) != eLeapRS_Success || Size == 0)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	if (ncbEvent < Size)
+	{
+		return eLeapRS_InsufficientBuffer;
+	}
+	if (pRecording->ReadOffset + (int64) (sizeof(uint32) + Size) > pRecording->Data.Num())
+	{
+		return eLeapRS_UnknownError;
+	}
+	const uint8* Source = pRecording->Data.GetData() + pRecording->ReadOffset + sizeof(uint32);
+	FMemory::Memcpy(pEvent, Source, Size);
+	pEvent->pHands = (LEAP_HAND*) (pEvent + 1);
+	pRecording->ReadOffset += sizeof(uint32) + Size;
+	return eLeapRS_Success;
+}
+
+eLeapRS LEAP_CALL LeapRecordingWrite(LEAP_RECORDING pRecording, LEAP_TRACKING_EVENT* pEvent, uint64_t* pnBytesWritten)
+{
+	if (!pRecording || !pRecording->Writer || !pEvent)
+	{
+		return eLeapRS_InvalidArgument;
+	}
+	uint32 NumHands = pEvent->nHands;
+	*pRecording->Writer << NumHands;
+	pRecording->Writer->Serialize(pEvent, sizeof(LEAP_TRACKING_EVENT));
+	if (NumHands)
+	{
+		pRecording->Writer->Serialize(pEvent->pHands, sizeof(LEAP_HAND) * NumHands);
+	}
+	if (pnBytesWritten)
+	{
+		*pnBytesWritten = sizeof(uint32) + sizeof(LEAP_TRACKING_EVENT) + sizeof(LEAP_HAND) * NumHands;
+	}
+	return pRecording->Writer->IsError() ? eLeapRS_UnknownError : eLeapRS_Success;
+}
+
+}	 // extern "C"
+
+#pragma endregion LeapC API
+
+#endif	  // ULTRALEAP_LEAPC_STUB
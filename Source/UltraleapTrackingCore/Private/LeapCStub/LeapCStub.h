@@ -0,0 +1,41 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+#ifndef ULTRALEAP_LEAPC_STUB
+#define ULTRALEAP_LEAPC_STUB 0
+#endif
+
+#if ULTRALEAP_LEAPC_STUB
+
+/**
+ * Scripting interface for the in-process LeapC stub used for headless runs (no service, no camera).
+ * Enabled by building with the environment variable ULTRALEAP_LEAPC_STUB=1, see UltraleapTracking.Build.cs.
+ *
+ * Command line options:
+ *   -LeapStubDevices=N        devices attached on connect (default 1)
+ *   -LeapStubFrameRate=Hz     tracking frame rate per device (default 120)
+ *   -LeapStubRecording=Path   serve frames from a stub recording instead of synthetic hands
+ */
+class FLeapCStub
+{
+public:
+	/** Queues a device attach event, returns the new device ID */
+	static uint32 AddDevice();
+	/** Queues a device lost event for DeviceID */
+	static void RemoveDevice(const uint32 DeviceID);
+	static void SetFrameRate(const float FrameRateHz);
+	/** Empty path switches back to synthetic hands */
+	static bool SetFrameSource(const FString& RecordingPath);
+};
+
+#endif	  // ULTRALEAP_LEAPC_STUB
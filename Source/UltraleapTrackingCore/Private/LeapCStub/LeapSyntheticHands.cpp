@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapSyntheticHands.h"
+
+namespace
+{
+LEAP_VECTOR ToLeapVector(const FVector& Vector)
+{
+	LEAP_VECTOR Ret;
+	Ret.x = Vector.X;
+	Ret.y = Vector.Y;
+	Ret.z = Vector.Z;
+	return Ret;
+}
+
+LEAP_QUATERNION ToLeapQuat(const FQuat& Quat)
+{
+	LEAP_QUATERNION Ret;
+	Ret.x = Quat.X;
+	Ret.y = Quat.Y;
+	Ret.z = Quat.Z;
+	Ret.w = Quat.W;
+	return Ret;
+}
+
+// Leap bones point down -Z in their local space
+FQuat BasisFromDirection(const FVector& Direction)
+{
+	return FQuat::FindBetweenNormals(FVector(0, 0, -1), Direction.GetSafeNormal());
+}
+
+void SetBone(LEAP_BONE& Bone, const FVector& Prev, const FVector& Next, const float Width)
+{
+	Bone.prev_joint = ToLeapVector(Prev);
+	Bone.next_joint = ToLeapVector(Next);
+	Bone.width = Width;
+	Bone.rotation = ToLeapQuat(BasisFromDirection(Next - Prev));
+}
+}	 // namespace
+
+void FLeapSyntheticHands::BuildFrame(
+	LEAP_TRACKING_EVENT& OutFrame, LEAP_HAND* Hands, const int64 FrameID, const int64 TimeStamp, const int32 Seed)
+{
+	const double TimeInSeconds = TimeStamp / 1000000.0;
+
+	OutFrame.info.reserved = nullptr;
+	OutFrame.info.frame_id = FrameID;
+	OutFrame.info.timestamp = TimeStamp;
+	OutFrame.tracking_frame_id = FrameID;
+	OutFrame.framerate = 120.0f;
+	OutFrame.nHands = NumHands;
+	OutFrame.pHands = Hands;
+
+	BuildHand(Hands[0], eLeapHandType_Left, 1 + Seed * 2, TimeInSeconds, Seed);
+	BuildHand(Hands[1], eLeapHandType_Right, 2 + Seed * 2, TimeInSeconds, Seed);
+}
+
+void FLeapSyntheticHands::BuildHand(
+	LEAP_HAND& OutHand, const eLeapHandType Type, const uint32 HandID, const double TimeInSeconds, const int32 Seed)
+{
+	FMemory::Memzero(OutHand);
+
+	const float Side = Type == eLeapHandType_Left ? -1.0f : 1.0f;
+	const float Phase = TimeInSeconds * PI * 0.5 + Seed * 0.7f + (Side > 0 ? PI : 0);
+	// 0 open .. 1 closed
+	const float Curl = 0.5f + 0.5f * FMath::Sin(Phase * 0.5f);
+
+	const FVector Palm(Side * 80.0f + 30.0f * FMath::Sin(Phase), 200.0f + 40.0f * FMath::Cos(Phase), 20.0f * FMath::Sin(Phase * 2.0f));
+	const FVector Velocity(30.0f * FMath::Cos(Phase), -40.0f * FMath::Sin(Phase), 40.0f * FMath::Cos(Phase * 2.0f));
+	const FVector Forward(0, 0, -1);
+	const FVector Down(0, -1, 0);
+	const FVector Across(1, 0, 0);
+
+	OutHand.id = HandID;
+	OutHand.type = Type;
+	OutHand.confidence = 1.0f;
+	OutHand.visible_time = (uint64) (TimeInSeconds * 1000000.0);
+	OutHand.grab_strength = Curl;
+	OutHand.grab_angle = Curl * PI;
+	OutHand.pinch_strength = Curl;
+	OutHand.pinch_distance = (1.0f - Curl) * 60.0f;
+
+	OutHand.palm.position = ToLeapVector(Palm);
+	OutHand.palm.stabilized_position = OutHand.palm.position;
+	OutHand.palm.velocity = ToLeapVector(Velocity);
+	OutHand.palm.normal = ToLeapVector(Down);
+	OutHand.palm.direction = ToLeapVector(Forward);
+	OutHand.palm.width = 85.0f;
+	OutHand.palm.orientation = ToLeapQuat(FQuat::Identity);
+
+	const FVector Wrist = Palm - Forward * 50.0f;
+	const FVector Elbow = Wrist - Forward * 250.0f;
+	SetBone(OutHand.arm, Elbow, Wrist, 60.0f);
+
+	static const float BoneLengths[5][4] = {
+		{0.0f, 40.0f, 30.0f, 25.0f},	// thumb has a zero length metacarpal
+		{65.0f, 40.0f, 25.0f, 20.0f},
+		{62.0f, 45.0f, 28.0f, 22.0f},
+		{58.0f, 42.0f, 26.0f, 21.0f},
+		{53.0f, 33.0f, 20.0f, 19.0f},
+	};
+
+	for (int32 DigitIndex = 0; DigitIndex < 5; ++DigitIndex)
+	{
+		LEAP_DIGIT& Digit = OutHand.digits[DigitIndex];
+		Digit.finger_id = HandID * 10 + DigitIndex;
+		Digit.is_extended = Curl < 0.5f;
+
+		const float Spread = (DigitIndex - 2) * 18.0f;
+		FVector Joint = Wrist + Across * Side * Spread * 0.5f;
+		FVector Direction = (Forward + Across * Side * (DigitIndex - 2) * 0.08f).GetSafeNormal();
+		if (DigitIndex == 0)
+		{
+			Joint = Wrist + Across * Side * -25.0f;
+			Direction = (Forward - Across * Side * 0.6f).GetSafeNormal();
+		}
+
+		const float Width = DigitIndex == 0 ? 20.0f : 18.0f - DigitIndex;
+		for (int32 BoneIndex = 0; BoneIndex < 4; ++BoneIndex)
+		{
+			// metacarpals stay flat, each following joint curls further towards the palm
+			if (BoneIndex > 0)
+			{
+				Direction = FQuat(Across, -Curl * 0.5f).RotateVector(Direction);
+			}
+			const FVector Next = Joint + Direction * BoneLengths[DigitIndex][BoneIndex];
+			SetBone(Digit.bones[BoneIndex], Joint, Next, Width);
+			Joint = Next;
+		}
+	}
+}
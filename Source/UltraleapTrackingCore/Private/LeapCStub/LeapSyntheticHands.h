@@ -0,0 +1,28 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+/**
+ * Generates plausible, smoothly moving LeapC hands without a tracking service.
+ * Output is a pure function of the timestamp and seed so runs are reproducible.
+ */
+class FLeapSyntheticHands
+{
+public:
+	static const uint32 NumHands = 2;
+
+	/** Fills OutFrame with two hands in Leap space (millimetres), Hands must hold NumHands entries */
+	static void BuildFrame(
+		LEAP_TRACKING_EVENT& OutFrame, LEAP_HAND* Hands, const int64 FrameID, const int64 TimeStamp, const int32 Seed = 0);
+
+	static void BuildHand(LEAP_HAND& OutHand, const eLeapHandType Type, const uint32 HandID, const double TimeInSeconds, const int32 Seed);
+};
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapClockRebaser.h"
+
+#include "LeapUtility.h"
+
+FLeapClockRebaser::FLeapClockRebaser() : Rebaser(nullptr), bHasSample(false)
+{
+	const eLeapRS Result = LeapCreateClockRebaser(&Rebaser);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapCreateClockRebaser failed (%i), falling back to LeapGetNow"), Result);
+		Rebaser = nullptr;
+	}
+}
+
+FLeapClockRebaser::~FLeapClockRebaser()
+{
+	if (Rebaser)
+	{
+		LeapDestroyClockRebaser(Rebaser);
+		Rebaser = nullptr;
+	}
+}
+
+void FLeapClockRebaser::Update(const double PlatformSeconds, const int64 LeapTime)
+{
+	if (!Rebaser || LeapTime == 0)
+	{
+		return;
+	}
+	if (LeapUpdateRebase(Rebaser, ToMicros(PlatformSeconds), LeapTime) == eLeapRS_Success)
+	{
+		bHasSample = true;
+	}
+}
+
+bool FLeapClockRebaser::Rebase(const double PlatformSeconds, int64& OutLeapTime) const
+{
+	if (!Rebaser || !bHasSample)
+	{
+		return false;
+	}
+	int64_t LeapTime = 0;
+	if (LeapRebaseClock(Rebaser, ToMicros(PlatformSeconds), &LeapTime) != eLeapRS_Success)
+	{
+		return false;
+	}
+	OutLeapTime = LeapTime;
+	return true;
+}
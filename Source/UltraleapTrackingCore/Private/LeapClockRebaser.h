@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+/**
+ * Maps platform time (FPlatformTime::Seconds) to LeapC time through LeapC's clock rebaser.
+ * Feed it a pair of readings taken back to back once per frame with Update(), LeapC filters the pairs
+ * and compensates for drift between the two clocks. The LeapC side of the pair comes from
+ * IHandTrackingWrapper::GetNow so recordings and the LeapC stub map against their own clocks.
+ */
+class FLeapClockRebaser
+{
+public:
+	FLeapClockRebaser();
+	~FLeapClockRebaser();
+
+	FLeapClockRebaser(const FLeapClockRebaser&) = delete;
+	FLeapClockRebaser& operator=(const FLeapClockRebaser&) = delete;
+
+	/** PlatformSeconds and LeapTime (microseconds) must be sampled together */
+	void Update(const double PlatformSeconds, const int64 LeapTime);
+
+	/** Returns false until the first Update or if LeapC could not create the rebaser */
+	bool Rebase(const double PlatformSeconds, int64& OutLeapTime) const;
+
+	bool HasSample() const
+	{
+		return bHasSample;
+	}
+
+private:
+	static int64 ToMicros(const double PlatformSeconds)
+	{
+		return (int64) (PlatformSeconds * 1000000.0);
+	}
+
+	LEAP_CLOCK_REBASER Rebaser;
+	bool bHasSample;
+};
@@ -68,6 +68,63 @@ void ULeapComponent::GetLatestFrameData(FLeapFrameData& OutData, const bool Appl
 		}
 	}
 }
+FLeapFrameSnapshotPtr ULeapComponent::GetLatestFrameSnapshot() const
+{
+	if (CurrentHandTrackingDevice)
+	{
+		IHandTrackingDevice* Device = CurrentHandTrackingDevice->GetDevice();
+		if (Device)
+		{
+			return Device->GetLatestFrameSnapshot();
+		}
+	}
+	return nullptr;
+}
+ELeapEventSubscription ULeapComponent::GetSubscriptionMask() const
+{
+	ELeapEventSubscription Mask = ELeapEventSubscription::None;
+	if (OnLeapTrackingData.IsBound() || OnLeapFrameSnapshot.IsBound())
+	{
+		Mask |= ELeapEventSubscription::TrackingData;
+	}
+	if (OnHandGrabbed.IsBound() || OnHandReleased.IsBound())
+	{
+		Mask |= ELeapEventSubscription::HandGrab;
+	}
+	if (OnHandPinched.IsBound() || OnHandUnpinched.IsBound())
+	{
+		Mask |= ELeapEventSubscription::HandPinch;
+	}
+	if (OnHandBeginTracking.IsBound() || OnHandEndTracking.IsBound())
+	{
+		Mask |= ELeapEventSubscription::HandTracking;
+	}
+	if (OnLeftHandVisibilityChanged.IsBound() || OnRightHandVisibilityChanged.IsBound())
+	{
+		Mask |= ELeapEventSubscription::HandVisibility;
+	}
+	if (OnLeapDeviceAttached.IsBound() || OnLeapDeviceDetached.IsBound())
+	{
+		Mask |= ELeapEventSubscription::Device;
+	}
+	if (OnLeapServiceConnected.IsBound() || OnLeapServiceDisconnected.IsBound())
+	{
+		Mask |= ELeapEventSubscription::Service;
+	}
+	if (OnLeapPoliciesUpdated.IsBound())
+	{
+		Mask |= ELeapEventSubscription::Policies;
+	}
+	if (OnLeapTrackingModeUpdated.IsBound())
+	{
+		Mask |= ELeapEventSubscription::TrackingMode;
+	}
+	if (OnImageEvent.IsBound())
+	{
+		Mask |= ELeapEventSubscription::Images;
+	}
+	return Mask;
+}
 void ULeapComponent::ConnectToInputEvents()
 {
 	RefreshDeviceList();
@@ -200,6 +257,14 @@ bool ULeapComponent::GetDeviceOrigin(FTransform& DeviceOrigin)
 	}
 	return false;
 }
+FString ULeapComponent::GetSubscribedDeviceSerial() const
+{
+	if (CurrentHandTrackingDevice == nullptr)
+	{
+		return FString();
+	}
+	return CurrentHandTrackingDevice->GetDeviceSerial();
+}
 void ULeapComponent::UninitializeComponent()
 {
 	// remove ourselves from the delegates
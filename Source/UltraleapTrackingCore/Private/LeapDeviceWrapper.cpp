@@ -7,10 +7,21 @@
  ******************************************************************************/
 
 #include "LeapDeviceWrapper.h"
+#include "HAL/IConsoleManager.h"
 #include "LeapAsync.h"
+#include "LeapGameThreadQueue.h"
 #include "LeapUtility.h"
 #include "Runtime/Core/Public/Misc/Timespan.h"
 
+static TAutoConsoleVariable<int32> CVarLeapLocalInterpolation(TEXT("leap.LocalInterpolation"), 1,
+	TEXT("Interpolate device frames from the plugin's frame history, falling back to LeapInterpolateFrameEx when the history "
+		 "doesn't cover the requested time. 0 always asks LeapC."),
+	ECVF_Default);
+static TAutoConsoleVariable<int32> CVarLeapLocalExtrapolation(TEXT("leap.LocalExtrapolation"), 0,
+	TEXT("Let local interpolation extrapolate past the newest frame. LeapC refuses future timestamps, so by default they are "
+		 "held at the newest frame instead."),
+	ECVF_Default);
+
 #pragma region Leap Device Wrapper
 
 // created when a device is found
@@ -21,7 +32,6 @@ FLeapDeviceWrapper::FLeapDeviceWrapper(const uint32_t DeviceIDIn, const LEAP_DEV
 	, DeviceHandle(DeviceHandleIn)
 	, ConnectionHandle(ConnectionHandleIn)
 	, DataLock(new FCriticalSection())
-	, InterpolatedFrame(nullptr), InterpolatedFrameSize(0)
 	, bIsRunning(false)
 	, Connector(ConnectorIn)
 {
@@ -38,7 +48,6 @@ FLeapDeviceWrapper::~FLeapDeviceWrapper()
 	
 	bIsRunning = false;
 	CallbackDelegate = nullptr;
-	LatestFrame = nullptr;
 	
 	if (bIsConnected)
 	{
@@ -131,69 +140,99 @@ void FLeapDeviceWrapper::SetPolicyFlagFromBoolean(eLeapPolicyFlag Flag, bool Sho
 
 LEAP_TRACKING_EVENT* FLeapDeviceWrapper::GetFrame()
 {
-	LEAP_TRACKING_EVENT* currentFrame;
-	DataLock->Lock();
-	currentFrame = LatestFrame;
-	DataLock->Unlock();
-	return currentFrame;
+	return FrameBuffer.Acquire();
 }
 
-LEAP_TRACKING_EVENT* FLeapDeviceWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+LEAP_TRACKING_EVENT* FLeapDeviceWrapper::InterpolateFrame(
+	const int64 TimeStamp, FLeapInterpolatedFrameBuffer& Buffer, FLeapFrameHistory::FFrame& LocalFrame)
 {
-	uint64_t FrameSize = 0;
-	eLeapRS Result = LeapGetFrameSizeEx(ConnectionHandle, DeviceHandle, TimeStamp, &FrameSize);
-	
+	// A stale history (device stopped streaming) misses here, so the LeapC path below still detects bad devices
+	if (CVarLeapLocalInterpolation.GetValueOnAnyThread())
+	{
+		LEAP_TRACKING_EVENT* Frame =
+			FrameHistory.Interpolate(TimeStamp, LocalFrame, CVarLeapLocalExtrapolation.GetValueOnAnyThread() != 0);
+		if (Frame)
+		{
+			return Frame;
+		}
+	}
+
+	// The size only changes with the hand count, so interpolate straight into the existing buffer and
+	// only ask LeapC for the size when there is no buffer yet or it turns out to be too small.
+	// Nothing here touches DataLock, the handles are only written before the device is handed out
+	eLeapRS Result = eLeapRS_InsufficientBuffer;
+	if (Buffer.GetCapacity() > 0)
+	{
+		Result = LeapInterpolateFrameEx(ConnectionHandle, DeviceHandle, TimeStamp, Buffer.GetFrame(), Buffer.GetCapacity());
+	}
+	if (Result == eLeapRS_InsufficientBuffer)
+	{
+		uint64_t FrameSize = 0;
+		Result = LeapGetFrameSizeEx(ConnectionHandle, DeviceHandle, TimeStamp, &FrameSize);
+		if (Result == eLeapRS_Success)
+		{
+			// Check validity of frame size
+			if (FrameSize == 0)
+			{
+				return nullptr;
+			}
+			Buffer.Reserve(FrameSize);
+			Result = LeapInterpolateFrameEx(ConnectionHandle, DeviceHandle, TimeStamp, Buffer.GetFrame(), Buffer.GetCapacity());
+		}
+	}
+
 	if (Result != eLeapRS_Success)
 	{
 		if (Result == eLeapRS_RoutineIsNotSeer)
 		{
-			UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapGetFrameSizeEx failed in FLeapDeviceWrapper::GetInterpolatedFrameAtTime: TimeStamp %lld was in the future"), TimeStamp);
-			return nullptr;
+			UE_LOG(UltraleapTrackingLog, Log, TEXT("Interpolation failed in FLeapDeviceWrapper::InterpolateFrame: TimeStamp %lld was in the future"), TimeStamp);
 		}
 		else if (Result == eLeapRS_TimestampTooEarly)
 		{
-			UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapGetFrameSizeEx failed in FLeapDeviceWrapper::GetInterpolatedFrameAtTime: TimeStamp %lld was too far in the past"), TimeStamp);
-			return nullptr;
+			UE_LOG(UltraleapTrackingLog, Log, TEXT("Interpolation failed in FLeapDeviceWrapper::InterpolateFrame: TimeStamp %lld was too far in the past"), TimeStamp);
 		}
 		else
 		{
 			UE_LOG(UltraleapTrackingLog, Log, TEXT("Result was: %i"), Result);
-			UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapGetFrameSizeEx failed in  FLeapDeviceWrapper::GetInterpolatedFrameAtTime"));
+			UE_LOG(UltraleapTrackingLog, Log, TEXT("Interpolation failed in  FLeapDeviceWrapper::InterpolateFrame"));
 			// if the device goes bad (currently due to system sleep wake and replug)
 			// clean it up
 			if (Connector)
 			{
 				Connector->CleanupBadDevice(this);
 				Connector = nullptr;
-				return nullptr;
 			}
 		}
+		return nullptr;
 	}
-	// Check validity of frame size
-	if (FrameSize > 0)
-	{
-		// Different frame?
-		if (FrameSize != InterpolatedFrameSize)
-		{
-			// If we already have an allocated frame, free it
-			if (InterpolatedFrame)
-			{
-				free(InterpolatedFrame);
-			}
-			InterpolatedFrame = (LEAP_TRACKING_EVENT*) malloc(FrameSize);
-		}
-		InterpolatedFrameSize = FrameSize;
+	return Buffer.GetFrame();
+}
+
+LEAP_TRACKING_EVENT* FLeapDeviceWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+{
+	return InterpolateFrame(TimeStamp, FingerFrameBuffer, LocalFingerFrame);
+}
 
-		// Grab the new frame
-		Result = LeapInterpolateFrameEx(ConnectionHandle, DeviceHandle, TimeStamp, InterpolatedFrame, InterpolatedFrameSize);
+bool FLeapDeviceWrapper::GetInterpolatedFramesAtTimes(
+	int64 FingerTimeStamp, int64 HandTimeStamp, LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame)
+{
+	OutFingerFrame = InterpolateFrame(FingerTimeStamp, FingerFrameBuffer, LocalFingerFrame);
+	OutHandFrame = OutFingerFrame ? InterpolateFrame(HandTimeStamp, HandFrameBuffer, LocalHandFrame) : nullptr;
+	if (!OutHandFrame)
+	{
+		OutFingerFrame = nullptr;
+	}
+	return OutHandFrame != nullptr;
+}
 
-		if (Result != eLeapRS_Success)
-		{
-			UE_LOG(UltraleapTrackingLog, Log,
-				TEXT("LeapInterpolateFrameEx failed in  FLeapDeviceWrapper::GetInterpolatedFrameAtTime"));
-		}
+float FLeapDeviceWrapper::GetDeviceFrameRate()
+{
+	float FrameRate = 0;
+	if (LeapGetDeviceFrameRateEx(ConnectionHandle, DeviceHandle, &FrameRate) != eLeapRS_Success)
+	{
+		return 0;
 	}
-	return InterpolatedFrame;
+	return FrameRate;
 }
 
 LEAP_DEVICE_INFO* FLeapDeviceWrapper::GetDeviceProperties()
@@ -261,22 +300,14 @@ void FLeapDeviceWrapper::CleanupLastDevice()
 
 void FLeapDeviceWrapper::SetFrame(const LEAP_TRACKING_EVENT* Frame)
 {
-	DataLock->Lock();
-
-	if (!LatestFrame)
-	{
-		LatestFrame = (LEAP_TRACKING_EVENT*) malloc(sizeof(*Frame));
-	}
-
-	*LatestFrame = *Frame;
-
-	DataLock->Unlock();
+	FrameBuffer.Publish(Frame);
+	FrameHistory.Push(Frame);
 }
 
 
 
 
-/** Called by ServiceMessageLoop() when a tracking event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a tracking event is returned by LeapPollConnection(). */
 void FLeapDeviceWrapper::HandleTrackingEvent(const LEAP_TRACKING_EVENT* TrackingEvent)
 {
 	SetFrame(TrackingEvent);	// support polling tracking data from different thread
@@ -292,21 +323,16 @@ void FLeapDeviceWrapper::HandleImageEvent(const LEAP_IMAGE_EVENT* ImageEvent)
 	}
 }
 
-/** Called by ServiceMessageLoop() when a log event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a log event is returned by LeapPollConnection(). */
 void FLeapDeviceWrapper::HandleLogEvent(const LEAP_LOG_EVENT* LogEvent)
 {
 	if (CallbackDelegate)
 	{
-		TaskRefLog = FLeapAsync::RunShortLambdaOnGameThread([LogEvent, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnLog(LogEvent->severity, LogEvent->timestamp, LogEvent->message);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueLog(CallbackDelegate, LogEvent->severity, LogEvent->timestamp, LogEvent->message);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a policy event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a policy event is returned by LeapPollConnection(). */
 void FLeapDeviceWrapper::HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent)
 {
 	if (CallbackDelegate)
@@ -314,16 +340,11 @@ void FLeapDeviceWrapper::HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent)
 		// this is always coming back as 0, this means either the Leap service refused to set any flags?
 		// or there's a bug in the policy notification system with Leap Motion V4.
 		const uint32_t CurrentPolicy = PolicyEvent->current_policy;
-		TaskRefPolicy = FLeapAsync::RunShortLambdaOnGameThread([CurrentPolicy, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnPolicy(CurrentPolicy);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueuePolicy(CallbackDelegate, CurrentPolicy);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a policy event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a policy event is returned by LeapPollConnection(). */
 void FLeapDeviceWrapper::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT* TrackingModeEvent)
 {
 	if (CallbackDelegate)
@@ -331,40 +352,26 @@ void FLeapDeviceWrapper::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT*
 		// this is always coming back as 0, this means either the Leap service refused to set any flags?
 		// or there's a bug in the policy notification system with Leap Motion V4.
 		const uint32_t CurrentMode = TrackingModeEvent->current_tracking_mode;
-		TaskRefPolicy = FLeapAsync::RunShortLambdaOnGameThread([CurrentMode, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnTrackingMode((eLeapTrackingMode) CurrentMode);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueTrackingMode(CallbackDelegate, (eLeapTrackingMode) CurrentMode);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a config change event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a config change event is returned by LeapPollConnection(). */
 void FLeapDeviceWrapper::HandleConfigChangeEvent(const LEAP_CONFIG_CHANGE_EVENT* ConfigChangeEvent)
 {
 	if (CallbackDelegate)
 	{
-		TaskRefConfigChange = FLeapAsync::RunShortLambdaOnGameThread([ConfigChangeEvent, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnConfigChange(ConfigChangeEvent->requestID, ConfigChangeEvent->status);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueConfigChange(CallbackDelegate, ConfigChangeEvent->requestID, ConfigChangeEvent->status);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a config response event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a config response event is returned by LeapPollConnection(). */
 void FLeapDeviceWrapper::HandleConfigResponseEvent(const LEAP_CONFIG_RESPONSE_EVENT* ConfigResponseEvent)
 {
 	if (CallbackDelegate)
 	{
-		TaskRefConfigResponse = FLeapAsync::RunShortLambdaOnGameThread([ConfigResponseEvent, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnConfigResponse(ConfigResponseEvent->requestID, ConfigResponseEvent->value);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueConfigResponse(
+			CallbackDelegate, ConfigResponseEvent->requestID, ConfigResponseEvent->value);
 	}
 }
 
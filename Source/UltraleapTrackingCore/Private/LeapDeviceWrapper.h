@@ -13,6 +13,8 @@
 #include "LeapC.h"
 #include "UltraleapTrackingData.h"
 #include "LeapWrapper.h"
+#include "LeapFrameHistory.h"
+#include "LeapFrameTripleBuffer.h"
 #include "FUltraleapDevice.h"
 
 /** Wraps/Abstracts a Device */
@@ -44,11 +46,14 @@ public:
 	virtual void SetTrackingMode(eLeapTrackingMode TrackingMode) override;
 	// Polling functions
 
-	/** Get latest frame - critical section locked */
+	/** Get latest frame - lock free, only valid until the next call */
 	virtual LEAP_TRACKING_EVENT* GetFrame() override;
 
-	/** Uses leap method to get an interpolated frame at a given leap timestamp in microseconds given by e.g. LeapGetNow()*/
+	/** Interpolated frame at a given leap timestamp in microseconds given by e.g. LeapGetNow(). Sampled from the frame
+	 * history when it covers the timestamp (leap.LocalInterpolation), otherwise from LeapInterpolateFrameEx */
 	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override;
+	virtual bool GetInterpolatedFramesAtTimes(int64 FingerTimeStamp, int64 HandTimeStamp,
+		LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame) override;
 
 	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override;	 // Used in polling example
 
@@ -57,6 +62,7 @@ public:
 	{
 		return LeapGetNow();
 	}
+	virtual float GetDeviceFrameRate() override;
 	virtual uint32_t GetDeviceID() override
 	{ 
 		return DeviceID; 
@@ -80,20 +86,33 @@ public:
 		return Device.Get();
 	}
 
+	/** Last FLeapFrameHistory::Capacity frames received for this device */
+	virtual const FLeapFrameHistory* GetFrameHistory() override
+	{
+		return &FrameHistory;
+	}
+
 private:
 	void Millisleep(int Milliseconds);
 
 	// Frame and handle data
 	uint32_t DeviceID;
-	LEAP_TRACKING_EVENT* LatestFrame = nullptr;
+	FLeapFrameTripleBuffer FrameBuffer;
 	LEAP_DEVICE DeviceHandle = nullptr;
 	LEAP_CONNECTION ConnectionHandle = nullptr;
-	// Threading variables
+	// Threading variables, DataLock guards device info only
 	FCriticalSection* DataLock;
 	TFuture<void> ProducerLambdaFuture;
 
-	LEAP_TRACKING_EVENT* InterpolatedFrame;
-	uint64 InterpolatedFrameSize;
+	// Grow only, one per timestamp so the finger and hand frames can be held at the same time
+	FLeapInterpolatedFrameBuffer FingerFrameBuffer;
+	FLeapInterpolatedFrameBuffer HandFrameBuffer;
+	// Written by the LeapC thread, sampled locally before asking LeapC
+	FLeapFrameHistory FrameHistory;
+	FLeapFrameHistory::FFrame LocalFingerFrame;
+	FLeapFrameHistory::FFrame LocalHandFrame;
+	LEAP_TRACKING_EVENT* InterpolateFrame(
+		const int64 TimeStamp, FLeapInterpolatedFrameBuffer& Buffer, FLeapFrameHistory::FFrame& LocalFrame);
 
 	void SetFrame(const LEAP_TRACKING_EVENT* Frame);
 	void SetDevice(const LEAP_DEVICE_INFO* DeviceProps);
@@ -111,20 +130,6 @@ private:
 
 	FThreadSafeBool bIsRunning;
 
-	// TaskGraph event references are only stored to help with threading debug for now.
-	FGraphEventRef TaskRefConnection;
-	FGraphEventRef TaskRefConnectionLost;
-	FGraphEventRef TaskRefDeviceFound;
-	FGraphEventRef TaskRefDeviceLost;
-	FGraphEventRef TaskRefDeviceFailure;
-	FGraphEventRef TaskRefTracking;
-	FGraphEventRef TaskRefImageComplete;
-	FGraphEventRef TaskRefImageError;
-	FGraphEventRef TaskRefLog;
-	FGraphEventRef TaskRefPolicy;
-	FGraphEventRef TaskRefConfigChange;
-	FGraphEventRef TaskRefConfigResponse;
-
 	IHandTrackingWrapper* Connector;
 
 	// manages per device functionality in the same way as InputDevice used to
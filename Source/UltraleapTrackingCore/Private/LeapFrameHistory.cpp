@@ -0,0 +1,247 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapFrameHistory.h"
+
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+float LerpFloat(const float A, const float B, const float Alpha)
+{
+	return A + (B - A) * Alpha;
+}
+
+LEAP_VECTOR LerpVector(const LEAP_VECTOR& A, const LEAP_VECTOR& B, const float Alpha)
+{
+	LEAP_VECTOR Result;
+	Result.x = LerpFloat(A.x, B.x, Alpha);
+	Result.y = LerpFloat(A.y, B.y, Alpha);
+	Result.z = LerpFloat(A.z, B.z, Alpha);
+	return Result;
+}
+
+// Normalised lerp along the shortest arc, close enough to slerp for the small steps between frames
+LEAP_QUATERNION LerpQuaternion(const LEAP_QUATERNION& A, const LEAP_QUATERNION& B, const float Alpha)
+{
+	const float Dot = A.x * B.x + A.y * B.y + A.z * B.z + A.w * B.w;
+	const float Sign = Dot < 0 ? -1.f : 1.f;
+
+	LEAP_QUATERNION Result;
+	Result.x = LerpFloat(A.x, B.x * Sign, Alpha);
+	Result.y = LerpFloat(A.y, B.y * Sign, Alpha);
+	Result.z = LerpFloat(A.z, B.z * Sign, Alpha);
+	Result.w = LerpFloat(A.w, B.w * Sign, Alpha);
+
+	const float SizeSquared = Result.x * Result.x + Result.y * Result.y + Result.z * Result.z + Result.w * Result.w;
+	if (SizeSquared > SMALL_NUMBER)
+	{
+		const float InvSize = FMath::InvSqrt(SizeSquared);
+		Result.x *= InvSize;
+		Result.y *= InvSize;
+		Result.z *= InvSize;
+		Result.w *= InvSize;
+	}
+	return Result;
+}
+
+void LerpBone(const LEAP_BONE& A, const LEAP_BONE& B, const float Alpha, LEAP_BONE& Out)
+{
+	Out.prev_joint = LerpVector(A.prev_joint, B.prev_joint, Alpha);
+	Out.next_joint = LerpVector(A.next_joint, B.next_joint, Alpha);
+	Out.width = LerpFloat(A.width, B.width, Alpha);
+	Out.rotation = LerpQuaternion(A.rotation, B.rotation, Alpha);
+}
+
+// Out already holds the discrete values (ids, flags, type, extended state) of the nearer hand
+void LerpHand(const LEAP_HAND& A, const LEAP_HAND& B, const float Alpha, LEAP_HAND& Out)
+{
+	Out.confidence = LerpFloat(A.confidence, B.confidence, Alpha);
+	Out.visible_time = (uint64_t) FMath::Max(0.0, A.visible_time + ((double) B.visible_time - A.visible_time) * Alpha);
+	Out.pinch_distance = LerpFloat(A.pinch_distance, B.pinch_distance, Alpha);
+	Out.grab_angle = LerpFloat(A.grab_angle, B.grab_angle, Alpha);
+	Out.pinch_strength = LerpFloat(A.pinch_strength, B.pinch_strength, Alpha);
+	Out.grab_strength = LerpFloat(A.grab_strength, B.grab_strength, Alpha);
+
+	Out.palm.position = LerpVector(A.palm.position, B.palm.position, Alpha);
+	Out.palm.stabilized_position = LerpVector(A.palm.stabilized_position, B.palm.stabilized_position, Alpha);
+	Out.palm.velocity = LerpVector(A.palm.velocity, B.palm.velocity, Alpha);
+	Out.palm.normal = LerpVector(A.palm.normal, B.palm.normal, Alpha);
+	Out.palm.width = LerpFloat(A.palm.width, B.palm.width, Alpha);
+	Out.palm.direction = LerpVector(A.palm.direction, B.palm.direction, Alpha);
+	Out.palm.orientation = LerpQuaternion(A.palm.orientation, B.palm.orientation, Alpha);
+
+	for (int32 Digit = 0; Digit < 5; ++Digit)
+	{
+		for (int32 Bone = 0; Bone < 4; ++Bone)
+		{
+			LerpBone(A.digits[Digit].bones[Bone], B.digits[Digit].bones[Bone], Alpha, Out.digits[Digit].bones[Bone]);
+		}
+	}
+	LerpBone(A.arm, B.arm, Alpha, Out.arm);
+}
+
+const LEAP_HAND* FindHand(const LEAP_TRACKING_EVENT& Frame, const uint32_t HandId)
+{
+	for (uint32_t HandIndex = 0; HandIndex < Frame.nHands; ++HandIndex)
+	{
+		if (Frame.pHands[HandIndex].id == HandId)
+		{
+			return &Frame.pHands[HandIndex];
+		}
+	}
+	return nullptr;
+}
+}	 // namespace
+
+void FLeapFrameHistory::FFrame::CopyFrom(const LEAP_TRACKING_EVENT& Frame)
+{
+	Event = Frame;
+	Event.nHands = Frame.pHands ? FMath::Min(Frame.nHands, MaxHands) : 0;
+	Event.pHands = Hands;
+	if (Event.nHands > 0)
+	{
+		FMemory::Memcpy(Hands, Frame.pHands, sizeof(LEAP_HAND) * Event.nHands);
+	}
+}
+
+FLeapFrameHistory::FLeapFrameHistory() : NewestIndex(Capacity - 1), Count(0)
+{
+	FMemory::Memzero(Frames, sizeof(Frames));
+	for (int32 Index = 0; Index < Capacity; ++Index)
+	{
+		Frames[Index].Event.pHands = Frames[Index].Hands;
+	}
+}
+
+void FLeapFrameHistory::Push(const LEAP_TRACKING_EVENT* Frame)
+{
+	if (!Frame)
+	{
+		return;
+	}
+	FScopeLock ScopeLock(&Lock);
+
+	if (Count > 0)
+	{
+		const int64 NewestTimeStamp = FrameAtAge(0).Event.info.timestamp;
+		if (Frame->info.timestamp == NewestTimeStamp)
+		{
+			return;
+		}
+		if (Frame->info.timestamp < NewestTimeStamp)
+		{
+			Count = 0;
+		}
+	}
+	NewestIndex = (NewestIndex + 1) % Capacity;
+	Frames[NewestIndex].CopyFrom(*Frame);
+	Count = FMath::Min(Count + 1, Capacity);
+}
+
+void FLeapFrameHistory::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Count = 0;
+}
+
+int32 FLeapFrameHistory::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Count;
+}
+
+bool FLeapFrameHistory::FindBracket(const int64 TimeStamp, int32& OutBeforeAge, int32& OutAfterAge) const
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+	const int64 NewestTimeStamp = FrameAtAge(0).Event.info.timestamp;
+	if (TimeStamp >= NewestTimeStamp)
+	{
+		if (TimeStamp - NewestTimeStamp > MaxExtrapolationMicros)
+		{
+			return false;
+		}
+		OutBeforeAge = FMath::Min(1, Count - 1);
+		OutAfterAge = 0;
+		return true;
+	}
+	if (TimeStamp < FrameAtAge(Count - 1).Event.info.timestamp)
+	{
+		return false;
+	}
+	// queries are nearly always for the last couple of frames, so walk back from the newest
+	for (int32 Age = 1; Age < Count; ++Age)
+	{
+		if (FrameAtAge(Age).Event.info.timestamp <= TimeStamp)
+		{
+			OutBeforeAge = Age;
+			OutAfterAge = Age - 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FLeapFrameHistory::GetBracketingFrames(const int64 TimeStamp, FFrame& OutBefore, FFrame& OutAfter) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int32 BeforeAge = 0;
+	int32 AfterAge = 0;
+	if (!FindBracket(TimeStamp, BeforeAge, AfterAge))
+	{
+		return false;
+	}
+	OutBefore.CopyFrom(FrameAtAge(BeforeAge).Event);
+	OutAfter.CopyFrom(FrameAtAge(AfterAge).Event);
+	return true;
+}
+
+LEAP_TRACKING_EVENT* FLeapFrameHistory::Interpolate(const int64 RequestedTimeStamp, FFrame& OutFrame, const bool bAllowExtrapolation) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int32 BeforeAge = 0;
+	int32 AfterAge = 0;
+	if (!FindBracket(RequestedTimeStamp, BeforeAge, AfterAge))
+	{
+		return nullptr;
+	}
+	const LEAP_TRACKING_EVENT& Before = FrameAtAge(BeforeAge).Event;
+	const LEAP_TRACKING_EVENT& After = FrameAtAge(AfterAge).Event;
+	// still a hit within MaxExtrapolationMicros, so a stale history misses the same way either way
+	const int64 TimeStamp = bAllowExtrapolation ? RequestedTimeStamp : FMath::Min(RequestedTimeStamp, After.info.timestamp);
+
+	const int64 Span = After.info.timestamp - Before.info.timestamp;
+	// > 1 when extrapolating past the newest frame
+	const float Alpha = Span > 0 ? (float) ((double) (TimeStamp - Before.info.timestamp) / Span) : 0.f;
+
+	// Hand set, ids and the rest of the discrete state come from the nearer frame
+	OutFrame.CopyFrom(Alpha < 0.5f ? Before : After);
+	OutFrame.Event.info.timestamp = TimeStamp;
+	OutFrame.Event.framerate = LerpFloat(Before.framerate, After.framerate, FMath::Clamp(Alpha, 0.f, 1.f));
+
+	if (Span > 0)
+	{
+		for (uint32_t HandIndex = 0; HandIndex < OutFrame.Event.nHands; ++HandIndex)
+		{
+			LEAP_HAND& Hand = OutFrame.Hands[HandIndex];
+			const LEAP_HAND* BeforeHand = FindHand(Before, Hand.id);
+			const LEAP_HAND* AfterHand = FindHand(After, Hand.id);
+			// a hand that only exists in one of the frames is held as is
+			if (BeforeHand && AfterHand)
+			{
+				LerpHand(*BeforeHand, *AfterHand, Alpha, Hand);
+			}
+		}
+	}
+	return OutFrame.GetEvent();
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "LeapC.h"
+
+/**
+ * Fixed capacity ring of the last Capacity tracking frames of one device, deep copied and ordered by timestamp.
+ * Frames are pushed from the thread that receives them and sampled from any thread. Interpolation runs here in
+ * plugin code (matched hands lerped, rotations nlerped) so it needs no LeapC round trip and works for backends
+ * that can't interpolate themselves (recordings, the LeapC stub's recorded frames).
+ * Timestamps past the newest frame are extrapolated (or held at the newest frame) up to MaxExtrapolationMicros,
+ * anything further or older than the oldest frame is a miss so callers can fall back to LeapInterpolateFrameEx.
+ */
+class FLeapFrameHistory
+{
+public:
+	/** About 130ms at 120Hz */
+	static const int32 Capacity = 16;
+	/** Hands beyond this are dropped on copy, LeapC reports at most one of each chirality */
+	static const uint32 MaxHands = 4;
+	static const int64 MaxExtrapolationMicros = 50000;
+
+	/** A self contained frame, pHands points at Hands */
+	struct FFrame
+	{
+		LEAP_TRACKING_EVENT Event;
+		LEAP_HAND Hands[MaxHands];
+
+		void CopyFrom(const LEAP_TRACKING_EVENT& Frame);
+		/** pHands doesn't survive copying the struct, always go through this */
+		LEAP_TRACKING_EVENT* GetEvent()
+		{
+			Event.pHands = Hands;
+			return &Event;
+		}
+	};
+
+	FLeapFrameHistory();
+
+	/** Deep copies Frame. A timestamp that goes backwards (device reset, recording restart) clears the history first */
+	void Push(const LEAP_TRACKING_EVENT* Frame);
+	void Reset();
+	int32 Num() const;
+
+	/** Copies out the frames either side of TimeStamp, both are the newest two when extrapolating.
+	 * Returns false if TimeStamp is outside the history (see MaxExtrapolationMicros) */
+	bool GetBracketingFrames(const int64 TimeStamp, FFrame& OutBefore, FFrame& OutAfter) const;
+
+	/** Interpolates or extrapolates the bracketing frames into OutFrame, returns OutFrame's event or nullptr on a miss.
+	 * Without bAllowExtrapolation a timestamp past the newest frame gets the newest frame, stamped with its own time */
+	LEAP_TRACKING_EVENT* Interpolate(const int64 TimeStamp, FFrame& OutFrame, const bool bAllowExtrapolation = true) const;
+
+private:
+	/** Age 0 is the newest frame. Lock must be held */
+	const FFrame& FrameAtAge(const int32 Age) const
+	{
+		return Frames[(NewestIndex - Age + Capacity) % Capacity];
+	}
+	/** Ages of the frames either side of TimeStamp, OutBeforeAge >= OutAfterAge. Lock must be held */
+	bool FindBracket(const int64 TimeStamp, int32& OutBeforeAge, int32& OutAfterAge) const;
+
+	mutable FCriticalSection Lock;
+	FFrame Frames[Capacity];
+	int32 NewestIndex;
+	int32 Count;
+};
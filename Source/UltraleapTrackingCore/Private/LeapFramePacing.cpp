@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapFramePacing.h"
+
+#include "Misc/ScopeLock.h"
+
+FLeapFramePacing::FLeapFramePacing()
+	: LastTimeStamp(0)
+	, LastTrackingFrameId(0)
+	, NumIntervals(0)
+	, IntervalMean(0)
+	, IntervalM2(0)
+	, MaxInterval(0)
+	, NumDelays(0)
+	, DelaySum(0)
+	, MaxDelay(0)
+	, DroppedInPreprocessingQueue(0)
+	, DroppedInTrackingQueue(0)
+	, DroppedOther(0)
+	, MissedFrameIds(0)
+{
+}
+
+void FLeapFramePacing::RecordFrame(const LEAP_TRACKING_EVENT* Frame, const int64 ArrivalTime)
+{
+	if (!Frame)
+	{
+		return;
+	}
+	const int64 TimeStamp = Frame->info.timestamp;
+	const int64 TrackingFrameId = Frame->tracking_frame_id;
+
+	FScopeLock ScopeLock(&Lock);
+
+	// a timestamp going backwards is a device reset, not an interval
+	if (LastTimeStamp > 0 && TimeStamp > LastTimeStamp)
+	{
+		const int64 Interval = TimeStamp - LastTimeStamp;
+		++NumIntervals;
+		const double Delta = Interval - IntervalMean;
+		IntervalMean += Delta / NumIntervals;
+		IntervalM2 += Delta * (Interval - IntervalMean);
+		MaxInterval = FMath::Max(MaxInterval, Interval);
+
+		if (TrackingFrameId > LastTrackingFrameId + 1)
+		{
+			MissedFrameIds += (int32) (TrackingFrameId - LastTrackingFrameId - 1);
+		}
+	}
+	LastTimeStamp = TimeStamp;
+	LastTrackingFrameId = TrackingFrameId;
+
+	if (ArrivalTime > 0)
+	{
+		const int64 Delay = FMath::Max<int64>(ArrivalTime - TimeStamp, 0);
+		++NumDelays;
+		DelaySum += Delay;
+		MaxDelay = FMath::Max(MaxDelay, Delay);
+	}
+}
+
+void FLeapFramePacing::RecordDroppedFrame(const LEAP_DROPPED_FRAME_EVENT* DroppedFrame)
+{
+	if (!DroppedFrame)
+	{
+		return;
+	}
+	FScopeLock ScopeLock(&Lock);
+
+	switch (DroppedFrame->type)
+	{
+		case eLeapDroppedFrameType_PreprocessingQueue:
+			++DroppedInPreprocessingQueue;
+			break;
+		case eLeapDroppedFrameType_TrackingQueue:
+			++DroppedInTrackingQueue;
+			break;
+		default:
+			++DroppedOther;
+			break;
+	}
+}
+
+void FLeapFramePacing::Sample(FLeapFramePacingStats& OutStats)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	OutStats.ObservedFrameRate = IntervalMean > 0 ? (float) (1000000.0 / IntervalMean) : 0.f;
+	OutStats.FrameIntervalJitterInMS = NumIntervals > 1 ? (float) (FMath::Sqrt(IntervalM2 / NumIntervals) / 1000.0) : 0.f;
+	OutStats.MaxFrameIntervalInMS = MaxInterval / 1000.f;
+	OutStats.DeliveryDelayInMS = NumDelays > 0 ? (float) (DelaySum / NumDelays / 1000.0) : 0.f;
+	OutStats.MaxDeliveryDelayInMS = MaxDelay / 1000.f;
+
+	OutStats.DroppedInPreprocessingQueue = DroppedInPreprocessingQueue;
+	OutStats.DroppedInTrackingQueue = DroppedInTrackingQueue;
+	OutStats.DroppedOther = DroppedOther;
+	OutStats.MissedFrameIds = MissedFrameIds;
+
+	NumIntervals = 0;
+	IntervalMean = 0;
+	IntervalM2 = 0;
+	MaxInterval = 0;
+	NumDelays = 0;
+	DelaySum = 0;
+	MaxDelay = 0;
+}
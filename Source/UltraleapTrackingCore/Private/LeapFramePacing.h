@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "LeapC.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Per device frame pacing from tracking event timestamps and service dropped frame events.
+ * Recorded on the LeapC thread, sampled on the game thread. Rates and timings are per sample window, so
+ * each Sample() reports the time since the previous one. Drop counts accumulate.
+ */
+class FLeapFramePacing
+{
+public:
+	FLeapFramePacing();
+
+	/** ArrivalTime is LeapGetNow() when the event was received */
+	void RecordFrame(const LEAP_TRACKING_EVENT* Frame, const int64 ArrivalTime);
+	void RecordDroppedFrame(const LEAP_DROPPED_FRAME_EVENT* DroppedFrame);
+
+	/** Fills everything but DeviceFrameRate and starts a new window */
+	void Sample(FLeapFramePacingStats& OutStats);
+
+private:
+	FCriticalSection Lock;
+
+	int64 LastTimeStamp;
+	int64 LastTrackingFrameId;
+
+	// Current window, intervals and delays in microseconds
+	int32 NumIntervals;
+	double IntervalMean;
+	// Welford running sum of squared differences
+	double IntervalM2;
+	int64 MaxInterval;
+	int32 NumDelays;
+	double DelaySum;
+	int64 MaxDelay;
+
+	// Totals
+	int32 DroppedInPreprocessingQueue;
+	int32 DroppedInTrackingQueue;
+	int32 DroppedOther;
+	int32 MissedFrameIds;
+};
@@ -0,0 +1,244 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapFramePredictor.h"
+
+#include "HAL/CriticalSection.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<int32> CVarLeapFramePredictor(TEXT("leap.FramePredictor"), 0,
+	TEXT("How frames of sources LeapC can't interpolate (OpenXR, recordings) are predicted past the newest frame, read when "
+		 "the source is created. 0 constant velocity from the last two frames, 1 alpha-beta filtered joint velocities."),
+	ECVF_Default);
+
+namespace
+{
+// Palm, both ends of the arm and both ends of every bone
+const int32 NumJoints = 3 + 5 * 4 * 2;
+
+// Critically damped alpha-beta gains, the steady state of a constant velocity Kalman filter.
+// Alpha near one follows the measurements closely, the tracker has already smoothed them
+const float PositionGain = 0.85f;
+const float VelocityGain = PositionGain * PositionGain / (2.f - PositionGain);
+
+template <typename HandType, typename FunctionType>
+void ForEachJoint(HandType& Hand, FunctionType&& Function)
+{
+	int32 Joint = 0;
+	Function(Joint++, Hand.palm.position);
+	Function(Joint++, Hand.arm.prev_joint);
+	Function(Joint++, Hand.arm.next_joint);
+	for (int32 Digit = 0; Digit < 5; ++Digit)
+	{
+		for (int32 Bone = 0; Bone < 4; ++Bone)
+		{
+			Function(Joint++, Hand.digits[Digit].bones[Bone].prev_joint);
+			Function(Joint++, Hand.digits[Digit].bones[Bone].next_joint);
+		}
+	}
+}
+
+FVector ToVector(const LEAP_VECTOR& Vector)
+{
+	return FVector(Vector.x, Vector.y, Vector.z);
+}
+
+LEAP_VECTOR ToLeapVector(const FVector& Vector)
+{
+	LEAP_VECTOR Result;
+	Result.x = Vector.X;
+	Result.y = Vector.Y;
+	Result.z = Vector.Z;
+	return Result;
+}
+
+/** Extrapolates along the line through the two newest frames, which is what the history does past its newest frame */
+class FLeapConstantVelocityPredictor : public ILeapFramePredictor
+{
+public:
+	virtual void Observe(const LEAP_TRACKING_EVENT* Frame) override
+	{
+		History.Push(Frame);
+	}
+	virtual void Reset() override
+	{
+		History.Reset();
+	}
+	virtual LEAP_TRACKING_EVENT* Predict(const int64 TimeStamp, FLeapFrameHistory::FFrame& OutFrame) override
+	{
+		return History.Interpolate(TimeStamp, OutFrame);
+	}
+	virtual const FLeapFrameHistory& GetFrameHistory() const override
+	{
+		return History;
+	}
+
+protected:
+	FLeapFrameHistory History;
+};
+
+/**
+ * Tracks a filtered position and velocity per joint of each hand, so a single noisy frame doesn't throw the prediction
+ * the way a two frame difference does. Only joint positions are filtered, rotations and the rest of the hand come
+ * from the constant velocity extrapolation.
+ */
+class FLeapAlphaBetaPredictor : public FLeapConstantVelocityPredictor
+{
+public:
+	FLeapAlphaBetaPredictor() : NumHands(0), LastTimeStamp(0)
+	{
+	}
+
+	virtual void Observe(const LEAP_TRACKING_EVENT* Frame) override
+	{
+		if (!Frame)
+		{
+			return;
+		}
+		FLeapConstantVelocityPredictor::Observe(Frame);
+
+		FScopeLock ScopeLock(&Lock);
+
+		const int64 TimeStamp = Frame->info.timestamp;
+		if (NumHands > 0 && TimeStamp == LastTimeStamp)
+		{
+			return;
+		}
+		const float DeltaSeconds = (TimeStamp - LastTimeStamp) / 1000000.f;
+		// same as the history, time going backwards is a restart
+		if (DeltaSeconds <= 0)
+		{
+			NumHands = 0;
+		}
+		LastTimeStamp = TimeStamp;
+
+		bool bSeen[FLeapFrameHistory::MaxHands] = {};
+		const uint32 NumFrameHands = Frame->pHands ? FMath::Min(Frame->nHands, FLeapFrameHistory::MaxHands) : 0;
+		for (uint32 HandIndex = 0; HandIndex < NumFrameHands; ++HandIndex)
+		{
+			const LEAP_HAND& Hand = Frame->pHands[HandIndex];
+			int32 Index = FindHand(Hand.id);
+			if (Index == INDEX_NONE)
+			{
+				// hands that went away still hold their slots until the end of this frame
+				if (NumHands == FLeapFrameHistory::MaxHands)
+				{
+					continue;
+				}
+				// a new hand starts at rest
+				Index = NumHands++;
+				States[Index].Id = Hand.id;
+				ForEachJoint(Hand, [&](const int32 Joint, const LEAP_VECTOR& Measured) {
+					States[Index].Position[Joint] = ToVector(Measured);
+					States[Index].Velocity[Joint] = FVector::ZeroVector;
+				});
+			}
+			else
+			{
+				FHandState& State = States[Index];
+				ForEachJoint(Hand, [&](const int32 Joint, const LEAP_VECTOR& Measured) {
+					const FVector Predicted = State.Position[Joint] + State.Velocity[Joint] * DeltaSeconds;
+					const FVector Residual = ToVector(Measured) - Predicted;
+					State.Position[Joint] = Predicted + Residual * PositionGain;
+					State.Velocity[Joint] += Residual * (VelocityGain / DeltaSeconds);
+				});
+			}
+			bSeen[Index] = true;
+		}
+
+		// forget hands that went away, their ids aren't reused
+		for (int32 Index = NumHands - 1; Index >= 0; --Index)
+		{
+			if (!bSeen[Index])
+			{
+				--NumHands;
+				States[Index] = States[NumHands];
+				bSeen[Index] = bSeen[NumHands];
+			}
+		}
+	}
+
+	virtual void Reset() override
+	{
+		FLeapConstantVelocityPredictor::Reset();
+
+		FScopeLock ScopeLock(&Lock);
+		NumHands = 0;
+	}
+
+	virtual LEAP_TRACKING_EVENT* Predict(const int64 TimeStamp, FLeapFrameHistory::FFrame& OutFrame) override
+	{
+		LEAP_TRACKING_EVENT* Event = FLeapConstantVelocityPredictor::Predict(TimeStamp, OutFrame);
+		if (!Event)
+		{
+			return nullptr;
+		}
+
+		FScopeLock ScopeLock(&Lock);
+
+		// between observed frames the interpolation is already right
+		if (TimeStamp <= LastTimeStamp)
+		{
+			return Event;
+		}
+		const float DeltaSeconds = (TimeStamp - LastTimeStamp) / 1000000.f;
+		for (uint32 HandIndex = 0; HandIndex < Event->nHands; ++HandIndex)
+		{
+			LEAP_HAND& Hand = OutFrame.Hands[HandIndex];
+			const int32 Index = FindHand(Hand.id);
+			if (Index == INDEX_NONE)
+			{
+				continue;
+			}
+			const FHandState& State = States[Index];
+			ForEachJoint(Hand, [&](const int32 Joint, LEAP_VECTOR& Out) {
+				Out = ToLeapVector(State.Position[Joint] + State.Velocity[Joint] * DeltaSeconds);
+			});
+		}
+		return Event;
+	}
+
+private:
+	struct FHandState
+	{
+		uint32_t Id;
+		FVector Position[NumJoints];
+		FVector Velocity[NumJoints];
+	};
+
+	/** Lock must be held */
+	int32 FindHand(const uint32_t Id) const
+	{
+		for (int32 Index = 0; Index < NumHands; ++Index)
+		{
+			if (States[Index].Id == Id)
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	FCriticalSection Lock;
+	FHandState States[FLeapFrameHistory::MaxHands];
+	int32 NumHands;
+	int64 LastTimeStamp;
+};
+}	 // namespace
+
+TUniquePtr<ILeapFramePredictor> ILeapFramePredictor::Create()
+{
+	switch (CVarLeapFramePredictor.GetValueOnAnyThread())
+	{
+		case 1:
+			return MakeUnique<FLeapAlphaBetaPredictor>();
+		default:
+			return MakeUnique<FLeapConstantVelocityPredictor>();
+	}
+}
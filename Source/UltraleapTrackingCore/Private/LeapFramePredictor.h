@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+#include "LeapFrameHistory.h"
+
+/**
+ * Predicts a source's frames to a requested timestamp, for backends LeapC can't interpolate (OpenXR, recordings).
+ * Observe every frame the source produces, then Predict any time: inside the observed frames it interpolates, past the
+ * newest it extrapolates per joint with the model picked by leap.FramePredictor, up to
+ * FLeapFrameHistory::MaxExtrapolationMicros. Observe and Predict may be called from different threads.
+ */
+class ILeapFramePredictor
+{
+public:
+	virtual ~ILeapFramePredictor()
+	{
+	}
+
+	/** Frames with a timestamp already seen are ignored, one going backwards restarts the prediction */
+	virtual void Observe(const LEAP_TRACKING_EVENT* Frame) = 0;
+	virtual void Reset() = 0;
+
+	/** Fills OutFrame and returns its event, nullptr if the observed frames don't cover TimeStamp */
+	virtual LEAP_TRACKING_EVENT* Predict(const int64 TimeStamp, FLeapFrameHistory::FFrame& OutFrame) = 0;
+
+	virtual const FLeapFrameHistory& GetFrameHistory() const = 0;
+
+	/** The model is read from leap.FramePredictor when the source is created */
+	static TUniquePtr<ILeapFramePredictor> Create();
+};
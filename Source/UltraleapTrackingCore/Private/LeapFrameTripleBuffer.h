@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformAtomics.h"
+#include "LeapC.h"
+
+/**
+ * Single producer / single consumer triple buffer of plugin owned slots.
+ * The producer fills the slot returned by BeginWrite() and hands it over with EndWrite(), the consumer reads the
+ * newest handed over slot with Acquire(). Neither side ever blocks and the slots are reused, so nothing is allocated.
+ */
+template <typename SlotType>
+class TLeapTripleBuffer
+{
+public:
+	TLeapTripleBuffer() : BackIndex(0), SharedIndex(1), FrontIndex(2), bHasPublished(false)
+	{
+	}
+
+	/** Producer side: the slot to fill, owned by the producer until EndWrite() */
+	SlotType& BeginWrite()
+	{
+		return Slots[BackIndex];
+	}
+	/** Producer side: swap the filled back slot with the shared slot */
+	void EndWrite()
+	{
+		const int32 Previous = FPlatformAtomics::InterlockedExchange(&SharedIndex, BackIndex | DirtyFlag);
+		BackIndex = Previous & IndexMask;
+	}
+
+	/** Consumer side: returns the newest published slot, or nullptr if nothing has been published yet.
+	 * The pointer stays valid until the next call to Acquire() */
+	SlotType* Acquire()
+	{
+		if (FPlatformAtomics::AtomicRead(&SharedIndex) & DirtyFlag)
+		{
+			const int32 Previous = FPlatformAtomics::InterlockedExchange(&SharedIndex, FrontIndex);
+			FrontIndex = Previous & IndexMask;
+			bHasPublished = true;
+		}
+		return bHasPublished ? &Slots[FrontIndex] : nullptr;
+	}
+
+	/** Every slot, for one time initialisation before either side starts */
+	SlotType* GetSlots()
+	{
+		return Slots;
+	}
+	static const int32 NumSlots = 3;
+
+private:
+	static const int32 IndexMask = 0x3;
+	static const int32 DirtyFlag = 0x4;
+
+	SlotType Slots[NumSlots];
+
+	// owned by the producer
+	int32 BackIndex;
+	// exchanged between both sides, the dirty flag marks an unread slot
+	volatile int32 SharedIndex;
+	// owned by the consumer
+	int32 FrontIndex;
+	bool bHasPublished;
+};
+
+/**
+ * Triple buffer for tracking frames.
+ * The LeapC service thread publishes with Publish(), the game thread reads with Acquire().
+ * Frames are deep copied (including the hand array) into plugin owned slots so nothing
+ * points into LeapC memory once the poll call returns. Neither side ever blocks.
+ */
+class FLeapFrameTripleBuffer
+{
+public:
+	/** Hands beyond this are dropped on copy, LeapC reports at most one of each chirality */
+	static const uint32 MaxHands = 4;
+
+	FLeapFrameTripleBuffer()
+	{
+		FSlot* Slots = Buffer.GetSlots();
+		FMemory::Memzero(Slots, sizeof(FSlot) * FSlotBuffer::NumSlots);
+		for (int32 SlotIndex = 0; SlotIndex < FSlotBuffer::NumSlots; ++SlotIndex)
+		{
+			Slots[SlotIndex].Event.pHands = Slots[SlotIndex].Hands;
+		}
+	}
+
+	/** Producer side: copy the frame into the back slot and swap it with the shared slot */
+	void Publish(const LEAP_TRACKING_EVENT* Frame)
+	{
+		FSlot& Slot = Buffer.BeginWrite();
+		Slot.Event = *Frame;
+		Slot.Event.nHands = FMath::Min(Frame->nHands, MaxHands);
+		Slot.Event.pHands = Slot.Hands;
+		if (Slot.Event.nHands > 0 && Frame->pHands)
+		{
+			FMemory::Memcpy(Slot.Hands, Frame->pHands, sizeof(LEAP_HAND) * Slot.Event.nHands);
+		}
+		Buffer.EndWrite();
+	}
+
+	/** Consumer side: returns the newest published frame, or nullptr if nothing has been published yet.
+	 * The pointer stays valid until the next call to Acquire() */
+	LEAP_TRACKING_EVENT* Acquire()
+	{
+		FSlot* Slot = Buffer.Acquire();
+		return Slot ? &Slot->Event : nullptr;
+	}
+
+private:
+	struct FSlot
+	{
+		LEAP_TRACKING_EVENT Event;
+		LEAP_HAND Hands[MaxHands];
+	};
+	typedef TLeapTripleBuffer<FSlot> FSlotBuffer;
+
+	FSlotBuffer Buffer;
+};
@@ -0,0 +1,299 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapGameThreadQueue.h"
+
+#include "HAL/PlatformAtomics.h"
+#include "IUltraleapTrackingPlugin.h"
+#include "Misc/ScopeLock.h"
+#include "LeapUtility.h"
+
+DECLARE_STATS_GROUP(TEXT("UltraleapGameThreadQueue"), STATGROUP_UltraleapGameThreadQueue, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Game Thread Events Drained"), STAT_LeapGameThreadEventsDrained, STATGROUP_UltraleapGameThreadQueue);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leap Game Thread Queue Overflows"), STAT_LeapGameThreadQueueOverflows, STATGROUP_UltraleapGameThreadQueue);
+
+namespace
+{
+// Counters wrap, do the arithmetic unsigned
+int32 Advance(const int32 Value, const int32 By)
+{
+	return (int32) ((uint32) Value + (uint32) By);
+}
+int32 Distance(const int32 From, const int32 To)
+{
+	return (int32) ((uint32) To - (uint32) From);
+}
+}	 // namespace
+
+FLeapGameThreadQueue& FLeapGameThreadQueue::Get()
+{
+	static FLeapGameThreadQueue Queue;
+	return Queue;
+}
+
+FLeapGameThreadQueue::FLeapGameThreadQueue() : Head(0), Tail(0), NumSpilled(0)
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+	for (int32 Index = 0; Index < Capacity; ++Index)
+	{
+		Slots[Index].Sequence = Index;
+		Slots[Index].Event.Target = nullptr;
+		Slots[Index].Event.Owner = nullptr;
+	}
+}
+
+void FLeapGameThreadQueue::FEvent::Execute()
+{
+	if (Type == EEventType::Function)
+	{
+		if (Function)
+		{
+			Function();
+		}
+		return;
+	}
+	// Target was discarded or never set
+	if (!Target)
+	{
+		return;
+	}
+	switch (Type)
+	{
+		case EEventType::Log:
+			Target->OnLog(Severity, Timestamp, Message);
+			break;
+		case EEventType::Policy:
+			Target->OnPolicy(Value);
+			break;
+		case EEventType::TrackingMode:
+			Target->OnTrackingMode((eLeapTrackingMode) Value);
+			break;
+		case EEventType::ConfigChange:
+			Target->OnConfigChange(RequestID, Value != 0);
+			break;
+		case EEventType::ConfigResponse:
+			Target->OnConfigResponse(RequestID, Variant);
+			break;
+		case EEventType::DeviceFailure:
+			Target->OnDeviceFailure(FailureCode, FailedDevice);
+			break;
+		default:
+			break;
+	}
+}
+
+FLeapGameThreadQueue::FSlot* FLeapGameThreadQueue::Claim(int32& OutIndex)
+{
+	int32 Position = FPlatformAtomics::AtomicRead(&Head);
+	while (true)
+	{
+		FSlot& Slot = Slots[Position & (Capacity - 1)];
+		const int32 Lag = Distance(Position, FPlatformAtomics::AtomicRead(&Slot.Sequence));
+		if (Lag == 0)
+		{
+			if (FPlatformAtomics::InterlockedCompareExchange(&Head, Advance(Position, 1), Position) == Position)
+			{
+				OutIndex = Position;
+				return &Slot;
+			}
+		}
+		else if (Lag < 0)
+		{
+			// the consumer hasn't released this slot yet, ring is full
+			return nullptr;
+		}
+		Position = FPlatformAtomics::AtomicRead(&Head);
+	}
+}
+
+void FLeapGameThreadQueue::Publish(FSlot& Slot, const int32 Index)
+{
+	// full barrier, the event is visible before the sequence says so
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Advance(Index, 1));
+}
+
+#pragma region Producers
+
+template <typename FillFunctionType>
+void FLeapGameThreadQueue::Push(const EEventType Type, LeapWrapperCallbackInterface* Target, FillFunctionType&& Fill)
+{
+	if (FPlatformAtomics::AtomicRead(&NumSpilled) == 0)
+	{
+		int32 Index = 0;
+		FSlot* Slot = Claim(Index);
+		if (Slot)
+		{
+			Slot->Event.Type = Type;
+			Slot->Event.Target = Target;
+			Fill(Slot->Event);
+			Publish(*Slot, Index);
+			return;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_LeapGameThreadQueueOverflows);
+	FScopeLock Lock(&SpillLock);
+	FEvent& Event = Spilled.AddDefaulted_GetRef();
+	Event.Type = Type;
+	Event.Target = Target;
+	Event.Owner = nullptr;
+	Fill(Event);
+	FPlatformAtomics::InterlockedExchange(&NumSpilled, Spilled.Num());
+}
+
+void FLeapGameThreadQueue::EnqueueLog(
+	LeapWrapperCallbackInterface* Target, const eLeapLogSeverity Severity, const int64 Timestamp, const char* Message)
+{
+	Push(EEventType::Log, Target, [&](FEvent& Event) {
+		Event.Severity = Severity;
+		Event.Timestamp = Timestamp;
+		FCStringAnsi::Strncpy(Event.Message, Message ? Message : "", MaxLogMessageLength);
+	});
+}
+
+void FLeapGameThreadQueue::EnqueuePolicy(LeapWrapperCallbackInterface* Target, const uint32 CurrentPolicies)
+{
+	Push(EEventType::Policy, Target, [&](FEvent& Event) { Event.Value = CurrentPolicies; });
+}
+
+void FLeapGameThreadQueue::EnqueueTrackingMode(LeapWrapperCallbackInterface* Target, const eLeapTrackingMode TrackingMode)
+{
+	Push(EEventType::TrackingMode, Target, [&](FEvent& Event) { Event.Value = (uint32) TrackingMode; });
+}
+
+void FLeapGameThreadQueue::EnqueueConfigChange(LeapWrapperCallbackInterface* Target, const uint32 RequestID, const bool bSuccess)
+{
+	Push(EEventType::ConfigChange, Target, [&](FEvent& Event) {
+		Event.RequestID = RequestID;
+		Event.Value = bSuccess ? 1 : 0;
+	});
+}
+
+void FLeapGameThreadQueue::EnqueueConfigResponse(
+	LeapWrapperCallbackInterface* Target, const uint32 RequestID, const LEAP_VARIANT& Value)
+{
+	Push(EEventType::ConfigResponse, Target, [&](FEvent& Event) {
+		Event.RequestID = RequestID;
+		Event.Variant = Value;
+	});
+}
+
+void FLeapGameThreadQueue::EnqueueDeviceFailure(
+	LeapWrapperCallbackInterface* Target, const eLeapDeviceStatus FailureCode, const LEAP_DEVICE FailedDevice)
+{
+	Push(EEventType::DeviceFailure, Target, [&](FEvent& Event) {
+		Event.FailureCode = FailureCode;
+		Event.FailedDevice = FailedDevice;
+	});
+}
+
+void FLeapGameThreadQueue::Enqueue(TFunction<void()>&& Function)
+{
+	Enqueue(nullptr, MoveTemp(Function));
+}
+
+void FLeapGameThreadQueue::Enqueue(const void* Owner, TFunction<void()>&& Function)
+{
+	LeapWrapperCallbackInterface* Target = nullptr;
+	Push(EEventType::Function, Target, [&](FEvent& Event) {
+		Event.Function = MoveTemp(Function);
+		Event.Owner = Owner;
+	});
+}
+
+#pragma endregion Producers
+
+int32 FLeapGameThreadQueue::Drain()
+{
+	check(IsInGameThread());
+
+	int32 NumDrained = 0;
+	while (true)
+	{
+		FSlot& Slot = Slots[Tail & (Capacity - 1)];
+		if (FPlatformAtomics::AtomicRead(&Slot.Sequence) != Advance(Tail, 1))
+		{
+			break;
+		}
+		// run in place, the slot isn't handed back to producers until it's released below
+		Slot.Event.Execute();
+		Slot.Event.Function.Reset();
+		Slot.Event.Target = nullptr;
+		Slot.Event.Owner = nullptr;
+
+		FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Advance(Tail, Capacity));
+		Tail = Advance(Tail, 1);
+		++NumDrained;
+	}
+
+	// the ring is empty, so everything spilled was queued before anything the ring takes from here on
+	if (FPlatformAtomics::AtomicRead(&NumSpilled) > 0)
+	{
+		{
+			FScopeLock Lock(&SpillLock);
+			Swap(Spilled, DrainingSpilled);
+			FPlatformAtomics::InterlockedExchange(&NumSpilled, 0);
+		}
+		// by index, an event can discard the ones after it
+		for (int32 Index = 0; Index < DrainingSpilled.Num(); ++Index)
+		{
+			DrainingSpilled[Index].Execute();
+			++NumDrained;
+		}
+		DrainingSpilled.Reset();
+	}
+	SET_DWORD_STAT(STAT_LeapGameThreadEventsDrained, NumDrained);
+	return NumDrained;
+}
+
+template <typename VisitFunctionType>
+void FLeapGameThreadQueue::ForEachQueued(VisitFunctionType&& Visit)
+{
+	check(IsInGameThread());
+
+	for (int32 Position = Tail;; Position = Advance(Position, 1))
+	{
+		FSlot& Slot = Slots[Position & (Capacity - 1)];
+		if (FPlatformAtomics::AtomicRead(&Slot.Sequence) != Advance(Position, 1))
+		{
+			break;
+		}
+		Visit(Slot.Event);
+	}
+
+	for (FEvent& Event : DrainingSpilled)
+	{
+		Visit(Event);
+	}
+	FScopeLock Lock(&SpillLock);
+	for (FEvent& Event : Spilled)
+	{
+		Visit(Event);
+	}
+}
+
+void FLeapGameThreadQueue::DiscardTarget(const LeapWrapperCallbackInterface* Target)
+{
+	ForEachQueued([Target](FEvent& Event) {
+		if (Event.Target == Target)
+		{
+			Event.Target = nullptr;
+		}
+	});
+}
+
+void FLeapGameThreadQueue::DiscardOwner(const void* Owner)
+{
+	ForEachQueued([Owner](FEvent& Event) {
+		if (Event.Type == EEventType::Function && Event.Owner == Owner)
+		{
+			Event.Function.Reset();
+			Event.Owner = nullptr;
+		}
+	});
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "LeapC.h"
+
+class LeapWrapperCallbackInterface;
+
+/**
+ * Multi producer / single consumer queue of game thread work, drained once per tick by FUltraleapTrackingInputDevice.
+ * Replaces one TaskGraph task per LeapC callback. The common LeapC callbacks are stored as typed events in
+ * preallocated slots (payloads copied, so nothing points into LeapC message memory), anything else is a TFunction
+ * moved into its slot. Producers don't wait for the consumer: if the ring is full the event goes to a locked spill list,
+ * drained after the ring so order and discards still apply.
+ */
+class FLeapGameThreadQueue
+{
+public:
+	/** Must be a power of two */
+	static const int32 Capacity = 256;
+	/** Longer service log lines are truncated */
+	static const int32 MaxLogMessageLength = 256;
+
+	static FLeapGameThreadQueue& Get();
+
+	FLeapGameThreadQueue();
+
+	// Producers, any thread
+	void EnqueueLog(LeapWrapperCallbackInterface* Target, const eLeapLogSeverity Severity, const int64 Timestamp, const char* Message);
+	void EnqueuePolicy(LeapWrapperCallbackInterface* Target, const uint32 CurrentPolicies);
+	void EnqueueTrackingMode(LeapWrapperCallbackInterface* Target, const eLeapTrackingMode TrackingMode);
+	void EnqueueConfigChange(LeapWrapperCallbackInterface* Target, const uint32 RequestID, const bool bSuccess);
+	void EnqueueConfigResponse(LeapWrapperCallbackInterface* Target, const uint32 RequestID, const LEAP_VARIANT& Value);
+	void EnqueueDeviceFailure(LeapWrapperCallbackInterface* Target, const eLeapDeviceStatus FailureCode, const LEAP_DEVICE FailedDevice);
+	void Enqueue(TFunction<void()>&& Function);
+	/** Owner is whatever the function captures, DiscardOwner(Owner) drops it before it runs */
+	void Enqueue(const void* Owner, TFunction<void()>&& Function);
+
+	/** Game thread, runs everything queued so far in order. Returns the number of events run */
+	int32 Drain();
+
+	/** Game thread, drops queued typed events for a callback target that is being destroyed */
+	void DiscardTarget(const LeapWrapperCallbackInterface* Target);
+	/** Game thread, drops queued functions enqueued for an owner that is being destroyed */
+	void DiscardOwner(const void* Owner);
+
+private:
+	enum class EEventType : uint8
+	{
+		Log,
+		Policy,
+		TrackingMode,
+		ConfigChange,
+		ConfigResponse,
+		DeviceFailure,
+		Function
+	};
+
+	struct FEvent
+	{
+		EEventType Type;
+		LeapWrapperCallbackInterface* Target;
+		// Log
+		eLeapLogSeverity Severity;
+		int64 Timestamp;
+		ANSICHAR Message[MaxLogMessageLength];
+		// Policy, TrackingMode, ConfigChange, ConfigResponse
+		uint32 Value;
+		uint32 RequestID;
+		LEAP_VARIANT Variant;
+		// DeviceFailure
+		eLeapDeviceStatus FailureCode;
+		LEAP_DEVICE FailedDevice;
+
+		// Function
+		TFunction<void()> Function;
+		const void* Owner;
+
+		void Execute();
+	};
+
+	struct FSlot
+	{
+		// Vyukov style sequence: == index when free, index + 1 once published
+		volatile int32 Sequence;
+		FEvent Event;
+	};
+
+	/** Claims a slot, returns nullptr when full. Publish() must follow */
+	FSlot* Claim(int32& OutIndex);
+	void Publish(FSlot& Slot, const int32 Index);
+	/** Claims and publishes a slot, Fill writes the payload. Spills when full */
+	template <typename FillFunctionType>
+	void Push(const EEventType Type, LeapWrapperCallbackInterface* Target, FillFunctionType&& Fill);
+	/** Game thread, visits the events published but not yet drained, ring and spill list */
+	template <typename VisitFunctionType>
+	void ForEachQueued(VisitFunctionType&& Visit);
+
+	FSlot Slots[Capacity];
+	// claimed by producers
+	volatile int32 Head;
+	// owned by the consumer
+	int32 Tail;
+
+	// Full ring fallback. While anything is spilled every producer spills, so nothing overtakes it through the ring
+	FCriticalSection SpillLock;
+	TArray<FEvent> Spilled;
+	volatile int32 NumSpilled;
+	// taken from Spilled by Drain, game thread only
+	TArray<FEvent> DrainingSpilled;
+};
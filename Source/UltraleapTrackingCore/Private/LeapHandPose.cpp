@@ -0,0 +1,376 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapHandPose.h"
+
+#include "LeapUtility.h"
+
+namespace
+{
+void SetBoneFromLeapBone(FLeapHandPose& Pose, const int32 Index, const LEAP_BONE& Bone, const FVector& LeapMountTranslationOffset,
+	const FQuat& LeapMountRotationOffset, const float Scale)
+{
+	Pose.PrevJoints[Index] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Bone.prev_joint, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	Pose.NextJoints[Index] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Bone.next_joint, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	Pose.Rotations[Index] = FLeapUtility::ConvertToFQuatWithHMDOffsets(Bone.rotation, LeapMountRotationOffset);
+	Pose.Widths[Index] = FLeapUtility::ScaleLeapFloatToUE(Bone.width);
+}
+
+void SetBoneFromBoneData(FLeapHandPose& Pose, const int32 Index, const FLeapBoneData& Bone, const float Confidence)
+{
+	Pose.PrevJoints[Index] = Bone.PrevJoint;
+	Pose.NextJoints[Index] = Bone.NextJoint;
+	Pose.Rotations[Index] = Bone.Rotation.Quaternion();
+	Pose.Widths[Index] = Bone.Width;
+	Pose.Confidences[Index] = Confidence;
+}
+
+void BoneDataFromBone(const FLeapHandPose& Pose, const int32 Index, FLeapBoneData& OutBone)
+{
+	OutBone.PrevJoint = Pose.PrevJoints[Index];
+	OutBone.NextJoint = Pose.NextJoints[Index];
+	OutBone.Rotation = Pose.Rotations[Index].Rotator();
+	OutBone.Width = Pose.Widths[Index];
+}
+}	 // namespace
+
+#pragma region Hand
+
+void FLeapHandPose::SetFromLeapHand(
+	const LEAP_HAND& Hand, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset, const float Scale)
+{
+	for (int32 Digit = 0; Digit < NumDigits; ++Digit)
+	{
+		const LEAP_DIGIT& LeapDigit = Hand.digits[Digit];
+		for (int32 Bone = 0; Bone < NumBonesPerDigit; ++Bone)
+		{
+			SetBoneFromLeapBone(
+				*this, BoneIndex(Digit, Bone), LeapDigit.bones[Bone], LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+		}
+		FingerIds[Digit] = LeapDigit.finger_id;
+		IsExtended[Digit] = LeapDigit.is_extended == 1;
+	}
+	SetBoneFromLeapBone(*this, ArmIndex, Hand.arm, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+
+	// LeapC has no per joint confidence, start from the hand's
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		Confidences[Bone] = Hand.confidence;
+	}
+
+	PalmPosition = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Hand.palm.position, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	PalmStabilizedPosition = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Hand.palm.stabilized_position, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	PalmVelocity = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Hand.palm.velocity, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	PalmDirection = FLeapUtility::ConvertLeapVectorToFVector(Hand.palm.direction);
+	PalmNormal = FLeapUtility::ConvertLeapVectorToFVector(Hand.palm.normal);
+	PalmOrientation = FLeapUtility::ConvertLeapQuatToFQuat(Hand.palm.orientation);
+	PalmWidth = FLeapUtility::ScaleLeapFloatToUE(Hand.palm.width);
+
+	Id = Hand.id;
+	HandType = (EHandType) Hand.type;
+	Flags = Hand.flags;
+	Confidence = Hand.confidence;
+	GrabAngle = Hand.grab_angle;
+	GrabStrength = Hand.grab_strength;
+	PinchDistance = FLeapUtility::ScaleLeapFloatToUE(Hand.pinch_distance);
+	PinchStrength = Hand.pinch_strength;
+	VisibleTime = ((double) Hand.visible_time / 1000000.0);	   // convert to seconds
+}
+
+void FLeapHandPose::SetArmPartialsFromLeapHand(
+	const LEAP_HAND& Hand, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset, const float Scale)
+{
+	NextJoints[ArmIndex] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Hand.arm.next_joint, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	PrevJoints[ArmIndex] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Hand.arm.prev_joint, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	PalmPosition = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		Hand.palm.position, LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+}
+
+void FLeapHandPose::SetFromHandData(const FLeapHandData& Hand)
+{
+	for (int32 Digit = 0; Digit < NumDigits; ++Digit)
+	{
+		if (!Hand.Digits.IsValidIndex(Digit))
+		{
+			FingerIds[Digit] = 0;
+			IsExtended[Digit] = false;
+			continue;
+		}
+		const FLeapDigitData& DigitData = Hand.Digits[Digit];
+		for (int32 Bone = 0; Bone < NumBonesPerDigit && Bone < DigitData.Bones.Num(); ++Bone)
+		{
+			SetBoneFromBoneData(*this, BoneIndex(Digit, Bone), DigitData.Bones[Bone], Hand.Confidence);
+		}
+		FingerIds[Digit] = DigitData.FingerId;
+		IsExtended[Digit] = DigitData.IsExtended;
+	}
+	SetBoneFromBoneData(*this, ArmIndex, Hand.Arm, Hand.Confidence);
+
+	PalmPosition = Hand.Palm.Position;
+	PalmStabilizedPosition = Hand.Palm.StabilizedPosition;
+	PalmVelocity = Hand.Palm.Velocity;
+	PalmDirection = Hand.Palm.Direction;
+	PalmNormal = Hand.Palm.Normal;
+	PalmOrientation = Hand.Palm.Orientation.Quaternion();
+	PalmWidth = Hand.Palm.Width;
+
+	Id = Hand.Id;
+	HandType = Hand.HandType;
+	Flags = Hand.Flags;
+	Confidence = Hand.Confidence;
+	GrabAngle = Hand.GrabAngle;
+	GrabStrength = Hand.GrabStrength;
+	PinchDistance = Hand.PinchDistance;
+	PinchStrength = Hand.PinchStrength;
+	VisibleTime = Hand.VisibleTime;
+}
+
+void FLeapHandPose::ToHandData(FLeapHandData& OutHand) const
+{
+	// sized once, later calls reuse the existing arrays
+	OutHand.Digits.SetNum(NumDigits);
+	for (int32 Digit = 0; Digit < NumDigits; ++Digit)
+	{
+		FLeapDigitData& DigitData = OutHand.Digits[Digit];
+		DigitData.Bones.SetNum(NumBonesPerDigit);
+		for (int32 Bone = 0; Bone < NumBonesPerDigit; ++Bone)
+		{
+			BoneDataFromBone(*this, BoneIndex(Digit, Bone), DigitData.Bones[Bone]);
+		}
+		DigitData.Metacarpal = DigitData.Bones[0];
+		DigitData.Proximal = DigitData.Bones[1];
+		DigitData.Intermediate = DigitData.Bones[2];
+		DigitData.Distal = DigitData.Bones[3];
+		DigitData.FingerId = FingerIds[Digit];
+		DigitData.IsExtended = IsExtended[Digit];
+	}
+	OutHand.Thumb = OutHand.Digits[0];
+	OutHand.Index = OutHand.Digits[1];
+	OutHand.Middle = OutHand.Digits[2];
+	OutHand.Ring = OutHand.Digits[3];
+	OutHand.Pinky = OutHand.Digits[4];
+
+	BoneDataFromBone(*this, ArmIndex, OutHand.Arm);
+
+	OutHand.Palm.Position = PalmPosition;
+	OutHand.Palm.StabilizedPosition = PalmStabilizedPosition;
+	OutHand.Palm.Velocity = PalmVelocity;
+	OutHand.Palm.Direction = PalmDirection;
+	OutHand.Palm.Normal = PalmNormal;
+	OutHand.Palm.Orientation = PalmOrientation.Rotator();
+	OutHand.Palm.Width = PalmWidth;
+
+	OutHand.Id = Id;
+	OutHand.HandType = HandType;
+	OutHand.Flags = Flags;
+	OutHand.Confidence = Confidence;
+	OutHand.GrabAngle = GrabAngle;
+	OutHand.GrabStrength = GrabStrength;
+	OutHand.PinchDistance = PinchDistance;
+	OutHand.PinchStrength = PinchStrength;
+	OutHand.VisibleTime = VisibleTime;
+}
+
+void FLeapHandPose::Transform(const FLeapVectorTransform& InTransform)
+{
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		InTransform.TransformPosition(PrevJoints[Bone]);
+		InTransform.TransformPosition(NextJoints[Bone]);
+		InTransform.RotateQuat(Rotations[Bone]);
+	}
+	InTransform.TransformPosition(PalmPosition);
+	InTransform.TransformPosition(PalmStabilizedPosition);
+	InTransform.TransformVector(PalmVelocity);
+	InTransform.RotateVector(PalmDirection);
+	InTransform.RotateVector(PalmNormal);
+	InTransform.RotateQuat(PalmOrientation);
+}
+
+#pragma endregion Hand
+
+#pragma region Frame
+
+const FLeapHandPose* FLeapFramePose::HandForId(const int32 HandId) const
+{
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		if (Hands[HandIndex].Id == HandId)
+		{
+			return &Hands[HandIndex];
+		}
+	}
+	return nullptr;
+}
+
+void FLeapFramePose::SetFromLeapFrame(
+	const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset)
+{
+	if (Frame == nullptr)
+	{
+		return;
+	}
+	// world scale lookup goes through the engine, do it once rather than per joint
+	SetFromLeapFrame(Frame, LeapMountTranslationOffset, LeapMountRotationOffset, FLeapUtility::GetLeapToUEScale());
+}
+
+void FLeapFramePose::SetFromLeapFrame(const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset,
+	const FQuat& LeapMountRotationOffset, const float Scale)
+{
+	if (Frame == nullptr)
+	{
+		return;
+	}
+
+	NumHands = FMath::Min((int32) Frame->nHands, MaxHands);
+	FrameRate = Frame->framerate;
+	FrameId = Frame->tracking_frame_id;
+	TimeStamp = Frame->info.timestamp;
+
+	LeftHandVisible = false;
+	RightHandVisible = false;
+
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		FLeapHandPose& Hand = Hands[HandIndex];
+		Hand.SetFromLeapHand(Frame->pHands[HandIndex], LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+
+		if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
+		{
+			LeftHandVisible = true;
+		}
+		else if (Hand.HandType == EHandType::LEAP_HAND_RIGHT)
+		{
+			RightHandVisible = true;
+		}
+	}
+}
+
+void FLeapFramePose::SetInterpolationPartialFromLeapFrame(
+	const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset)
+{
+	SetInterpolationPartialFromLeapFrame(
+		Frame, LeapMountTranslationOffset, LeapMountRotationOffset, FLeapUtility::GetLeapToUEScale());
+}
+
+void FLeapFramePose::SetInterpolationPartialFromLeapFrame(const LEAP_TRACKING_EVENT* Frame,
+	const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset, const float Scale)
+{
+	if (Frame == nullptr)
+	{
+		return;
+	}
+
+	if (NumHands != FMath::Min((int32) Frame->nHands, MaxHands))
+	{
+		return;
+	}
+
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		Hands[HandIndex].SetArmPartialsFromLeapHand(
+			Frame->pHands[HandIndex], LeapMountTranslationOffset, LeapMountRotationOffset, Scale);
+	}
+
+	TimeStamp = Frame->info.timestamp;
+}
+
+void FLeapFramePose::SetFromFrameData(const FLeapFrameData& Frame)
+{
+	NumHands = FMath::Min(Frame.Hands.Num(), MaxHands);
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		Hands[HandIndex].SetFromHandData(Frame.Hands[HandIndex]);
+	}
+
+	FrameRate = Frame.FrameRate;
+	FrameId = Frame.FrameId;
+	TimeStamp = Frame.TimeStamp;
+	LeftHandVisible = Frame.LeftHandVisible;
+	RightHandVisible = Frame.RightHandVisible;
+	FinalRotationAdjustment = Frame.FinalRotationAdjustment;
+}
+
+void FLeapFramePose::ToFrameData(FLeapFrameData& OutFrame) const
+{
+	OutFrame.Hands.SetNum(NumHands);
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		Hands[HandIndex].ToHandData(OutFrame.Hands[HandIndex]);
+	}
+
+	OutFrame.NumberOfHandsVisible = NumHands;
+	OutFrame.FrameRate = FrameRate;
+	OutFrame.FrameId = FrameId;
+	OutFrame.TimeStamp = TimeStamp;
+	OutFrame.LeftHandVisible = LeftHandVisible;
+	OutFrame.RightHandVisible = RightHandVisible;
+	OutFrame.FinalRotationAdjustment = FinalRotationAdjustment;
+}
+
+void FLeapFramePose::CopyFrom(const FLeapFramePose& Other)
+{
+	NumHands = Other.NumHands;
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		Hands[HandIndex] = Other.Hands[HandIndex];
+	}
+	FrameRate = Other.FrameRate;
+	FrameId = Other.FrameId;
+	TimeStamp = Other.TimeStamp;
+	LeftHandVisible = Other.LeftHandVisible;
+	RightHandVisible = Other.RightHandVisible;
+	FinalRotationAdjustment = Other.FinalRotationAdjustment;
+}
+
+void FLeapFramePose::SetGestureStrengthsFromFrameData(const FLeapFrameData& Frame)
+{
+	const int32 NumToCopy = FMath::Min(NumHands, Frame.Hands.Num());
+	for (int32 HandIndex = 0; HandIndex < NumToCopy; ++HandIndex)
+	{
+		const FLeapHandData& HandData = Frame.Hands[HandIndex];
+		FLeapHandPose& Hand = Hands[HandIndex];
+		Hand.GrabAngle = HandData.GrabAngle;
+		Hand.GrabStrength = HandData.GrabStrength;
+		Hand.PinchDistance = HandData.PinchDistance;
+		Hand.PinchStrength = HandData.PinchStrength;
+	}
+}
+
+void FLeapFramePose::Scale(const float InScale)
+{
+	Transform(FTransform(FQuat::Identity, FVector::ZeroVector, FVector(InScale)));
+}
+
+void FLeapFramePose::Rotate(const FQuat& InRotation)
+{
+	Transform(FTransform(InRotation));
+}
+
+void FLeapFramePose::Translate(const FVector& InTranslation)
+{
+	Transform(FTransform(InTranslation));
+}
+
+void FLeapFramePose::Transform(const FTransform& InTransform)
+{
+	const FLeapVectorTransform VectorTransform(InTransform);
+	for (int32 HandIndex = 0; HandIndex < NumHands; ++HandIndex)
+	{
+		Hands[HandIndex].Transform(VectorTransform);
+	}
+}
+
+#pragma endregion Frame
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+#include "LeapUtility.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Fixed size hand used by the internal tracking pipeline. Joints are stored as flat arrays indexed by
+ * Digit * NumBonesPerDigit + Bone with the arm last, so converting and transforming a hand are single passes over
+ * contiguous memory with no heap allocations.
+ * FLeapHandData is only built from this (ToHandData) when Blueprint facing code asks for it.
+ */
+struct FLeapHandPose
+{
+	static const int32 NumDigits = 5;
+	static const int32 NumBonesPerDigit = 4;
+	static const int32 NumDigitBones = NumDigits * NumBonesPerDigit;
+	static const int32 ArmIndex = NumDigitBones;
+	static const int32 NumBones = NumDigitBones + 1;
+
+	static int32 BoneIndex(const int32 Digit, const int32 Bone)
+	{
+		return Digit * NumBonesPerDigit + Bone;
+	}
+
+	// Per bone (digits then arm)
+	FVector PrevJoints[NumBones];
+	FVector NextJoints[NumBones];
+	FQuat Rotations[NumBones];
+	float Widths[NumBones];
+	float Confidences[NumBones];
+
+	// Per digit
+	int32 FingerIds[NumDigits];
+	bool IsExtended[NumDigits];
+
+	// Palm
+	FVector PalmPosition;
+	FVector PalmStabilizedPosition;
+	FVector PalmVelocity;
+	FVector PalmDirection;
+	FVector PalmNormal;
+	FQuat PalmOrientation;
+	float PalmWidth;
+
+	int32 Id;
+	EHandType HandType;
+	int32 Flags;
+	float Confidence;
+	float GrabAngle;
+	float GrabStrength;
+	float PinchDistance;
+	float PinchStrength;
+	float VisibleTime;
+
+	/** Converts every bone once, Scale is LEAP_TO_UE_SCALE * world scale (see FLeapUtility::GetLeapToUEScale) */
+	void SetFromLeapHand(const LEAP_HAND& Hand, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset,
+		const float Scale);
+	/** Used in interpolation */
+	void SetArmPartialsFromLeapHand(const LEAP_HAND& Hand, const FVector& LeapMountTranslationOffset,
+		const FQuat& LeapMountRotationOffset, const float Scale);
+
+	void SetFromHandData(const FLeapHandData& Hand);
+	void ToHandData(FLeapHandData& OutHand) const;
+
+	/** Scale, rotate and translate every joint in a single pass */
+	void Transform(const FLeapVectorTransform& InTransform);
+};
+
+/** Fixed capacity frame of FLeapHandPose, the internal equivalent of FLeapFrameData */
+struct FLeapFramePose
+{
+	// LeapC reports at most one hand of each chirality, leave room for transient extras
+	static const int32 MaxHands = 4;
+
+	FLeapHandPose Hands[MaxHands];
+	int32 NumHands = 0;
+
+	int32 FrameRate = 0;
+	int32 FrameId = 0;
+	int64 TimeStamp = 0;
+	bool LeftHandVisible = false;
+	bool RightHandVisible = false;
+	FRotator FinalRotationAdjustment = FRotator::ZeroRotator;
+
+	/** Returns nullptr if no hand has HandId */
+	const FLeapHandPose* HandForId(const int32 HandId) const;
+
+	void SetFromLeapFrame(
+		const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset);
+	/** As above with the scale passed in, doesn't touch the engine so it's safe on any thread */
+	void SetFromLeapFrame(const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset,
+		const FQuat& LeapMountRotationOffset, const float Scale);
+	void SetInterpolationPartialFromLeapFrame(
+		const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset);
+	void SetInterpolationPartialFromLeapFrame(const LEAP_TRACKING_EVENT* Frame, const FVector& LeapMountTranslationOffset,
+		const FQuat& LeapMountRotationOffset, const float Scale);
+
+	void SetFromFrameData(const FLeapFrameData& Frame);
+	void ToFrameData(FLeapFrameData& OutFrame) const;
+	/** Assignment that only copies the NumHands hands in use */
+	void CopyFrom(const FLeapFramePose& Other);
+	/** Copies back the per hand gesture values, e.g. after IHandTrackingWrapper::PostLeapHandUpdate */
+	void SetGestureStrengthsFromFrameData(const FLeapFrameData& Frame);
+
+	void Scale(const float InScale);
+	void Rotate(const FQuat& InRotation);
+	void Translate(const FVector& InTranslation);
+	void Transform(const FTransform& InTransform);
+};
@@ -9,6 +9,7 @@
 #include "LeapImage.h"
 
 #include "LeapAsync.h"
+#include "LeapGameThreadQueue.h"
 
 FLeapImage::FLeapImage()
 {
@@ -17,6 +18,15 @@ FLeapImage::FLeapImage()
 	Reset();
 }
 
+FLeapImage::~FLeapImage()
+{
+	// a texture update still queued must not reach a deleted handler
+	if (IsInGameThread())
+	{
+		FLeapGameThreadQueue::Get().DiscardOwner(this);
+	}
+}
+
 bool FLeapImage::HasSameTextureFormat(UTexture2D* TexturePointer, const LEAP_IMAGE& Image)
 {
 	if (TexturePointer == nullptr)
@@ -184,7 +194,7 @@ void FLeapImage::OnImage(const LEAP_IMAGE_EVENT* ImageEvent)
 	{
 		if (LeftImageTexture && RightImageTexture)
 		{
-			FLeapAsync::RunShortLambdaOnGameThread([&, BufferSize] {
+			FLeapGameThreadQueue::Get().Enqueue(this, [&, BufferSize] {
 				if (bIsQuitting)
 				{
 					return;
@@ -29,6 +29,7 @@ class FLeapImage
 {
 public:
 	FLeapImage();
+	~FLeapImage();
 
 	// Callback when an image has been processed and is ready to consume
 	FLeapImageRawSignature OnImageCallback;
@@ -0,0 +1,430 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPipelineBenchmark.h"
+#include "FUltraleapDevice.h"
+#include "HAL/IConsoleManager.h"
+#include "IBodyState.h"
+#include "LeapCStub/LeapSyntheticHands.h"
+#include "LeapUtility.h"
+#include "LeapWrapper.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Multileap/FKabschSolver.h"
+#include "Multileap/FUltraleapCombinedDeviceAngular.h"
+#include "Multileap/FUltraleapCombinedDeviceConfidence.h"
+
+namespace
+{
+/** Serves whatever frame the benchmark points it at, so real devices can be driven without a service */
+class FLeapBenchmarkWrapper : public FLeapWrapperBase
+{
+public:
+	FLeapBenchmarkWrapper(const FString& SerialIn) : Serial(SerialIn)
+	{
+		FTCHARToUTF8 SerialUTF8(*Serial);
+		SerialBuffer.SetNumZeroed(SerialUTF8.Length() + 1);
+		FMemory::Memcpy(SerialBuffer.GetData(), SerialUTF8.Get(), SerialUTF8.Length());
+
+		DeviceInfo = {0};
+		DeviceInfo.size = sizeof(LEAP_DEVICE_INFO);
+		DeviceInfo.pid = eLeapDevicePID_Unknown;
+		DeviceInfo.serial = SerialBuffer.GetData();
+		DeviceInfo.serial_length = SerialBuffer.Num();
+		CurrentDeviceInfo = &DeviceInfo;
+		bIsConnected = true;
+	}
+
+	virtual LEAP_TRACKING_EVENT* GetFrame() override
+	{
+		return CurrentFrame;
+	}
+	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override
+	{
+		return CurrentFrame;
+	}
+	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override
+	{
+		return &DeviceInfo;
+	}
+	virtual int64_t GetNow() override
+	{
+		return CurrentFrame ? CurrentFrame->info.timestamp : 0;
+	}
+	virtual FString GetDeviceSerial() override
+	{
+		return Serial;
+	}
+	virtual IHandTrackingDevice* GetDevice() override
+	{
+		return Device;
+	}
+
+	LEAP_TRACKING_EVENT* CurrentFrame = nullptr;
+	IHandTrackingDevice* Device = nullptr;
+
+private:
+	FString Serial;
+	TArray<ANSICHAR> SerialBuffer;
+	LEAP_DEVICE_INFO DeviceInfo;
+};
+
+/**
+ * Reads the call counters the allocator keeps for the memory stats, FMalloc only exposes them to derived classes.
+ * They are process wide, which is close enough while the game thread is blocked in the benchmark and the other
+ * threads are idle. Allocators only count when stats are compiled in, IsCounting() tells.
+ */
+struct FLeapMallocCalls : public FMalloc
+{
+	static int64 Get()
+	{
+		return static_cast<uint64>(TotalMallocCalls) + static_cast<uint64>(TotalReallocCalls);
+	}
+	static bool IsCounting()
+	{
+		const int64 Before = Get();
+		FMemory::Free(FMemory::Malloc(16));
+		return Get() != Before;
+	}
+};
+
+double Percentile(const TArray<uint64>& SortedSamples, const double Fraction)
+{
+	const int32 Index = FMath::Min(SortedSamples.Num() - 1, FMath::FloorToInt(SortedSamples.Num() * Fraction));
+	return SortedSamples[Index] * FPlatformTime::GetSecondsPerCycle64() * 1e9;
+}
+
+void GetBoneCentres(const FLeapFrameData& Frame, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+	if (Frame.Hands.Num() == 0)
+	{
+		return;
+	}
+	for (const FLeapDigitData& Digit : Frame.Hands[0].Digits)
+	{
+		for (const FLeapBoneData& Bone : Digit.Bones)
+		{
+			OutPoints.Add((Bone.PrevJoint + Bone.NextJoint) * 0.5f);
+		}
+	}
+}
+}	 // namespace
+
+bool FLeapPipelineBenchmark::LoadFrames(const int32 NumFrames, const FString& RecordingPath)
+{
+	for (TArray<TArray<uint8>>& SourceFrames : Frames)
+	{
+		SourceFrames.Reset();
+	}
+
+	if (RecordingPath.IsEmpty())
+	{
+		// two sources with different seeds so the combiners have something to merge
+		const int64 FrameInterval = 1000000 / 120;
+		for (int32 Source = 0; Source < 2; ++Source)
+		{
+			for (int32 Index = 0; Index < NumFrames; ++Index)
+			{
+				TArray<uint8>& Buffer = Frames[Source].AddDefaulted_GetRef();
+				Buffer.SetNumZeroed(sizeof(LEAP_TRACKING_EVENT) + sizeof(LEAP_HAND) * FLeapSyntheticHands::NumHands);
+				LEAP_TRACKING_EVENT* Event = (LEAP_TRACKING_EVENT*) Buffer.GetData();
+				FLeapSyntheticHands::BuildFrame(*Event, (LEAP_HAND*) (Event + 1), Index + 1, Index * FrameInterval, Source);
+			}
+		}
+		FrameSource = TEXT("synthetic");
+		return true;
+	}
+
+	LEAP_RECORDING Recording = nullptr;
+	LEAP_RECORDING_PARAMETERS Params;
+	Params.mode = eLeapRecordingFlags_Reading;
+	eLeapRS Result = LeapRecordingOpen(&Recording, TCHAR_TO_UTF8(*RecordingPath), Params);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapPipelineBenchmark could not open %s, result %d."), *RecordingPath,
+			(int32) Result);
+		return false;
+	}
+	uint64_t FrameSize = 0;
+	while (Frames[0].Num() < NumFrames && LeapRecordingReadSize(Recording, &FrameSize) == eLeapRS_Success && FrameSize > 0)
+	{
+		TArray<uint8>& Buffer = Frames[0].AddDefaulted_GetRef();
+		Buffer.SetNumZeroed(FrameSize);
+		if (LeapRecordingRead(Recording, (LEAP_TRACKING_EVENT*) Buffer.GetData(), FrameSize) != eLeapRS_Success)
+		{
+			Frames[0].Pop();
+			break;
+		}
+	}
+	LeapRecordingClose(&Recording);
+
+	// the second source replays the same recording half a recording out of phase
+	for (int32 Index = 0; Index < Frames[0].Num(); ++Index)
+	{
+		Frames[1].Add(Frames[0][(Index + Frames[0].Num() / 2) % Frames[0].Num()]);
+	}
+	// recorded hands point into the buffer they were read into, rebase after copying
+	for (TArray<TArray<uint8>>& SourceFrames : Frames)
+	{
+		for (TArray<uint8>& Buffer : SourceFrames)
+		{
+			LEAP_TRACKING_EVENT* Event = (LEAP_TRACKING_EVENT*) Buffer.GetData();
+			Event->pHands = (LEAP_HAND*) (Event + 1);
+		}
+	}
+	FrameSource = RecordingPath;
+	return Frames[0].Num() > 0;
+}
+
+void FLeapPipelineBenchmark::RunStage(const TCHAR* Name, TFunctionRef<void(int32)> Prepare, TFunctionRef<void(int32)> Stage)
+{
+	for (int32 Index = 0; Index < WarmupFrames; ++Index)
+	{
+		Prepare(Index);
+		Stage(Index);
+	}
+
+	Samples.Reset(NumFramesToRun);
+	int64 NumAllocations = 0;
+	for (int32 Index = 0; Index < NumFramesToRun; ++Index)
+	{
+		Prepare(Index);
+		const int64 AllocationsBefore = FLeapMallocCalls::Get();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Stage(Index);
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		NumAllocations += FLeapMallocCalls::Get() - AllocationsBefore;
+		Samples.Add(EndCycles - StartCycles);
+	}
+
+	FStageResult& Result = Results.AddDefaulted_GetRef();
+	Result.Name = Name;
+	Result.NumSamples = Samples.Num();
+	if (Samples.Num() == 0)
+	{
+		return;
+	}
+	uint64 TotalCycles = 0;
+	for (const uint64 Sample : Samples)
+	{
+		TotalCycles += Sample;
+	}
+	Samples.Sort();
+	Result.MeanNs = TotalCycles * FPlatformTime::GetSecondsPerCycle64() * 1e9 / Samples.Num();
+	Result.P50Ns = Percentile(Samples, 0.5);
+	Result.P99Ns = Percentile(Samples, 0.99);
+	Result.P999Ns = Percentile(Samples, 0.999);
+	Result.MaxNs = Percentile(Samples, 1.0);
+	Result.bAllocsCounted = bCountAllocations;
+	Result.AllocsPerFrame = bCountAllocations ? (double) NumAllocations / Samples.Num() : 0;
+}
+
+bool FLeapPipelineBenchmark::Run(const int32 NumFrames, const FString& RecordingPath)
+{
+	Results.Reset();
+	bCountAllocations = FLeapMallocCalls::IsCounting();
+	if (!bCountAllocations)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapPipelineBenchmark: the allocator keeps no call counts, allocations are n/a."));
+	}
+	NumFramesToRun = FMath::Max(NumFrames, 1);
+	if (!LoadFrames(NumFramesToRun, RecordingPath))
+	{
+		return false;
+	}
+
+	// devices fed from memory, registered with BodyState like any other device
+	FLeapBenchmarkWrapper SourceWrapper0(TEXT("Benchmark 0"));
+	FLeapBenchmarkWrapper SourceWrapper1(TEXT("Benchmark 1"));
+	FLeapBenchmarkWrapper ConfidenceWrapper(TEXT("Benchmark Confidence"));
+	FLeapBenchmarkWrapper AngularWrapper(TEXT("Benchmark Angular"));
+	FLeapBenchmarkWrapper* SourceWrappers[2] = {&SourceWrapper0, &SourceWrapper1};
+
+	TSharedPtr<FUltraleapDevice> Devices[2];
+	for (int32 Source = 0; Source < 2; ++Source)
+	{
+		SourceWrappers[Source]->CurrentFrame = GetFrame(Source, 0);
+		Devices[Source] = MakeShared<FUltraleapDevice>(
+			(IHandTrackingWrapper*) SourceWrappers[Source], (ITrackingDeviceWrapper*) SourceWrappers[Source]);
+		SourceWrappers[Source]->Device = Devices[Source].Get();
+	}
+	TArray<IHandTrackingWrapper*> DevicesToCombine = {SourceWrappers[0], SourceWrappers[1]};
+	TSharedPtr<FUltraleapCombinedDevice> Confidence =
+		MakeShared<FUltraleapCombinedDeviceConfidence>(&ConfidenceWrapper, &ConfidenceWrapper, DevicesToCombine);
+	TSharedPtr<FUltraleapCombinedDevice> Angular =
+		MakeShared<FUltraleapCombinedDeviceAngular>(&AngularWrapper, &AngularWrapper, DevicesToCombine);
+
+	const FLeapOptions DefaultOptions;
+	const FVector MountOffset = DefaultOptions.HMDPositionOffset;
+	const FQuat MountRotation = DefaultOptions.HMDRotationOffset.Quaternion();
+	const FRotator Rotation(10.0f, 20.0f, 30.0f);
+	const FVector Translation(1.0f, 2.0f, 3.0f);
+
+	FLeapFrameData Converted;
+	FLeapFramePose ConvertedPose;
+	TArray<FLeapFrameData> SourceFrames;
+	SourceFrames.SetNum(2);
+	TArray<FVector> InPoints;
+	TArray<FVector> RefPoints;
+	FKabschSolver Solver;
+
+	auto SetDeviceFrame = [&](const int32 Index) {
+		for (int32 Source = 0; Source < 2; ++Source)
+		{
+			SourceWrappers[Source]->CurrentFrame = GetFrame(Source, Index);
+			Devices[Source]->CurrentPose.SetFromLeapFrame(SourceWrappers[Source]->CurrentFrame, MountOffset, MountRotation);
+			Devices[Source]->OnCurrentPoseChanged();
+		}
+	};
+	auto SetSourceFrames = [&](const int32 Index) {
+		SetDeviceFrame(Index);
+		for (int32 Source = 0; Source < 2; ++Source)
+		{
+			Devices[Source]->GetLatestFrameData(SourceFrames[Source], true);
+		}
+	};
+
+	RunStage(
+		TEXT("FLeapFrameData::SetFromLeapFrame"), [&](int32 Index) {},
+		[&](int32 Index) { Converted.SetFromLeapFrame(GetFrame(0, Index), MountOffset, MountRotation); });
+
+	auto ConvertFrame = [&](int32 Index) { Converted.SetFromLeapFrame(GetFrame(0, Index), MountOffset, MountRotation); };
+	RunStage(TEXT("FLeapFrameData::RotateFrame"), ConvertFrame, [&](int32 Index) { Converted.RotateFrame(Rotation); });
+	RunStage(TEXT("FLeapFrameData::TranslateFrame"), ConvertFrame, [&](int32 Index) { Converted.TranslateFrame(Translation); });
+	RunStage(TEXT("FUltraleapCombinedDevice::TransformFrame"), ConvertFrame,
+		[&](int32 Index) { FUltraleapCombinedDevice::TransformFrame(Converted, Translation, Rotation); });
+
+	auto ConvertPose = [&](int32 Index) { ConvertedPose.SetFromLeapFrame(GetFrame(0, Index), MountOffset, MountRotation); };
+	RunStage(TEXT("FLeapFramePose::SetFromLeapFrame"), [&](int32 Index) {}, ConvertPose);
+	RunStage(TEXT("FLeapFramePose::Rotate"), ConvertPose, [&](int32 Index) { ConvertedPose.Rotate(Rotation.Quaternion()); });
+	RunStage(TEXT("FLeapFramePose::Translate"), ConvertPose, [&](int32 Index) { ConvertedPose.Translate(Translation); });
+	RunStage(TEXT("FLeapFramePose::Transform"), ConvertPose,
+		[&](int32 Index) { ConvertedPose.Transform(FTransform(Rotation, Translation)); });
+	RunStage(TEXT("FLeapFramePose::ToFrameData"), ConvertPose, [&](int32 Index) { ConvertedPose.ToFrameData(Converted); });
+
+	RunStage(TEXT("FUltraleapDevice::ParseEvents"), SetDeviceFrame, [&](int32 Index) { Devices[0]->ParseEvents(); });
+
+	UBodyStateSkeleton* Skeleton =
+		IBodyState::IsAvailable() ? IBodyState::Get().SkeletonForDevice(Devices[0]->GetBodyStateDeviceID()) : nullptr;
+	if (Skeleton)
+	{
+		RunStage(TEXT("FUltraleapDevice::UpdateInput"), SetDeviceFrame,
+			[&](int32 Index) { Devices[0]->UpdateInput(Devices[0]->GetBodyStateDeviceID(), Skeleton); });
+		RunStage(
+			TEXT("FBodyStateSkeletonStorage::UpdateMergeSkeletonData"),
+			[&](int32 Index) {
+				SetDeviceFrame(Index);
+				Devices[0]->UpdateInput(Devices[0]->GetBodyStateDeviceID(), Skeleton);
+			},
+			[&](int32 Index) { IBodyState::Get().UpdateMergedSkeleton(); });
+	}
+	else
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapPipelineBenchmark: BodyState unavailable, skipping BodyState stages."));
+	}
+
+	RunStage(TEXT("FUltraleapCombinedDeviceConfidence::CombineFrame"), SetSourceFrames,
+		[&](int32 Index) { Confidence->CombineFrame(SourceFrames); });
+	RunStage(TEXT("FUltraleapCombinedDeviceAngular::CombineFrame"), SetSourceFrames,
+		[&](int32 Index) { Angular->CombineFrame(SourceFrames); });
+
+	// sources build their snapshots as they capture, the combiner only borrows them
+	auto SetSourceSnapshots = [&](const int32 Index) {
+		SetDeviceFrame(Index);
+		for (int32 Source = 0; Source < 2; ++Source)
+		{
+			Devices[Source]->GetLatestFrameSnapshot();
+		}
+	};
+	RunStage(TEXT("FUltraleapCombinedDeviceConfidence::CaptureInput"), SetSourceSnapshots,
+		[&](int32 Index) { Confidence->CaptureInput(); });
+
+	RunStage(
+		TEXT("FKabschSolver::SolveKabsch"),
+		[&](int32 Index) {
+			SetSourceFrames(Index);
+			GetBoneCentres(SourceFrames[0], InPoints);
+			GetBoneCentres(SourceFrames[1], RefPoints);
+		},
+		[&](int32 Index) { Solver.SolveKabsch(InPoints, RefPoints); });
+
+	int32 NumInliers = 0;
+	RunStage(
+		TEXT("FKabschSolver::SolveKabschRobust"),
+		[&](int32 Index) {
+			SetSourceFrames(Index);
+			GetBoneCentres(SourceFrames[0], InPoints);
+			GetBoneCentres(SourceFrames[1], RefPoints);
+		},
+		[&](int32 Index) { Solver.SolveKabschRobust(InPoints, RefPoints, TArray<float>(), 2.0f, NumInliers); });
+
+	// combiners reference the source wrappers, release them first
+	Confidence.Reset();
+	Angular.Reset();
+	for (int32 Source = 0; Source < 2; ++Source)
+	{
+		SourceWrappers[Source]->Device = nullptr;
+		Devices[Source].Reset();
+	}
+	return true;
+}
+
+FString FLeapPipelineBenchmark::ToJson() const
+{
+	FString Json = FString::Printf(TEXT("{\n\t\"source\": \"%s\",\n\t\"frames\": %d,\n\t\"stages\": [\n"),
+		*FrameSource.ReplaceCharWithEscapedChar(), NumFramesToRun);
+	for (int32 Index = 0; Index < Results.Num(); ++Index)
+	{
+		const FStageResult& Result = Results[Index];
+		const FString Allocs = Result.bAllocsCounted ? FString::Printf(TEXT("%.2f"), Result.AllocsPerFrame) : TEXT("null");
+		Json += FString::Printf(TEXT("\t\t{\"name\": \"%s\", \"samples\": %d, \"mean_ns\": %.1f, \"p50_ns\": %.1f, \"p99_ns\": %.1f, ")
+								TEXT("\"p999_ns\": %.1f, \"max_ns\": %.1f, \"allocs_per_frame\": %s}%s\n"),
+			*Result.Name, Result.NumSamples, Result.MeanNs, Result.P50Ns, Result.P99Ns, Result.P999Ns, Result.MaxNs, *Allocs,
+			Index + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t]\n}\n");
+	return Json;
+}
+
+void FLeapPipelineBenchmark::LogResults() const
+{
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Leap pipeline benchmark, %d %s frames:"), NumFramesToRun, *FrameSource);
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("%-52s %10s %10s %10s %10s %8s"), TEXT("Stage"), TEXT("mean ns"), TEXT("p50"),
+		TEXT("p99"), TEXT("p999"), TEXT("allocs"));
+	for (const FStageResult& Result : Results)
+	{
+		const FString Allocs = Result.bAllocsCounted ? FString::Printf(TEXT("%.2f"), Result.AllocsPerFrame) : TEXT("n/a");
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("%-52s %10.0f %10.0f %10.0f %10.0f %8s"), *Result.Name, Result.MeanNs,
+			Result.P50Ns, Result.P99Ns, Result.P999Ns, *Allocs);
+	}
+}
+
+static FAutoConsoleCommand LeapBenchmarkCommand(TEXT("leap.Benchmark"),
+	TEXT("Benchmarks the tracking pipeline stages. Usage: leap.Benchmark [Frames=N] [Recording=Path] [Output=Path]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 NumFrames = 10000;
+		FString RecordingPath;
+		FString OutputPath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("LeapBenchmark.json"));
+		FParse::Value(*Params, TEXT("Frames="), NumFrames);
+		FParse::Value(*Params, TEXT("Recording="), RecordingPath);
+		FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+		FLeapPipelineBenchmark Benchmark;
+		if (!Benchmark.Run(NumFrames, RecordingPath))
+		{
+			return;
+		}
+		Benchmark.LogResults();
+		if (FFileHelper::SaveStringToFile(Benchmark.ToJson(), *OutputPath))
+		{
+			UE_LOG(UltraleapTrackingLog, Log, TEXT("Leap pipeline benchmark written to %s"), *OutputPath);
+		}
+	}));
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+/**
+ * Headless benchmark of the tracking pipeline. Drives synthetic (or recorded) frames through each
+ * processing stage in isolation and reports ns/frame, allocations/frame and p50/p99/p999 per stage.
+ * No service or device is needed, the devices are fed from memory.
+ *
+ * Console: leap.Benchmark [Frames=N] [Recording=Path] [Output=Path]
+ * Results are logged and written as JSON (default Saved/Profiling/LeapBenchmark.json).
+ */
+class FLeapPipelineBenchmark
+{
+public:
+	struct FStageResult
+	{
+		FString Name;
+		int32 NumSamples = 0;
+		double MeanNs = 0;
+		double P50Ns = 0;
+		double P99Ns = 0;
+		double P999Ns = 0;
+		double MaxNs = 0;
+		double AllocsPerFrame = 0;
+		// false when the allocator doesn't keep call counts, AllocsPerFrame is then meaningless and reported as n/a
+		bool bAllocsCounted = false;
+	};
+
+	/** Loads NumFrames frames from RecordingPath, or generates synthetic ones when empty */
+	bool Run(const int32 NumFrames, const FString& RecordingPath = FString());
+
+	const TArray<FStageResult>& GetResults() const
+	{
+		return Results;
+	}
+	FString ToJson() const;
+	void LogResults() const;
+
+private:
+	bool LoadFrames(const int32 NumFrames, const FString& RecordingPath);
+	void RunStage(const TCHAR* Name, TFunctionRef<void(int32)> Prepare, TFunctionRef<void(int32)> Stage);
+
+	LEAP_TRACKING_EVENT* GetFrame(const int32 Source, const int32 Index)
+	{
+		return (LEAP_TRACKING_EVENT*) Frames[Source][Index % Frames[Source].Num()].GetData();
+	}
+
+	// per source device, each buffer is an event followed by its hands
+	TArray<TArray<uint8>> Frames[2];
+	int32 NumFramesToRun = 0;
+	bool bCountAllocations = false;
+	FString FrameSource;
+
+	TArray<uint64> Samples;
+	TArray<FStageResult> Results;
+
+	static const int32 WarmupFrames = 64;
+};
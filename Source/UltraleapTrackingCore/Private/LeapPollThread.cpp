@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPollThread.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "LeapUtility.h"
+
+DECLARE_STATS_GROUP(TEXT("UltraleapPollThread"), STATGROUP_UltraleapPollThread, STATCAT_Advanced);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Leap Event Age On Arrival (ms)"), STAT_LeapPollEventAge, STATGROUP_UltraleapPollThread);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Leap Max Event Age On Arrival (ms)"), STAT_LeapPollMaxEventAge, STATGROUP_UltraleapPollThread);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leap Poll Timeout (ms)"), STAT_LeapPollTimeout, STATGROUP_UltraleapPollThread);
+
+static TAutoConsoleVariable<int32> CVarLeapPollThreadPriority(TEXT("leap.PollThreadPriority"), 2,
+	TEXT("Priority of the LeapC poll thread: 0 normal, 1 above normal, 2 highest, 3 time critical. Read when the connection is opened."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarLeapPollThreadAffinity(TEXT("leap.PollThreadAffinity"), 0,
+	TEXT("Core affinity mask for the LeapC poll thread, 0 for no affinity. Read when the connection is opened."),
+	ECVF_Default);
+
+namespace
+{
+EThreadPriority PollThreadPriority()
+{
+	switch (CVarLeapPollThreadPriority.GetValueOnAnyThread())
+	{
+		case 0:
+			return TPri_Normal;
+		case 1:
+			return TPri_AboveNormal;
+		case 3:
+			return TPri_TimeCritical;
+		default:
+			return TPri_Highest;
+	}
+}
+
+uint64 PollThreadAffinity()
+{
+	const int32 Mask = CVarLeapPollThreadAffinity.GetValueOnAnyThread();
+	return Mask != 0 ? (uint64) (uint32) Mask : FPlatformAffinity::GetNoAffinityMask();
+}
+
+// Weight of the newest sample in the smoothed values
+const double SmoothingFactor = 0.1;
+const double MaxEventAgeWindowSeconds = 1.0;
+}	 // namespace
+
+FLeapPollThread::FLeapPollThread(LEAP_CONNECTION ConnectionIn, FDispatchFunction DispatchIn, TFunction<void()> OnStoppedIn)
+	: Connection(ConnectionIn)
+	, Dispatch(MoveTemp(DispatchIn))
+	, OnStopped(MoveTemp(OnStoppedIn))
+	, Thread(nullptr)
+	, bStopRequested(false)
+	, PollTimeoutMs(MaxPollTimeoutMs)
+	, LastMessageTime(0)
+	, AverageMessageInterval(0)
+	, AverageEventAgeMs(0)
+	, MaxEventAgeMs(0)
+	, SampledMaxEventAgeMs(0)
+	, MaxEventAgeWindowStart(0)
+{
+}
+
+FLeapPollThread::~FLeapPollThread()
+{
+	StopAndWait();
+}
+
+bool FLeapPollThread::Start()
+{
+	if (Thread)
+	{
+		return true;
+	}
+	static int32 ThreadCount = 0;
+	const FString ThreadName = FString::Printf(TEXT("LeapPollThread%d"), ThreadCount++);
+
+	bStopRequested = false;
+	Thread = FRunnableThread::Create(this, *ThreadName, 0, PollThreadPriority(), PollThreadAffinity());
+	if (!Thread)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapPollThread failed to create %s."), *ThreadName);
+		return false;
+	}
+	return true;
+}
+
+void FLeapPollThread::StopAndWait()
+{
+	if (!Thread)
+	{
+		return;
+	}
+	// Kill(true) calls Stop() and joins
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+}
+
+void FLeapPollThread::Stop()
+{
+	bStopRequested = true;
+}
+
+uint32 FLeapPollThread::Run()
+{
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop started."));
+
+	LEAP_CONNECTION_MESSAGE Msg;
+	while (!bStopRequested)
+	{
+		const eLeapRS Result = LeapPollConnection(Connection, PollTimeoutMs, &Msg);
+
+		// Polling may have taken some time, re-check exit condition
+		if (bStopRequested)
+		{
+			break;
+		}
+		const double Now = FPlatformTime::Seconds();
+		UpdatePollTimeout(Result, Now);
+
+		if (Result != eLeapRS_Success)
+		{
+			// Timeouts are expected when nothing is streaming, anything else is usually a missing service
+			if (Result != eLeapRS_Timeout)
+			{
+				FPlatformProcess::Sleep(0.1f);
+			}
+			continue;
+		}
+		if (Msg.type == eLeapEventType_Tracking)
+		{
+			RecordEventAge(Msg.tracking_event, Now);
+		}
+		Dispatch(Msg);
+	}
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop stopped."));
+	if (OnStopped)
+	{
+		OnStopped();
+	}
+	return 0;
+}
+
+void FLeapPollThread::UpdatePollTimeout(const eLeapRS Result, const double Now)
+{
+	if (Result == eLeapRS_Success)
+	{
+		if (LastMessageTime > 0)
+		{
+			const double Interval = Now - LastMessageTime;
+			AverageMessageInterval = AverageMessageInterval > 0
+										 ? FMath::Lerp(AverageMessageInterval, Interval, SmoothingFactor)
+										 : Interval;
+		}
+		LastMessageTime = Now;
+
+		// two intervals of headroom so jitter doesn't turn into spurious timeouts
+		const uint32 Target = (uint32) (AverageMessageInterval * 2000.0);
+		PollTimeoutMs = FMath::Clamp(Target, MinPollTimeoutMs, MaxPollTimeoutMs);
+	}
+	else
+	{
+		// quiet connection, back off. The estimate only decays towards the gap, one idle poll doesn't throw away
+		// what the stream has taught it
+		if (AverageMessageInterval > 0)
+		{
+			AverageMessageInterval = FMath::Lerp(AverageMessageInterval, PollTimeoutMs / 1000.0, SmoothingFactor);
+			// the gap so far is in the estimate now, the next message is measured from here
+			LastMessageTime = Now;
+		}
+		PollTimeoutMs = FMath::Min(PollTimeoutMs * 2, MaxPollTimeoutMs);
+	}
+	SET_DWORD_STAT(STAT_LeapPollTimeout, PollTimeoutMs);
+}
+
+void FLeapPollThread::RecordEventAge(const LEAP_TRACKING_EVENT* TrackingEvent, const double Now)
+{
+	if (!TrackingEvent)
+	{
+		return;
+	}
+	const float AgeMs = (LeapGetNow() - TrackingEvent->info.timestamp) / 1000.f;
+	AverageEventAgeMs = AverageEventAgeMs > 0 ? FMath::Lerp(AverageEventAgeMs, AgeMs, (float) SmoothingFactor) : AgeMs;
+	MaxEventAgeMs = FMath::Max(MaxEventAgeMs, AgeMs);
+	SET_FLOAT_STAT(STAT_LeapPollEventAge, AgeMs);
+
+	if (Now - MaxEventAgeWindowStart >= MaxEventAgeWindowSeconds)
+	{
+		SampledMaxEventAgeMs = MaxEventAgeMs;
+		SET_FLOAT_STAT(STAT_LeapPollMaxEventAge, MaxEventAgeMs);
+		MaxEventAgeMs = 0;
+		MaxEventAgeWindowStart = Now;
+	}
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "LeapC.h"
+
+class FRunnableThread;
+
+/**
+ * Named, explicitly scheduled thread that services one LeapC connection with LeapPollConnection.
+ * Priority and core affinity come from leap.PollThreadPriority / leap.PollThreadAffinity when the thread starts.
+ * The poll timeout adapts to the event rate: while events stream it stays a couple of intervals long so a stop
+ * request is noticed quickly, when the connection goes quiet it backs off to MaxPollTimeoutMs.
+ * Every tracking event's age on arrival (LeapGetNow - frame timestamp) is tracked so a starved thread shows up in stats.
+ */
+class FLeapPollThread : public FRunnable
+{
+public:
+	typedef TFunction<void(const LEAP_CONNECTION_MESSAGE& Msg)> FDispatchFunction;
+
+	static const uint32 MinPollTimeoutMs = 2;
+	static const uint32 MaxPollTimeoutMs = 200;
+
+	/** Dispatch runs on the poll thread for every message, OnStopped runs on it once after the last poll */
+	FLeapPollThread(LEAP_CONNECTION ConnectionIn, FDispatchFunction DispatchIn, TFunction<void()> OnStoppedIn);
+	virtual ~FLeapPollThread();
+
+	bool Start();
+	/** Requests the loop to end and blocks until it has, at most one poll timeout */
+	void StopAndWait();
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// End of FRunnable
+
+	// Written by the poll thread, approximate when read elsewhere
+	float GetAverageEventAgeMs() const
+	{
+		return AverageEventAgeMs;
+	}
+	/** Worst age over the last complete sample window, not since startup */
+	float GetMaxEventAgeMs() const
+	{
+		return SampledMaxEventAgeMs;
+	}
+	uint32 GetPollTimeoutMs() const
+	{
+		return PollTimeoutMs;
+	}
+
+private:
+	void UpdatePollTimeout(const eLeapRS Result, const double Now);
+	void RecordEventAge(const LEAP_TRACKING_EVENT* TrackingEvent, const double Now);
+
+	LEAP_CONNECTION Connection;
+	FDispatchFunction Dispatch;
+	TFunction<void()> OnStopped;
+
+	FRunnableThread* Thread;
+	FThreadSafeBool bStopRequested;
+
+	uint32 PollTimeoutMs;
+	double LastMessageTime;
+	// smoothed interval between messages in seconds
+	double AverageMessageInterval;
+
+	float AverageEventAgeMs;
+	// worst age in the current window, published and reset every MaxEventAgeWindowSeconds
+	float MaxEventAgeMs;
+	float SampledMaxEventAgeMs;
+	double MaxEventAgeWindowStart;
+};
@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPooledAllocator.h"
+
+#include "HAL/IConsoleManager.h"
+#include "LeapUtility.h"
+
+DECLARE_STATS_GROUP(TEXT("UltraleapAllocator"), STATGROUP_UltraleapAllocator, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leap Pooled Blocks In Use"), STAT_LeapPooledBlocksInUse, STATGROUP_UltraleapAllocator);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leap Pooled Blocks High Water"), STAT_LeapPooledBlocksHighWater, STATGROUP_UltraleapAllocator);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leap Oversize Blocks In Use"), STAT_LeapOversizeBlocksInUse, STATGROUP_UltraleapAllocator);
+
+static TAutoConsoleVariable<int32> CVarLeapUsePooledAllocator(TEXT("leap.UsePooledAllocator"), 0,
+	TEXT("If non zero, LeapC buffers are allocated from plugin owned pools. Read when the connection is opened."),
+	ECVF_ReadOnly);
+
+namespace
+{
+// Header in front of every block, keeps the payload 16 byte aligned
+struct FBlockHeader
+{
+	int32 PoolIndex;
+	uint32 Size;
+	uint64 Padding;
+};
+static_assert(sizeof(FBlockHeader) == 16, "Block header must preserve 16 byte alignment");
+
+const int32 OversizePoolIndex = -1;
+
+int32 GetPoolIndex(const uint32 Size)
+{
+	const uint32 Shift = FMath::Max<uint32>(FMath::CeilLogTwo(Size), FLeapPooledAllocator::MinSizeShift);
+	if (Shift > FLeapPooledAllocator::MaxSizeShift)
+	{
+		return OversizePoolIndex;
+	}
+	return Shift - FLeapPooledAllocator::MinSizeShift;
+}
+}	 // namespace
+
+FLeapPooledAllocator::FLeapPooledAllocator() : PooledHighWaterMark(0), OversizeHighWaterMark(0)
+{
+	LeapAllocator.allocate = &FLeapPooledAllocator::LeapAllocate;
+	LeapAllocator.deallocate = &FLeapPooledAllocator::LeapDeallocate;
+	LeapAllocator.state = this;
+}
+
+FLeapPooledAllocator::~FLeapPooledAllocator()
+{
+	LogStats();
+
+	for (FPool& Pool : Pools)
+	{
+		while (void* Block = Pool.FreeBlocks.Pop())
+		{
+			FMemory::Free(Block);
+		}
+	}
+}
+
+bool FLeapPooledAllocator::IsEnabled()
+{
+	return CVarLeapUsePooledAllocator.GetValueOnAnyThread() != 0;
+}
+
+bool FLeapPooledAllocator::Register(LEAP_CONNECTION Connection)
+{
+	eLeapRS Result = LeapSetAllocator(Connection, &LeapAllocator);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapSetAllocator failed in FLeapPooledAllocator::Register."));
+		return false;
+	}
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapC using pooled allocator."));
+	return true;
+}
+
+void* FLeapPooledAllocator::Allocate(uint32 Size)
+{
+	const int32 PoolIndex = GetPoolIndex(Size + sizeof(FBlockHeader));
+	FBlockHeader* Header = nullptr;
+
+	if (PoolIndex == OversizePoolIndex)
+	{
+		Header = (FBlockHeader*) FMemory::Malloc(Size + sizeof(FBlockHeader), 16);
+		UpdateHighWaterMark(OversizeHighWaterMark, OversizeInUse.Increment());
+		INC_DWORD_STAT(STAT_LeapOversizeBlocksInUse);
+	}
+	else
+	{
+		FPool& Pool = Pools[PoolIndex];
+		Header = (FBlockHeader*) Pool.FreeBlocks.Pop();
+		if (Header)
+		{
+			Pool.NumFree.Decrement();
+		}
+		else
+		{
+			Header = (FBlockHeader*) FMemory::Malloc(1ull << (PoolIndex + MinSizeShift), 16);
+		}
+		UpdateHighWaterMark(Pool.HighWaterMark, Pool.InUse.Increment());
+		if (UpdateHighWaterMark(PooledHighWaterMark, PooledInUse.Increment()))
+		{
+			SET_DWORD_STAT(STAT_LeapPooledBlocksHighWater, PooledHighWaterMark);
+		}
+		INC_DWORD_STAT(STAT_LeapPooledBlocksInUse);
+	}
+
+	Header->PoolIndex = PoolIndex;
+	Header->Size = Size;
+	return Header + 1;
+}
+
+void FLeapPooledAllocator::Deallocate(void* Ptr)
+{
+	if (!Ptr)
+	{
+		return;
+	}
+	FBlockHeader* Header = ((FBlockHeader*) Ptr) - 1;
+
+	if (Header->PoolIndex == OversizePoolIndex)
+	{
+		OversizeInUse.Decrement();
+		DEC_DWORD_STAT(STAT_LeapOversizeBlocksInUse);
+		FMemory::Free(Header);
+		return;
+	}
+
+	FPool& Pool = Pools[Header->PoolIndex];
+	Pool.InUse.Decrement();
+	PooledInUse.Decrement();
+	DEC_DWORD_STAT(STAT_LeapPooledBlocksInUse);
+
+	if (Pool.NumFree.Increment() <= MaxFreeBlocksPerPool)
+	{
+		Pool.FreeBlocks.Push(Header);
+	}
+	else
+	{
+		Pool.NumFree.Decrement();
+		FMemory::Free(Header);
+	}
+}
+
+bool FLeapPooledAllocator::UpdateHighWaterMark(volatile int32& HighWaterMark, const int32 Value)
+{
+	int32 Current = HighWaterMark;
+	while (Value > Current)
+	{
+		const int32 Previous = FPlatformAtomics::InterlockedCompareExchange(&HighWaterMark, Value, Current);
+		if (Previous == Current)
+		{
+			return true;
+		}
+		Current = Previous;
+	}
+	return false;
+}
+
+void FLeapPooledAllocator::GetPoolStats(TArray<FPoolStats>& OutStats) const
+{
+	OutStats.SetNum(NumPools);
+	for (int32 PoolIndex = 0; PoolIndex < NumPools; ++PoolIndex)
+	{
+		OutStats[PoolIndex].BlockSize = 1u << (PoolIndex + MinSizeShift);
+		OutStats[PoolIndex].InUse = Pools[PoolIndex].InUse.GetValue();
+		OutStats[PoolIndex].HighWaterMark = Pools[PoolIndex].HighWaterMark;
+	}
+}
+
+void FLeapPooledAllocator::LogStats() const
+{
+	TArray<FPoolStats> Stats;
+	GetPoolStats(Stats);
+	for (const FPoolStats& PoolStats : Stats)
+	{
+		if (PoolStats.HighWaterMark > 0)
+		{
+			UE_LOG(UltraleapTrackingLog, Log, TEXT("Leap pool %u bytes: high water %d blocks, %d in use"), PoolStats.BlockSize,
+				PoolStats.HighWaterMark, PoolStats.InUse);
+		}
+	}
+	if (OversizeHighWaterMark > 0)
+	{
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("Leap oversize allocations: high water %d blocks"), OversizeHighWaterMark);
+	}
+}
+
+void* FLeapPooledAllocator::LeapAllocate(uint32_t Size, eLeapAllocatorType TypeHint, void* State)
+{
+	return ((FLeapPooledAllocator*) State)->Allocate(Size);
+}
+
+void FLeapPooledAllocator::LeapDeallocate(void* Ptr, void* State)
+{
+	((FLeapPooledAllocator*) State)->Deallocate(Ptr);
+}
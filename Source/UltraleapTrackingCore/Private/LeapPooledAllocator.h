@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Containers/LockFreeList.h"
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "LeapC.h"
+
+/**
+ * Size class pooled allocator handed to LeapC through LeapSetAllocator.
+ * Blocks are rounded up to a power of two and recycled through lock free free lists,
+ * so LeapC's per event buffers (mainly images) stop hitting the general heap.
+ * Requests larger than the biggest size class fall through to FMemory.
+ * Must outlive the connection it was registered with.
+ */
+class FLeapPooledAllocator
+{
+public:
+	/** Smallest size class is 2^MinSizeShift bytes, largest is 2^MaxSizeShift */
+	static const int32 MinSizeShift = 8;
+	static const int32 MaxSizeShift = 22;
+	static const int32 NumPools = MaxSizeShift - MinSizeShift + 1;
+	/** Free blocks retained per size class, anything beyond this goes back to the heap */
+	static const int32 MaxFreeBlocksPerPool = 16;
+
+	struct FPoolStats
+	{
+		uint32 BlockSize = 0;
+		int32 InUse = 0;
+		int32 HighWaterMark = 0;
+	};
+
+	FLeapPooledAllocator();
+	~FLeapPooledAllocator();
+
+	/** Registers this allocator with the connection, returns false if LeapC refused it */
+	bool Register(LEAP_CONNECTION Connection);
+
+	void GetPoolStats(TArray<FPoolStats>& OutStats) const;
+	int32 GetOversizeHighWaterMark() const
+	{
+		return OversizeHighWaterMark;
+	}
+	void LogStats() const;
+
+	/** Enabled with leap.UsePooledAllocator=1 (read only, set from ini or command line) */
+	static bool IsEnabled();
+
+private:
+	struct FPool
+	{
+		TLockFreePointerListUnordered<void, PLATFORM_CACHE_LINE_SIZE> FreeBlocks;
+		FThreadSafeCounter NumFree;
+		FThreadSafeCounter InUse;
+		volatile int32 HighWaterMark = 0;
+	};
+
+	void* Allocate(uint32 Size);
+	void Deallocate(void* Ptr);
+	/** True when Value raised the mark */
+	static bool UpdateHighWaterMark(volatile int32& HighWaterMark, const int32 Value);
+
+	static void* LeapAllocate(uint32_t Size, eLeapAllocatorType TypeHint, void* State);
+	static void LeapDeallocate(void* Ptr, void* State);
+
+	FPool Pools[NumPools];
+
+	// all pools together, backs the high water stat
+	FThreadSafeCounter PooledInUse;
+	volatile int32 PooledHighWaterMark;
+
+	FThreadSafeCounter OversizeInUse;
+	volatile int32 OversizeHighWaterMark;
+
+	LEAP_ALLOCATOR LeapAllocator;
+};
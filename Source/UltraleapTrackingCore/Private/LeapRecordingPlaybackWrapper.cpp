@@ -0,0 +1,284 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapRecordingPlaybackWrapper.h"
+#include "FUltraleapDevice.h"
+#include "HAL/IConsoleManager.h"
+#include "IUltraleapTrackingPlugin.h"
+#include "LeapUtility.h"
+#include "Misc/Paths.h"
+
+#pragma region Leap Recording Playback Wrapper
+
+FLeapRecordingPlaybackWrapper::FLeapRecordingPlaybackWrapper(const FString& FilePathIn, const float PlaybackSpeedIn, const bool bLoopIn)
+	: FilePath(FilePathIn), PlaybackSpeed(PlaybackSpeedIn), bLoop(bLoopIn), Predictor(ILeapFramePredictor::Create())
+{
+	static int32 RecordingDeviceID = RecordingBaseDeviceID;
+
+	RecordingDeviceID++;
+	DeviceID = RecordingDeviceID;
+
+	DeviceSerial = FString::Printf(TEXT("Recording %d %s"), DeviceID - RecordingBaseDeviceID, *FPaths::GetCleanFilename(FilePath));
+	FTCHARToUTF8 SerialUTF8(*DeviceSerial);
+	SerialBuffer.SetNumZeroed(SerialUTF8.Length() + 1);
+	FMemory::Memcpy(SerialBuffer.GetData(), SerialUTF8.Get(), SerialUTF8.Length());
+
+	DummyDeviceInfo = {0};
+	DummyDeviceInfo.size = sizeof(LEAP_DEVICE_INFO);
+	DummyDeviceInfo.pid = eLeapDevicePID_Unknown;
+	DummyDeviceInfo.serial = SerialBuffer.GetData();
+	DummyDeviceInfo.serial_length = SerialBuffer.Num();
+	CurrentDeviceInfo = &DummyDeviceInfo;
+
+	bIsConnected = OpenRecording();
+
+	Device = MakeShared<FUltraleapDevice>((IHandTrackingWrapper*) this, (ITrackingDeviceWrapper*) this);
+}
+
+FLeapRecordingPlaybackWrapper::~FLeapRecordingPlaybackWrapper()
+{
+	CloseRecording();
+	CallbackDelegate = nullptr;
+}
+
+LEAP_CONNECTION* FLeapRecordingPlaybackWrapper::OpenConnection(
+	LeapWrapperCallbackInterface* InCallbackDelegate, bool UseMultiDeviceMode)
+{
+	if (InCallbackDelegate != nullptr)
+	{
+		CallbackDelegate = InCallbackDelegate;
+	}
+	return nullptr;
+}
+
+void FLeapRecordingPlaybackWrapper::CloseConnection()
+{
+	if (!bIsConnected)
+	{
+		return;
+	}
+	bIsConnected = false;
+	CloseRecording();
+	CallbackDelegate = nullptr;
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("FLeapRecordingPlaybackWrapper closed %s after %lld frames."), *FilePath, NumFramesPlayed);
+}
+
+bool FLeapRecordingPlaybackWrapper::OpenRecording()
+{
+	LEAP_RECORDING_PARAMETERS Params;
+	Params.mode = eLeapRecordingFlags_Reading;
+
+	eLeapRS Result = LeapRecordingOpen(&Recording, TCHAR_TO_UTF8(*FilePath), Params);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapRecordingOpen failed for %s, result %d."), *FilePath, (int32) Result);
+		Recording = nullptr;
+		return false;
+	}
+
+	LEAP_RECORDING_STATUS Status;
+	Result = LeapRecordingGetStatus(Recording, &Status);
+	if (Result != eLeapRS_Success || !(Status.mode & eLeapRecordingFlags_Reading))
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Recording %s is not readable."), *FilePath);
+		CloseRecording();
+		return false;
+	}
+
+	// prime the pending frame so the first GetFrame() has something to show
+	if (!ReadNextFrame())
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Recording %s contains no frames."), *FilePath);
+		CloseRecording();
+		return false;
+	}
+	// unshifted, as stored in the file
+	FirstTimestamp = PendingFrame->info.timestamp - LoopTimestampOffset;
+	if (NumFramesPlayed == 0)
+	{
+		ClockOriginTimestamp = FirstTimestamp;
+		ClockOriginSeconds = FPlatformTime::Seconds();
+	}
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("FLeapRecordingPlaybackWrapper playing %s at speed %f."), *FilePath, PlaybackSpeed);
+	return true;
+}
+
+void FLeapRecordingPlaybackWrapper::CloseRecording()
+{
+	if (Recording)
+	{
+		LeapRecordingClose(&Recording);
+		Recording = nullptr;
+	}
+	PendingFrame = nullptr;
+}
+
+bool FLeapRecordingPlaybackWrapper::ReadNextFrame()
+{
+	PendingFrame = nullptr;
+	if (!Recording)
+	{
+		return false;
+	}
+
+	uint64_t FrameSize = 0;
+	eLeapRS Result = LeapRecordingReadSize(Recording, &FrameSize);
+	if (Result != eLeapRS_Success || FrameSize == 0)
+	{
+		return false;
+	}
+
+	TArray<uint8>& Buffer = FrameBuffers[1 - CurrentBufferIndex];
+	if ((uint64) Buffer.Num() < FrameSize)
+	{
+		Buffer.SetNumUninitialized(FrameSize);
+	}
+	LEAP_TRACKING_EVENT* Frame = (LEAP_TRACKING_EVENT*) Buffer.GetData();
+
+	Result = LeapRecordingRead(Recording, Frame, FrameSize);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapRecordingRead failed in FLeapRecordingPlaybackWrapper::ReadNextFrame."));
+		return false;
+	}
+
+	Frame->info.timestamp += LoopTimestampOffset;
+	PendingFrame = Frame;
+	return true;
+}
+
+bool FLeapRecordingPlaybackWrapper::AdvanceFrame()
+{
+	if (!PendingFrame && bLoop && !bHasFinished)
+	{
+		// restart, shifting timestamps by the recording length plus one frame
+		const int64 FrameInterval = CurrentFrame && CurrentFrame->framerate > 0 ? (int64)(1000000.0f / CurrentFrame->framerate) : 0;
+		LoopTimestampOffset = LastTimestamp + FrameInterval - FirstTimestamp;
+		CloseRecording();
+		if (!OpenRecording())
+		{
+			bHasFinished = true;
+		}
+	}
+	if (!PendingFrame)
+	{
+		bHasFinished = true;
+		return false;
+	}
+
+	CurrentBufferIndex = 1 - CurrentBufferIndex;
+	CurrentFrame = PendingFrame;
+	LastTimestamp = CurrentFrame->info.timestamp;
+	NumFramesPlayed++;
+	Predictor->Observe(CurrentFrame);
+
+	ReadNextFrame();
+	return true;
+}
+
+LEAP_TRACKING_EVENT* FLeapRecordingPlaybackWrapper::GetFrame()
+{
+	if (!bIsConnected)
+	{
+		return CurrentFrame;
+	}
+
+	if (PlaybackSpeed <= 0)
+	{
+		// as fast as possible, one frame per engine frame, the device and the combiners can all ask in the same tick
+		if (LastAdvanceFrameCounter != GFrameCounter)
+		{
+			LastAdvanceFrameCounter = GFrameCounter;
+			AdvanceFrame();
+		}
+		return CurrentFrame;
+	}
+
+	// catch up with the playback clock, dropping frames if the game ticks slower than the recording
+	const int64 Now = GetNow();
+	while (!bHasFinished)
+	{
+		if (PendingFrame && PendingFrame->info.timestamp > Now)
+		{
+			break;
+		}
+		if (!AdvanceFrame())
+		{
+			break;
+		}
+	}
+	return CurrentFrame;
+}
+
+LEAP_TRACKING_EVENT* FLeapRecordingPlaybackWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+{
+	LEAP_TRACKING_EVENT* Frame = Predictor->Predict(TimeStamp, InterpolatedFingerFrame);
+	return Frame ? Frame : CurrentFrame;
+}
+
+bool FLeapRecordingPlaybackWrapper::GetInterpolatedFramesAtTimes(
+	int64 FingerTimeStamp, int64 HandTimeStamp, LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame)
+{
+	OutFingerFrame = Predictor->Predict(FingerTimeStamp, InterpolatedFingerFrame);
+	OutHandFrame = Predictor->Predict(HandTimeStamp, InterpolatedHandFrame);
+	if (!OutFingerFrame || !OutHandFrame)
+	{
+		OutFingerFrame = CurrentFrame;
+		OutHandFrame = CurrentFrame;
+	}
+	return OutHandFrame != nullptr;
+}
+
+LEAP_DEVICE_INFO* FLeapRecordingPlaybackWrapper::GetDeviceProperties()
+{
+	return CurrentDeviceInfo;
+}
+
+int64_t FLeapRecordingPlaybackWrapper::GetNow()
+{
+	if (PlaybackSpeed <= 0)
+	{
+		return LastTimestamp;
+	}
+	const double Elapsed = FPlatformTime::Seconds() - ClockOriginSeconds;
+	return ClockOriginTimestamp + (int64)(Elapsed * 1000000.0 * PlaybackSpeed);
+}
+
+void FLeapRecordingPlaybackWrapper::SetTrackingMode(eLeapTrackingMode TrackingMode)
+{
+	// recordings have a fixed mode, echo it back so BP delegates still fire
+	if (CallbackDelegate)
+	{
+		CallbackDelegate->OnTrackingMode(TrackingMode);
+	}
+}
+
+IHandTrackingDevice* FLeapRecordingPlaybackWrapper::GetDevice()
+{
+	return Device.Get();
+}
+
+static FAutoConsoleCommand LeapPlayRecordingCommand(TEXT("leap.PlayRecording"),
+	TEXT("Adds a device that plays back a LeapC recording. Usage: leap.PlayRecording <Path> [Speed, 0 = as fast as possible] [Loop 0/1]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		if (Args.Num() < 1 || !IUltraleapTrackingPlugin::IsAvailable())
+		{
+			return;
+		}
+		ILeapConnector* Connector = IUltraleapTrackingPlugin::Get().GetConnector();
+		if (!Connector)
+		{
+			return;
+		}
+		const float Speed = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 1.0f;
+		const bool bLoop = Args.Num() > 2 ? FCString::ToBool(*Args[2]) : false;
+		Connector->AddRecordingDevice(Args[0], Speed, bLoop);
+	}));
+
+#pragma endregion Leap Recording Playback Wrapper
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapFrameHistory.h"
+#include "LeapFramePredictor.h"
+#include "LeapWrapper.h"
+
+/**
+ * Plays back a LeapC recording (.lmt) as if it were a live device, using the LeapRecording API.
+ * PlaybackSpeed 1 is real time, N plays at N times speed and 0 (or less) advances exactly
+ * one recorded frame per engine frame, however many times GetFrame() is called in it, which gives
+ * deterministic as fast as possible playback.
+ */
+class FLeapRecordingPlaybackWrapper : public FLeapWrapperBase
+{
+public:
+	FLeapRecordingPlaybackWrapper(const FString& FilePathIn, const float PlaybackSpeedIn, const bool bLoopIn);
+	virtual ~FLeapRecordingPlaybackWrapper();
+
+	// FLeapWrapperBase overrides
+	virtual LEAP_CONNECTION* OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate, bool UseMultiDeviceMode) override;
+	virtual void CloseConnection() override;
+	virtual LEAP_TRACKING_EVENT* GetFrame() override;
+	/** Predicted from the frames played so far, the current playback frame if they don't cover TimeStamp.
+	 * Never advances playback */
+	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override;
+	virtual bool GetInterpolatedFramesAtTimes(int64 FingerTimeStamp, int64 HandTimeStamp,
+		LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame) override;
+	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override;
+	/** Playback clock in the recording's time base */
+	virtual int64_t GetNow() override;
+	virtual void SetTrackingMode(eLeapTrackingMode TrackingMode) override;
+	virtual uint32_t GetDeviceID() override
+	{
+		return DeviceID;
+	}
+	virtual FString GetDeviceSerial() override
+	{
+		return DeviceSerial;
+	}
+	virtual EDeviceType GetDeviceType() override
+	{
+		return DEVICE_TYPE_RECORDING;
+	}
+	virtual IHandTrackingDevice* GetDevice() override;
+
+	bool HasFinished() const
+	{
+		return bHasFinished;
+	}
+	int64 GetNumFramesPlayed() const
+	{
+		return NumFramesPlayed;
+	}
+	/** In recording time, see GetNow() */
+	virtual const FLeapFrameHistory* GetFrameHistory() override
+	{
+		return &Predictor->GetFrameHistory();
+	}
+
+private:
+	bool OpenRecording();
+	void CloseRecording();
+	/** Reads the next recorded frame into the pending buffer, returns false at the end of the recording */
+	bool ReadNextFrame();
+	/** Makes the pending frame current and reads ahead, handles looping */
+	bool AdvanceFrame();
+
+	FString FilePath;
+	float PlaybackSpeed;
+	bool bLoop;
+	bool bHasFinished = false;
+
+	LEAP_RECORDING Recording = nullptr;
+
+	// Current and pending frames, buffers only ever grow so pHands stays valid
+	TArray<uint8> FrameBuffers[2];
+	int32 CurrentBufferIndex = 0;
+	LEAP_TRACKING_EVENT* CurrentFrame = nullptr;
+	LEAP_TRACKING_EVENT* PendingFrame = nullptr;
+
+	// Frames played so far, timestamps already include LoopTimestampOffset so looping keeps them increasing
+	TUniquePtr<ILeapFramePredictor> Predictor;
+	FLeapFrameHistory::FFrame InterpolatedFingerFrame;
+	FLeapFrameHistory::FFrame InterpolatedHandFrame;
+
+	// Timestamps are shifted on every loop so time keeps moving forwards
+	int64 LoopTimestampOffset = 0;
+	int64 FirstTimestamp = 0;
+	int64 LastTimestamp = 0;
+	int64 ClockOriginTimestamp = 0;
+	double ClockOriginSeconds = 0;
+	int64 NumFramesPlayed = 0;
+	// GFrameCounter of the last advance when PlaybackSpeed <= 0
+	uint64 LastAdvanceFrameCounter = MAX_uint64;
+
+	LEAP_DEVICE_INFO DummyDeviceInfo;
+	TArray<ANSICHAR> SerialBuffer;
+	FString DeviceSerial;
+	int32 DeviceID = 0;
+
+	TSharedPtr<class FUltraleapDevice> Device;
+
+	// prevent overlap with Leap and OpenXR Device IDs
+	static const int32 RecordingBaseDeviceID = 20000;
+};
@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapTrackingRecorder.h"
+#include "HAL/IConsoleManager.h"
+#include "IUltraleapTrackingPlugin.h"
+#include "LeapAsync.h"
+#include "LeapUtility.h"
+#include "Misc/ScopeExit.h"
+
+DECLARE_STATS_GROUP(TEXT("UltraleapRecording"), STATGROUP_UltraleapRecording, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leap Recorded Frames"), STAT_LeapRecordedFrames, STATGROUP_UltraleapRecording);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Leap Recording Dropped Frames"), STAT_LeapRecordingDroppedFrames, STATGROUP_UltraleapRecording);
+
+FLeapTrackingRecorder::FLeapTrackingRecorder()
+	: Head(0)
+	, Tail(0)
+	, NumActiveProducers(0)
+	, WriterWaiting(0)
+	, Recording(nullptr)
+	, RecordedDeviceID(0)
+	, bIsRecording(false)
+	, bWriterRunning(false)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FLeapTrackingRecorder::~FLeapTrackingRecorder()
+{
+	Stop();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+bool FLeapTrackingRecorder::Start(const FString& FilePath, const uint32 DeviceID)
+{
+	if (bIsRecording || bWriterRunning)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapTrackingRecorder already recording to %s."), *RecordingPath);
+		return false;
+	}
+
+	LEAP_RECORDING_PARAMETERS Params;
+	Params.mode = eLeapRecordingFlags_Writing;
+	eLeapRS Result = LeapRecordingOpen(&Recording, TCHAR_TO_UTF8(*FilePath), Params);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapRecordingOpen failed for %s, result %d."), *FilePath, (int32) Result);
+		Recording = nullptr;
+		return false;
+	}
+
+	if (Slots.Num() == 0)
+	{
+		Slots.SetNumZeroed(QueueCapacity);
+	}
+	// Stop drained the ring with the producer gated off, so it starts empty
+	check(Tail == Head);
+
+	RecordingPath = FilePath;
+	RecordedDeviceID = DeviceID;
+	NumRecorded.Reset();
+	NumDropped.Reset();
+	NumWriteErrors.Reset();
+
+	bWriterRunning = true;
+	bIsRecording = true;
+	WriterFuture = FLeapAsync::RunLambdaOnBackGroundThread([this] { WriterLoop(); });
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("FLeapTrackingRecorder recording to %s."), *RecordingPath);
+	return true;
+}
+
+void FLeapTrackingRecorder::Stop()
+{
+	if (!bWriterRunning)
+	{
+		return;
+	}
+	bIsRecording = false;
+	// an event already past the check never blocks, wait for it so nothing lands in the ring after the final drain
+	while (FPlatformAtomics::AtomicRead(&NumActiveProducers) > 0)
+	{
+		FPlatformProcess::YieldThread();
+	}
+	bWriterRunning = false;
+	WakeEvent->Trigger();
+
+	// the writer drains the ring before exiting, it owns Recording until then
+	WriterFuture.Wait();
+	WriterFuture.Reset();
+
+	if (Recording)
+	{
+		LeapRecordingClose(&Recording);
+		Recording = nullptr;
+	}
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("FLeapTrackingRecorder stopped %s: %d frames written, %d dropped, %d write errors."),
+		*RecordingPath, NumRecorded.GetValue(), NumDropped.GetValue(), NumWriteErrors.GetValue());
+}
+
+void FLeapTrackingRecorder::Enqueue(const LEAP_TRACKING_EVENT* TrackingEvent, const uint32 DeviceID)
+{
+	FPlatformAtomics::InterlockedIncrement(&NumActiveProducers);
+	ON_SCOPE_EXIT
+	{
+		FPlatformAtomics::InterlockedDecrement(&NumActiveProducers);
+	};
+	if (!bIsRecording)
+	{
+		return;
+	}
+	if (RecordedDeviceID == 0)
+	{
+		// lock on to the first device that sends data
+		RecordedDeviceID = DeviceID;
+	}
+	else if (RecordedDeviceID != DeviceID)
+	{
+		return;
+	}
+
+	const int32 CurrentHead = Head;
+	const int32 NextHead = (CurrentHead + 1) % QueueCapacity;
+	if (NextHead == FPlatformAtomics::AtomicRead(&Tail))
+	{
+		NumDropped.Increment();
+		INC_DWORD_STAT(STAT_LeapRecordingDroppedFrames);
+		return;
+	}
+
+	FSlot& Slot = Slots[CurrentHead];
+	Slot.Event = *TrackingEvent;
+	Slot.Event.nHands = FMath::Min(TrackingEvent->nHands, FLeapFrameTripleBuffer::MaxHands);
+	Slot.Event.pHands = Slot.Hands;
+	if (Slot.Event.nHands > 0 && TrackingEvent->pHands)
+	{
+		FMemory::Memcpy(Slot.Hands, TrackingEvent->pHands, sizeof(LEAP_HAND) * Slot.Event.nHands);
+	}
+
+	FPlatformAtomics::InterlockedExchange(&Head, NextHead);
+	// a writer that is busy finds the frame on its next pass, don't pay for a signal every frame
+	if (FPlatformAtomics::AtomicRead(&WriterWaiting))
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FLeapTrackingRecorder::WriterLoop()
+{
+	while (true)
+	{
+		const int32 CurrentTail = Tail;
+		if (CurrentTail == FPlatformAtomics::AtomicRead(&Head))
+		{
+			if (!bWriterRunning)
+			{
+				break;
+			}
+			// announce the wait before the last look at Head, so a frame published in between either shows up
+			// here or sees the flag and signals
+			FPlatformAtomics::InterlockedExchange(&WriterWaiting, 1);
+			if (CurrentTail == FPlatformAtomics::AtomicRead(&Head))
+			{
+				WakeEvent->Wait(10);
+			}
+			FPlatformAtomics::InterlockedExchange(&WriterWaiting, 0);
+			continue;
+		}
+
+		FSlot& Slot = Slots[CurrentTail];
+		uint64_t BytesWritten = 0;
+		eLeapRS Result = LeapRecordingWrite(Recording, &Slot.Event, &BytesWritten);
+		if (Result == eLeapRS_Success)
+		{
+			NumRecorded.Increment();
+			INC_DWORD_STAT(STAT_LeapRecordedFrames);
+		}
+		else
+		{
+			NumWriteErrors.Increment();
+		}
+
+		FPlatformAtomics::InterlockedExchange(&Tail, (CurrentTail + 1) % QueueCapacity);
+	}
+}
+
+static FAutoConsoleCommand LeapStartRecordingCommand(TEXT("leap.StartRecording"),
+	TEXT("Records tracking frames to a LeapC recording file. Usage: leap.StartRecording <Path> [DeviceID, 0 = first device]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		if (Args.Num() < 1 || !IUltraleapTrackingPlugin::IsAvailable())
+		{
+			return;
+		}
+		ILeapConnector* Connector = IUltraleapTrackingPlugin::Get().GetConnector();
+		if (Connector)
+		{
+			const uint32 DeviceID = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0;
+			Connector->StartRecording(Args[0], DeviceID);
+		}
+	}));
+
+static FAutoConsoleCommand LeapStopRecordingCommand(TEXT("leap.StopRecording"), TEXT("Stops a recording started with leap.StartRecording"),
+	FConsoleCommandDelegate::CreateLambda([]() {
+		if (!IUltraleapTrackingPlugin::IsAvailable())
+		{
+			return;
+		}
+		ILeapConnector* Connector = IUltraleapTrackingPlugin::Get().GetConnector();
+		if (Connector)
+		{
+			Connector->StopRecording();
+		}
+	}));
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Async/Async.h"
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "LeapC.h"
+#include "LeapFrameTripleBuffer.h"
+
+/**
+ * Records tracking events to a LeapC recording file without blocking the caller.
+ * The poll thread copies events into a bounded single producer / single consumer ring,
+ * a dedicated writer thread drains it through LeapRecordingWrite. When the ring is full
+ * the event is dropped and counted rather than waiting on the disk.
+ */
+class FLeapTrackingRecorder
+{
+public:
+	/** Ring capacity in frames, roughly 4 seconds at 120Hz */
+	static const int32 QueueCapacity = 512;
+
+	FLeapTrackingRecorder();
+	~FLeapTrackingRecorder();
+
+	/** Opens the file and starts the writer. DeviceID 0 records whichever device sends events */
+	bool Start(const FString& FilePath, const uint32 DeviceID = 0);
+	/** Stops accepting events, flushes the ring and closes the file */
+	void Stop();
+
+	bool IsRecording() const
+	{
+		return bIsRecording;
+	}
+
+	/** Called from the poll thread, never blocks */
+	void Enqueue(const LEAP_TRACKING_EVENT* TrackingEvent, const uint32 DeviceID);
+
+	int32 GetNumRecorded() const
+	{
+		return NumRecorded.GetValue();
+	}
+	int32 GetNumDropped() const
+	{
+		return NumDropped.GetValue();
+	}
+
+private:
+	struct FSlot
+	{
+		LEAP_TRACKING_EVENT Event;
+		LEAP_HAND Hands[FLeapFrameTripleBuffer::MaxHands];
+	};
+
+	void WriterLoop();
+
+	TArray<FSlot> Slots;
+	// written by the producer only
+	volatile int32 Head;
+	// written by the consumer only
+	volatile int32 Tail;
+	// producers past the bIsRecording check, Stop waits for them before the final drain
+	volatile int32 NumActiveProducers;
+	// set by the writer while it waits on WakeEvent, so the producer only signals when someone is waiting
+	volatile int32 WriterWaiting;
+
+	LEAP_RECORDING Recording;
+	uint32 RecordedDeviceID;
+	FString RecordingPath;
+
+	FThreadSafeBool bIsRecording;
+	FThreadSafeBool bWriterRunning;
+	FEvent* WakeEvent;
+	TFuture<void> WriterFuture;
+
+	FThreadSafeCounter NumRecorded;
+	FThreadSafeCounter NumDropped;
+	FThreadSafeCounter NumWriteErrors;
+};
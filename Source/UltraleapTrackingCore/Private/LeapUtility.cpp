@@ -75,10 +75,16 @@ FQuat FLeapUtility::ConvertLeapQuatToFQuat(const LEAP_QUATERNION& Quaternion)
 
 FVector FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
 	const LEAP_VECTOR& LeapVector, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset)
+{
+	return ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
+		LeapVector, LeapMountTranslationOffset, LeapMountRotationOffset, GetLeapToUEScale());
+}
+
+FVector FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(const LEAP_VECTOR& LeapVector,
+	const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset, const float Scale)
 {
 	// Scale from mm to cm (ue default)
-	FVector ConvertedVector =
-		(ConvertLeapVectorToFVector(LeapVector) + LeapMountTranslationOffset) * (LEAP_TO_UE_SCALE * LeapGetWorldScaleFactor());
+	FVector ConvertedVector = (ConvertLeapVectorToFVector(LeapVector) + LeapMountTranslationOffset) * Scale;
 	if (ConvertedVector.ContainsNaN())
 	{
 		ConvertedVector = FVector::ZeroVector;
@@ -132,6 +138,11 @@ float FLeapUtility::ScaleUEToLeap(float UEFloat)
 {
 	return UEFloat * UE_TO_LEAP_SCALE;	  // mm->cm
 }
+
+float FLeapUtility::GetLeapToUEScale()
+{
+	return LEAP_TO_UE_SCALE * LeapGetWorldScaleFactor();
+}
 // static, this has to be done during runtime as the static initialiser
 // does not work in shipping builds.
 void FLeapUtility::InitLeapStatics()
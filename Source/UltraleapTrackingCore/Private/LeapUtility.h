@@ -28,6 +28,9 @@ public:
 
 	static FVector ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(
 		const LEAP_VECTOR& LeapVector, const FVector& LeapMountTranslationOffset,const FQuat& LeapMountRotationOffset);
+	// Scale is GetLeapToUEScale(), look it up once per frame rather than per vector
+	static FVector ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(const LEAP_VECTOR& LeapVector,
+		const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset, const float Scale);
 	static FQuat ConvertToFQuatWithHMDOffsets(LEAP_QUATERNION Quaternion, const FQuat& LeapMountRotationOffset);
 
 	
@@ -40,11 +43,74 @@ public:
 
 	static float ScaleLeapFloatToUE(float LeapFloat);
 	static float ScaleUEToLeap(float UEFloat);
+	// mm->cm including the world to meters scale
+	static float GetLeapToUEScale();
 
 	static void InitLeapStatics();
 	static FQuat LeapRotationOffset;
 };
 
+/**
+ * FTransform (scale, then rotation, then translation) held in vector registers so it can be applied to every joint of a
+ * frame in one pass, without FRotator conversions or per call matrix setup.
+ */
+class FLeapVectorTransform
+{
+public:
+	explicit FLeapVectorTransform(const FTransform& Transform)
+		: Rotation(Transform.GetRotation())
+		, Translation(Transform.GetTranslation())
+		, Scale3D(Transform.GetScale3D())
+	{
+		RotationRegister = VectorLoad(&Rotation.X);
+		TranslationRegister = VectorLoadFloat3_W0(&Translation.X);
+		ScaleRegister = VectorLoadFloat3_W0(&Scale3D.X);
+	}
+
+	// R * (S * Position) + T
+	FORCEINLINE void TransformPosition(FVector& InOutPosition) const
+	{
+		const VectorRegister Scaled = VectorMultiply(VectorLoadFloat3_W0(&InOutPosition.X), ScaleRegister);
+		VectorStoreFloat3(VectorAdd(VectorQuaternionRotateVector(RotationRegister, Scaled), TranslationRegister), &InOutPosition.X);
+	}
+
+	// R * (S * Vector), e.g. velocities
+	FORCEINLINE void TransformVector(FVector& InOutVector) const
+	{
+		const VectorRegister Scaled = VectorMultiply(VectorLoadFloat3_W0(&InOutVector.X), ScaleRegister);
+		VectorStoreFloat3(VectorQuaternionRotateVector(RotationRegister, Scaled), &InOutVector.X);
+	}
+
+	// R * Direction, e.g. normals
+	FORCEINLINE void RotateVector(FVector& InOutDirection) const
+	{
+		VectorStoreFloat3(VectorQuaternionRotateVector(RotationRegister, VectorLoadFloat3_W0(&InOutDirection.X)), &InOutDirection.X);
+	}
+
+	// R * Orientation
+	FORCEINLINE void RotateQuat(FQuat& InOutOrientation) const
+	{
+		VectorStore(VectorQuaternionMultiply2(RotationRegister, VectorLoad(&InOutOrientation.X)), &InOutOrientation.X);
+	}
+
+	// Blueprint types store FRotator, one conversion each way
+	FORCEINLINE void RotateRotator(FRotator& InOutOrientation) const
+	{
+		FQuat Orientation = InOutOrientation.Quaternion();
+		RotateQuat(Orientation);
+		InOutOrientation = Orientation.Rotator();
+	}
+
+private:
+	FQuat Rotation;
+	FVector Translation;
+	FVector Scale3D;
+
+	VectorRegister RotationRegister;
+	VectorRegister TranslationRegister;
+	VectorRegister ScaleRegister;
+};
+
 class LeapUtilityTimer
 {
 	int64 TickTime = 0;
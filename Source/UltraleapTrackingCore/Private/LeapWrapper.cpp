@@ -7,20 +7,35 @@
  ******************************************************************************/
 
 #include "LeapWrapper.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
 #include "LeapDeviceWrapper.h"
 #include "LeapAsync.h"
+#include "LeapGameThreadQueue.h"
+#include "LeapPollThread.h"
+#include "LeapPooledAllocator.h"
+#include "LeapRecordingPlaybackWrapper.h"
+#include "LeapTrackingRecorder.h"
 #include "LeapUtility.h"
+#include "Misc/ScopeLock.h"
 #include "Multileap/DeviceCombiner.h"
 #include "Runtime/Core/Public/Misc/Timespan.h"
 #include "LeapBlueprintFunctionLibrary.h"
 
+DECLARE_STATS_GROUP(TEXT("UltraleapConnector"), STATGROUP_UltraleapConnector, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Leap Device Capture Task"), STAT_LeapDeviceCaptureTask, STATGROUP_UltraleapConnector);
+
+static TAutoConsoleVariable<int32> CVarLeapParallelDeviceCapture(TEXT("leap.ParallelDeviceCapture"), 1,
+	TEXT("With more than one device, capture and transform each device's frame in a task graph task, combined devices "
+		 "waiting on their sources. Gestures and events still run on the game thread. 0 captures serially."),
+	ECVF_Default);
+
 #pragma region LeapC Wrapper
 
 FLeapWrapper::FLeapWrapper()
 	: bIsRunning(false)
 	, DataLock(new FCriticalSection())
-	, InterpolatedFrame(nullptr)
-	, InterpolatedFrameSize(0)
+	, Recorder(new FLeapTrackingRecorder())
 {
 	UseOpenXR = true;
 
@@ -33,8 +48,8 @@ FLeapWrapper::FLeapWrapper()
 void FLeapWrapper::HandleApplicationDeactivate()
 {
 	// This will reset the tracking service for Android app, when the device goes to sleep 
-	AsyncTask(ENamedThreads::GameThread,
-		[this]()
+	FLeapGameThreadQueue::Get().Enqueue(
+		[]()
 		{
 			ULeapBlueprintFunctionLibrary::UnbindTrackingServiceAndroid();
 			ULeapBlueprintFunctionLibrary::BindTrackingServiceAndroid();
@@ -57,12 +72,24 @@ FLeapWrapper::~FLeapWrapper()
 	// map device to callback delegate
 	MapDeviceToCallback.Empty();
 
-	ConnectionHandle = nullptr;
-
 	if (bIsConnected)
 	{
 		CloseConnection();
 	}
+	// joins if the service never connected, the poll thread destroys the connection on its way out
+	delete PollThread;
+	PollThread = nullptr;
+	// created but never polled
+	if (ConnectionHandle)
+	{
+		LeapDestroyConnection(ConnectionHandle);
+	}
+	ConnectionHandle = nullptr;
+	// nothing polls any more, drop the device callbacks still queued for this wrapper
+	if (IsInGameThread())
+	{
+		FLeapGameThreadQueue::Get().DiscardOwner(this);
+	}
 
 	// Always remove delegate events and reset 
 	if (HasDeactivateHandle.IsValid())
@@ -70,6 +97,13 @@ FLeapWrapper::~FLeapWrapper()
 		FCoreDelegates::ApplicationWillDeactivateDelegate.Remove(HasDeactivateHandle);
 		HasDeactivateHandle.Reset();
 	}
+
+	delete Recorder;
+	Recorder = nullptr;
+
+	// LeapC may hand back pooled blocks until the connection is destroyed
+	delete PooledAllocator;
+	PooledAllocator = nullptr;
 }
 // to be deprecated
 void FLeapWrapper::SetCallbackDelegate(LeapWrapperCallbackInterface* InCallbackDelegate)
@@ -98,22 +132,34 @@ LEAP_CONNECTION* FLeapWrapper::OpenConnection(LeapWrapperCallbackInterface* InCa
 		Config.flags = _eLeapConnectionConfig::eLeapConnectionConfig_MultiDeviceAware;
 	}
 
+	// a previous poll thread destroys its connection through ConnectionHandle, let it finish before replacing it
+	delete PollThread;
+	PollThread = nullptr;
+
 	eLeapRS result = LeapCreateConnection(&Config, &ConnectionHandle);
 	if (result == eLeapRS_Success)
 	{
+		if (FLeapPooledAllocator::IsEnabled())
+		{
+			if (!PooledAllocator)
+			{
+				PooledAllocator = new FLeapPooledAllocator();
+			}
+			PooledAllocator->Register(ConnectionHandle);
+		}
 		result = LeapOpenConnection(ConnectionHandle);
 		if (result == eLeapRS_Success)
 		{
 			bIsRunning = true;
 
 			LEAP_CONNECTION* Handle = &ConnectionHandle;
-			ProducerLambdaFuture = FLeapAsync::RunLambdaOnBackGroundThread([&, Handle] {
-				UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop started."));
-				ServiceMessageLoop();
-				UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop stopped."));
-
-				CloseConnectionHandle(Handle);
-			});
+			PollThread = new FLeapPollThread(
+				ConnectionHandle, [this](const LEAP_CONNECTION_MESSAGE& Msg) { HandleConnectionMessage(Msg); },
+				[this, Handle] { CloseConnectionHandle(Handle); });
+			if (!PollThread->Start())
+			{
+				bIsRunning = false;
+			}
 		}
 	}
 	
@@ -140,11 +186,11 @@ void FLeapWrapper::CloseConnection()
 	bIsRunning = false;
 	
 
-	// Wait for thread to exit - Blocking call, but it should be very quick.
-	FTimespan ExitWaitTimeSpan = FTimespan::FromSeconds(3);
-
-	ProducerLambdaFuture.WaitFor(ExitWaitTimeSpan);
-	ProducerLambdaFuture.Reset();
+	// Wait for thread to exit - Blocking call, bounded by one poll timeout
+	if (PollThread)
+	{
+		PollThread->StopAndWait();
+	}
 
 	// Nullify the callback delegate. Any outstanding task graphs will not run if the delegate is nullified.
 	MapDeviceToCallback.Empty();
@@ -160,6 +206,15 @@ void FLeapWrapper::SetTrackingMode(eLeapTrackingMode TrackingMode)
 		UE_LOG(UltraleapTrackingLog, Log, TEXT("SetTrackingMode failed in  FLeapWrapper::SetTrackingMode."));
 	}
 }
+float FLeapWrapper::GetDeviceFrameRate()
+{
+	float FrameRate = 0;
+	if (LeapGetDeviceFrameRate(ConnectionHandle, &FrameRate) != eLeapRS_Success)
+	{
+		return 0;
+	}
+	return FrameRate;
+}
 LEAP_DEVICE FLeapWrapper::GetDeviceHandleFromDeviceID(const uint32_t DeviceID)
 {
 	LEAP_DEVICE DeviceHandle = nullptr;
@@ -230,6 +285,7 @@ void FLeapWrapper::CloseConnectionHandle(LEAP_CONNECTION* InConnectionHandle)
 	bIsRunning = false;
 	bIsConnected = false;
 	LeapDestroyConnection(*InConnectionHandle);
+	*InConnectionHandle = nullptr;
 }
 
 LEAP_TRACKING_EVENT* FLeapWrapper::GetFrame()
@@ -241,32 +297,40 @@ LEAP_TRACKING_EVENT* FLeapWrapper::GetFrame()
 	return currentFrame;
 }
 
-LEAP_TRACKING_EVENT* FLeapWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+LEAP_TRACKING_EVENT* FLeapWrapper::InterpolateFrame(
+	const int64 TimeStamp, const LEAP_DEVICE DeviceHandle, FLeapInterpolatedFrameBuffer& Buffer)
 {
-	uint64_t FrameSize = 0;
-
-	eLeapRS Result = LeapGetFrameSize(ConnectionHandle, TimeStamp, &FrameSize);
-
-	// Check validity of frame size
-	if (FrameSize > 0)
+	// The size only changes with the hand count, so interpolate straight into the existing buffer and
+	// only ask LeapC for the size when there is no buffer yet or it turns out to be too small
+	eLeapRS Result = eLeapRS_InsufficientBuffer;
+	if (Buffer.GetCapacity() > 0)
+	{
+		Result = DeviceHandle
+					 ? LeapInterpolateFrameEx(ConnectionHandle, DeviceHandle, TimeStamp, Buffer.GetFrame(), Buffer.GetCapacity())
+					 : LeapInterpolateFrame(ConnectionHandle, TimeStamp, Buffer.GetFrame(), Buffer.GetCapacity());
+	}
+	if (Result == eLeapRS_InsufficientBuffer)
 	{
-		// Different frame?
-		if (FrameSize != InterpolatedFrameSize)
+		uint64_t FrameSize = 0;
+		Result = DeviceHandle ? LeapGetFrameSizeEx(ConnectionHandle, DeviceHandle, TimeStamp, &FrameSize)
+							  : LeapGetFrameSize(ConnectionHandle, TimeStamp, &FrameSize);
+
+		// Check validity of frame size
+		if (Result != eLeapRS_Success || FrameSize == 0)
 		{
-			// If we already have an allocated frame, free it
-			if (InterpolatedFrame)
-			{
-				free(InterpolatedFrame);
-			}
-			InterpolatedFrame = (LEAP_TRACKING_EVENT*) malloc(FrameSize);
+			return nullptr;
 		}
-		InterpolatedFrameSize = FrameSize;
-
-		// Grab the new frame
-		LeapInterpolateFrame(ConnectionHandle, TimeStamp, InterpolatedFrame, InterpolatedFrameSize);
+		Buffer.Reserve(FrameSize);
+		Result = DeviceHandle
+					 ? LeapInterpolateFrameEx(ConnectionHandle, DeviceHandle, TimeStamp, Buffer.GetFrame(), Buffer.GetCapacity())
+					 : LeapInterpolateFrame(ConnectionHandle, TimeStamp, Buffer.GetFrame(), Buffer.GetCapacity());
 	}
+	return Result == eLeapRS_Success ? Buffer.GetFrame() : nullptr;
+}
 
-	return InterpolatedFrame;
+LEAP_TRACKING_EVENT* FLeapWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+{
+	return InterpolateFrame(TimeStamp, nullptr, FingerFrameBuffer);
 }
 LEAP_TRACKING_EVENT* FLeapWrapper::GetInterpolatedFrameAtTimeEx(int64 TimeStamp, const uint32_t DeviceID)
 {
@@ -274,32 +338,23 @@ LEAP_TRACKING_EVENT* FLeapWrapper::GetInterpolatedFrameAtTimeEx(int64 TimeStamp,
 	{
 		return GetInterpolatedFrameAtTime(TimeStamp);
 	}
-	uint64_t FrameSize = 0;
-	LEAP_DEVICE DeviceHandle = nullptr;
-
-	DeviceHandle = GetDeviceHandleFromDeviceID(DeviceID);
-	eLeapRS Result = LeapGetFrameSizeEx(ConnectionHandle, DeviceHandle, TimeStamp, &FrameSize );
-
-	// Check validity of frame size
-	if (FrameSize > 0)
+	LEAP_DEVICE DeviceHandle = GetDeviceHandleFromDeviceID(DeviceID);
+	if (!DeviceHandle)
 	{
-		// Different frame?
-		if (FrameSize != InterpolatedFrameSize)
-		{
-			// If we already have an allocated frame, free it
-			if (InterpolatedFrame)
-			{
-				free(InterpolatedFrame);
-			}
-			InterpolatedFrame = (LEAP_TRACKING_EVENT*) malloc(FrameSize);
-		}
-		InterpolatedFrameSize = FrameSize;
-
-		// Grab the new frame
-		LeapInterpolateFrameEx(ConnectionHandle,DeviceHandle,TimeStamp, InterpolatedFrame, InterpolatedFrameSize);
+		return nullptr;
 	}
-
-	return InterpolatedFrame;
+	return InterpolateFrame(TimeStamp, DeviceHandle, FingerFrameBuffer);
+}
+bool FLeapWrapper::GetInterpolatedFramesAtTimes(
+	int64 FingerTimeStamp, int64 HandTimeStamp, LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame)
+{
+	OutFingerFrame = InterpolateFrame(FingerTimeStamp, nullptr, FingerFrameBuffer);
+	OutHandFrame = OutFingerFrame ? InterpolateFrame(HandTimeStamp, nullptr, HandFrameBuffer) : nullptr;
+	if (!OutHandFrame)
+	{
+		OutFingerFrame = nullptr;
+	}
+	return OutHandFrame != nullptr;
 }
 
 /* LEAP_DEVICE_INFO* FLeapWrapper::GetDeviceProperties()
@@ -401,7 +456,7 @@ void FLeapWrapper::SetFrame(const LEAP_TRACKING_EVENT* Frame)
 	DataLock->Unlock();
 }
 
-/** Called by ServiceMessageLoop() when a connection event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a connection event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConnectionEvent(const LEAP_CONNECTION_EVENT* ConnectionEvent)
 {
 	bIsConnected = true;
@@ -411,7 +466,7 @@ void FLeapWrapper::HandleConnectionEvent(const LEAP_CONNECTION_EVENT* Connection
 	}
 }
 
-/** Called by ServiceMessageLoop() when a connection lost event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a connection lost event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConnectionLostEvent(const LEAP_CONNECTION_LOST_EVENT* ConnectionLostEvent)
 {
 	bIsConnected = false;
@@ -424,7 +479,7 @@ void FLeapWrapper::HandleConnectionLostEvent(const LEAP_CONNECTION_LOST_EVENT* C
 }
 
 /**
- * Called by ServiceMessageLoop() when a device event is returned by LeapPollConnection()
+ * Called by HandleConnectionMessage() when a device event is returned by LeapPollConnection()
  */
 void FLeapWrapper::HandleDeviceEvent(const LEAP_DEVICE_EVENT* DeviceEvent)
 {
@@ -463,7 +518,7 @@ void FLeapWrapper::HandleDeviceEvent(const LEAP_DEVICE_EVENT* DeviceEvent)
 	
 	if (ConnectorCallbackDelegate)
 	{
-		TaskRefDeviceFound = FLeapAsync::RunShortLambdaOnGameThread([DeviceEvent, DeviceProperties, this] {
+		FLeapGameThreadQueue::Get().Enqueue(this, [DeviceProperties, this] {
 				if (ConnectorCallbackDelegate)
 			{
 				ConnectorCallbackDelegate->OnDeviceFound(&DeviceProperties);
@@ -479,18 +534,20 @@ void FLeapWrapper::HandleDeviceEvent(const LEAP_DEVICE_EVENT* DeviceEvent)
 	LeapCloseDevice(DeviceHandle);
 }
 
-/** Called by ServiceMessageLoop() when a device lost event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a device lost event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleDeviceLostEvent(const LEAP_DEVICE_EVENT* DeviceEvent)
 {
 	if (ConnectorCallbackDelegate)
 	{
-		TaskRefDeviceLost = FLeapAsync::RunShortLambdaOnGameThread([DeviceEvent, this] {
+		// the event is only valid until the next poll
+		const uint32_t LostDeviceID = DeviceEvent->device.id;
+		FLeapGameThreadQueue::Get().Enqueue(this, [LostDeviceID, this] {
 				if (ConnectorCallbackDelegate)
 			{
 					FString DeviceSerial;
 					for (auto LeapDeviceWrapper : Devices)
 					{
-						if (LeapDeviceWrapper->GetDeviceID() == DeviceEvent->device.id)
+						if (LeapDeviceWrapper->GetDeviceID() == LostDeviceID)
 						{
 							DeviceSerial = LeapDeviceWrapper->GetDeviceSerial();
 							break;
@@ -505,7 +562,7 @@ void FLeapWrapper::HandleDeviceLostEvent(const LEAP_DEVICE_EVENT* DeviceEvent)
 }
 void FLeapWrapper::AddDevice(const uint32_t DeviceID, const LEAP_DEVICE_INFO& DeviceInfo, const LEAP_DEVICE DeviceHandle)
 {
-	AsyncTask(ENamedThreads::GameThread,
+	FLeapGameThreadQueue::Get().Enqueue(this,
 		[this,DeviceInfo, DeviceID, DeviceHandle]()
 		{
 			IHandTrackingWrapper* Device = new FLeapDeviceWrapper(DeviceID, DeviceInfo, DeviceHandle, ConnectionHandle, this);
@@ -525,7 +582,7 @@ void FLeapWrapper::AddDevice(const uint32_t DeviceID, const LEAP_DEVICE_INFO& De
 void FLeapWrapper::RemoveDevice(const uint32_t DeviceID)
 {
 	// This will reset the tracking service for Android app
-	AsyncTask(ENamedThreads::GameThread, [this]() { 
+	FLeapGameThreadQueue::Get().Enqueue([]() { 
 		ULeapBlueprintFunctionLibrary::UnbindTrackingServiceAndroid();
 		ULeapBlueprintFunctionLibrary::BindTrackingServiceAndroid();
 	});
@@ -534,7 +591,7 @@ void FLeapWrapper::RemoveDevice(const uint32_t DeviceID)
 	{
 		return RemoveDeviceDirect(DeviceID);
 	}
-	AsyncTask(ENamedThreads::GameThread,
+	FLeapGameThreadQueue::Get().Enqueue(this,
 		[this, DeviceID]() { 
 			RemoveDeviceDirect(DeviceID);
 		});
@@ -554,28 +611,28 @@ void FLeapWrapper::RemoveDeviceDirect(const uint32_t DeviceID)
 			Devices.Remove(LeapDeviceWrapper);
 			CleanupCombinedDevicesReferencingDevice(LeapDeviceWrapper);
 			NotifyDeviceRemoved(LeapDeviceWrapper);
-			DevicesToCleanup.Remove(LeapDeviceWrapper);
+			{
+				FScopeLock ScopeLock(&DevicesToCleanupLock);
+				DevicesToCleanup.Remove(LeapDeviceWrapper);
+			}
 			delete LeapDeviceWrapper;
 			break;
 		}
 	}
 	UE_LOG(UltraleapTrackingLog, Log, TEXT("Device Count %d."), Devices.Num());
 }
-/** Called by ServiceMessageLoop() when a device failure event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a device failure event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleDeviceFailureEvent(const LEAP_DEVICE_FAILURE_EVENT* DeviceFailureEvent, const uint32_t DeviceID)
 {
 	LeapWrapperCallbackInterface* CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
 	
 	if (CallbackDelegate)
 	{
-		TaskRefDeviceFailure = FLeapAsync::RunShortLambdaOnGameThread([CallbackDelegate, DeviceFailureEvent, this]
-		{
-			CallbackDelegate->OnDeviceFailure(DeviceFailureEvent->status, DeviceFailureEvent->hDevice);
-		});
+		FLeapGameThreadQueue::Get().EnqueueDeviceFailure(CallbackDelegate, DeviceFailureEvent->status, DeviceFailureEvent->hDevice);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a tracking event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a tracking event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleTrackingEvent(const LEAP_TRACKING_EVENT* TrackingEvent,const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
@@ -587,6 +644,17 @@ void FLeapWrapper::HandleTrackingEvent(const LEAP_TRACKING_EVENT* TrackingEvent,
 	}
 }
 
+/** Called by HandleConnectionMessage() when the service reports a frame it dropped. */
+void FLeapWrapper::HandleDroppedFrameEvent(const LEAP_DROPPED_FRAME_EVENT* DroppedFrameEvent, const uint32_t DeviceID)
+{
+	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
+	if (CallbackDelegate)
+	{
+		// counted on this thread, no game thread hop
+		CallbackDelegate->OnDroppedFrame(DroppedFrameEvent);
+	}
+}
+
 void FLeapWrapper::HandleImageEvent(const LEAP_IMAGE_EVENT* ImageEvent, const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
@@ -598,24 +666,17 @@ void FLeapWrapper::HandleImageEvent(const LEAP_IMAGE_EVENT* ImageEvent, const ui
 	}
 }
 
-/** Called by ServiceMessageLoop() when a log event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a log event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleLogEvent(const LEAP_LOG_EVENT* LogEvent, const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
 	if (CallbackDelegate)
 	{
-		TaskRefLog = FLeapAsync::RunShortLambdaOnGameThread(
-			[CallbackDelegate, LogEvent, this]
-			{
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnLog(LogEvent->severity, LogEvent->timestamp, LogEvent->message);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueLog(CallbackDelegate, LogEvent->severity, LogEvent->timestamp, LogEvent->message);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a policy event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a policy event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent, const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
@@ -624,18 +685,11 @@ void FLeapWrapper::HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent, const
 		// this is always coming back as 0, this means either the Leap service refused to set any flags?
 		// or there's a bug in the policy notification system with Leap Motion V4.
 		const uint32_t CurrentPolicy = PolicyEvent->current_policy;
-		TaskRefPolicy = FLeapAsync::RunShortLambdaOnGameThread(
-			[CallbackDelegate, CurrentPolicy, this]
-			{
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnPolicy(CurrentPolicy);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueuePolicy(CallbackDelegate, CurrentPolicy);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a policy event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a policy event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT* TrackingModeEvent, const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
@@ -644,131 +698,84 @@ void FLeapWrapper::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT* Track
 		// this is always coming back as 0, this means either the Leap service refused to set any flags?
 		// or there's a bug in the policy notification system with Leap Motion V4.
 		const uint32_t CurrentMode = TrackingModeEvent->current_tracking_mode;
-		TaskRefPolicy = FLeapAsync::RunShortLambdaOnGameThread(
-			[CallbackDelegate, CurrentMode, this]
-			{
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnTrackingMode((eLeapTrackingMode) CurrentMode);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueTrackingMode(CallbackDelegate, (eLeapTrackingMode) CurrentMode);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a config change event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a config change event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConfigChangeEvent(const LEAP_CONFIG_CHANGE_EVENT* ConfigChangeEvent, const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
 	if (CallbackDelegate)
 	{
-		TaskRefConfigChange = FLeapAsync::RunShortLambdaOnGameThread(
-			[CallbackDelegate, ConfigChangeEvent, this]
-			{
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnConfigChange(ConfigChangeEvent->requestID, ConfigChangeEvent->status);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueConfigChange(CallbackDelegate, ConfigChangeEvent->requestID, ConfigChangeEvent->status);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a config response event is returned by LeapPollConnection(). */
+/** Called by HandleConnectionMessage() when a config response event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConfigResponseEvent(const LEAP_CONFIG_RESPONSE_EVENT* ConfigResponseEvent, const uint32_t DeviceID)
 {
 	auto CallbackDelegate = GetCallbackDelegateFromDeviceID(DeviceID);
 	if (CallbackDelegate)
 	{
-		TaskRefConfigResponse = FLeapAsync::RunShortLambdaOnGameThread(
-			[CallbackDelegate, ConfigResponseEvent, this]
-			{
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnConfigResponse(ConfigResponseEvent->requestID, ConfigResponseEvent->value);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueConfigResponse(
+			CallbackDelegate, ConfigResponseEvent->requestID, ConfigResponseEvent->value);
 	}
 }
 
 /**
- * Services the LeapC message pump by calling LeapPollConnection().
+ * Dispatches a message returned by LeapPollConnection() on the poll thread (see FLeapPollThread).
  * The average polling time is determined by the framerate of the Leap Motion service.
  */
-void FLeapWrapper::ServiceMessageLoop(void* Unused)
+void FLeapWrapper::HandleConnectionMessage(const LEAP_CONNECTION_MESSAGE& Msg)
 {
-	eLeapRS Result;
-	LEAP_CONNECTION_MESSAGE Msg;
-	LEAP_CONNECTION Handle = ConnectionHandle;	  // copy handle so it doesn't get released from under us on game thread
-
-	unsigned int Timeout = 200;
-	while (bIsRunning)
+	switch (Msg.type)
 	{
-		Result = LeapPollConnection(Handle, Timeout, &Msg);
-
-		// Polling may have taken some time, re-check exit condition
-		if (!bIsRunning)
-		{
+		case eLeapEventType_Connection:
+			HandleConnectionEvent(Msg.connection_event);
 			break;
-		}
-
-		if (Result != eLeapRS_Success)
-		{
-			// UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapC PollConnection unsuccessful result %s.\n"),
-			// UTF8_TO_TCHAR(ResultString(result)));
-			if (!bIsConnected)
-			{
-				FPlatformProcess::Sleep(0.1f);
-				continue;
-			}
-			else
-			{
-				continue;
-			}
-		}
-
-		switch (Msg.type)
-		{
-			case eLeapEventType_Connection:
-				HandleConnectionEvent(Msg.connection_event);
-				break;
-			case eLeapEventType_ConnectionLost:
-				HandleConnectionLostEvent(Msg.connection_lost_event);
-				break;
-			case eLeapEventType_Device:
-				HandleDeviceEvent(Msg.device_event);
-				break;
-			case eLeapEventType_DeviceLost:
-				HandleDeviceLostEvent(Msg.device_event);
-				break;
-			case eLeapEventType_DeviceFailure:
-				HandleDeviceFailureEvent(Msg.device_failure_event, Msg.device_id);
-				break;
-			case eLeapEventType_Tracking:
-				HandleTrackingEvent(Msg.tracking_event, Msg.device_id);
-				break;
-			case eLeapEventType_Image:
-				HandleImageEvent(Msg.image_event, Msg.device_id);
-				break;
-			case eLeapEventType_LogEvent:
-				HandleLogEvent(Msg.log_event, Msg.device_id);
-				break;
-			case eLeapEventType_Policy:
-				HandlePolicyEvent(Msg.policy_event, Msg.device_id);
-				break;
-			case eLeapEventType_TrackingMode:
-				HandleTrackingModeEvent(Msg.tracking_mode_event, Msg.device_id);
-				break;
-			case eLeapEventType_ConfigChange:
-				HandleConfigChangeEvent(Msg.config_change_event, Msg.device_id);
-				break;
-			case eLeapEventType_ConfigResponse:
-				HandleConfigResponseEvent(Msg.config_response_event, Msg.device_id);
-				break;
-			default:
-				// discard unknown message types
-				// UE_LOG(UltraleapTrackingLog, Log, TEXT("Unhandled message type %i."), (int32)Msg.type);
-				break;
-		}	 // switch on msg.type
-	}		 // end while running
+		case eLeapEventType_ConnectionLost:
+			HandleConnectionLostEvent(Msg.connection_lost_event);
+			break;
+		case eLeapEventType_Device:
+			HandleDeviceEvent(Msg.device_event);
+			break;
+		case eLeapEventType_DeviceLost:
+			HandleDeviceLostEvent(Msg.device_event);
+			break;
+		case eLeapEventType_DeviceFailure:
+			HandleDeviceFailureEvent(Msg.device_failure_event, Msg.device_id);
+			break;
+		case eLeapEventType_Tracking:
+			Recorder->Enqueue(Msg.tracking_event, Msg.device_id);
+			HandleTrackingEvent(Msg.tracking_event, Msg.device_id);
+			break;
+		case eLeapEventType_DroppedFrame:
+			HandleDroppedFrameEvent(Msg.dropped_frame_event, Msg.device_id);
+			break;
+		case eLeapEventType_Image:
+			HandleImageEvent(Msg.image_event, Msg.device_id);
+			break;
+		case eLeapEventType_LogEvent:
+			HandleLogEvent(Msg.log_event, Msg.device_id);
+			break;
+		case eLeapEventType_Policy:
+			HandlePolicyEvent(Msg.policy_event, Msg.device_id);
+			break;
+		case eLeapEventType_TrackingMode:
+			HandleTrackingModeEvent(Msg.tracking_mode_event, Msg.device_id);
+			break;
+		case eLeapEventType_ConfigChange:
+			HandleConfigChangeEvent(Msg.config_change_event, Msg.device_id);
+			break;
+		case eLeapEventType_ConfigResponse:
+			HandleConfigResponseEvent(Msg.config_response_event, Msg.device_id);
+			break;
+		default:
+			// discard unknown message types
+			// UE_LOG(UltraleapTrackingLog, Log, TEXT("Unhandled message type %i."), (int32)Msg.type);
+			break;
+	}	 // switch on msg.type
 }
 void FLeapWrapper::GetDeviceSerials(TArray<FString>& DeviceSerials)
 {
@@ -878,11 +885,15 @@ IHandTrackingWrapper* FLeapWrapper::GetDevice(
 void FLeapWrapper::TickDevices(const float DeltaTime) 
 {
 	// safe point to cleanup force deleted devices
-	for (IHandTrackingWrapper* DeviceToRemove : DevicesToCleanup)
+	TArray<IHandTrackingWrapper*> BadDevices;
+	{
+		FScopeLock ScopeLock(&DevicesToCleanupLock);
+		Swap(BadDevices, DevicesToCleanup);
+	}
+	for (IHandTrackingWrapper* DeviceToRemove : BadDevices)
 	{
 		RemoveDevice(DeviceToRemove->GetDeviceID());
 	}
-	DevicesToCleanup.Empty();
 	TArray<IHandTrackingWrapper*> AllDevices;
 
 	// tick real devices first
@@ -908,12 +919,86 @@ void FLeapWrapper::TickSendControllerEventsOnDevices()
 	AllDevices.Append(Devices);
 	AllDevices.Append(CombinedDevices);
 
+	if (AllDevices.Num() < 2 || !CVarLeapParallelDeviceCapture.GetValueOnGameThread())
+	{
+		for (auto Device : AllDevices)
+		{
+			auto InternalDevice = Device->GetDevice();
+			if (InternalDevice)
+			{
+				InternalDevice->SendControllerEvents();
+			}
+		}
+		return;
+	}
+
+	// Capture, interpolation and transforms are independent per device, so each runs as its own task. Combined devices
+	// read their sources' frames and wait on those tasks. Everything is done before the events go out below
+	FGraphEventArray AllTasks;
+	TArray<FGraphEventRef> SourceTasks;
+	SourceTasks.SetNum(Devices.Num());
+	for (int32 Index = 0; Index < Devices.Num(); ++Index)
+	{
+		IHandTrackingDevice* InternalDevice = Devices[Index]->GetDevice();
+		if (!InternalDevice)
+		{
+			continue;
+		}
+		bool bIsCombinerSource = false;
+		for (IHandTrackingWrapper* CombinedDevice : CombinedDevices)
+		{
+			bIsCombinerSource |= CombinedDevice->ContainsDevice(Devices[Index]);
+		}
+		// Build the Blueprint frame up front when combiners will read it, they may do so concurrently
+		auto Capture = [InternalDevice, bIsCombinerSource]() {
+			InternalDevice->CaptureInput();
+			if (bIsCombinerSource)
+			{
+				InternalDevice->GetLatestFrameSnapshot();
+			}
+		};
+		if (!InternalDevice->CanCaptureOffGameThread())
+		{
+			Capture();
+			continue;
+		}
+		SourceTasks[Index] = FFunctionGraphTask::CreateAndDispatchWhenReady(MoveTemp(Capture),
+			GET_STATID(STAT_LeapDeviceCaptureTask), nullptr, ENamedThreads::AnyHiPriThreadHiPriTask);
+		AllTasks.Add(SourceTasks[Index]);
+	}
+	for (IHandTrackingWrapper* CombinedDevice : CombinedDevices)
+	{
+		IHandTrackingDevice* InternalDevice = CombinedDevice->GetDevice();
+		if (!InternalDevice)
+		{
+			continue;
+		}
+		FGraphEventArray Prerequisites;
+		for (int32 Index = 0; Index < Devices.Num(); ++Index)
+		{
+			if (SourceTasks[Index].IsValid() && CombinedDevice->ContainsDevice(Devices[Index]))
+			{
+				Prerequisites.Add(SourceTasks[Index]);
+			}
+		}
+		if (!InternalDevice->CanCaptureOffGameThread())
+		{
+			FTaskGraphInterface::Get().WaitUntilTasksComplete(Prerequisites, ENamedThreads::GameThread);
+			InternalDevice->CaptureInput();
+			continue;
+		}
+		AllTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([InternalDevice]() { InternalDevice->CaptureInput(); },
+			GET_STATID(STAT_LeapDeviceCaptureTask), &Prerequisites, ENamedThreads::AnyHiPriThreadHiPriTask));
+	}
+	FTaskGraphInterface::Get().WaitUntilTasksComplete(AllTasks, ENamedThreads::GameThread);
+
+	// same order as the serial path
 	for (auto Device : AllDevices)
 	{
 		auto InternalDevice = Device->GetDevice();
 		if (InternalDevice)
 		{
-			InternalDevice->SendControllerEvents();
+			InternalDevice->EmitInputEvents();
 		}
 	}
 }
@@ -979,7 +1064,9 @@ void FLeapWrapper::CleanupCombinedDevicesReferencingDevice(IHandTrackingWrapper*
 }
 void FLeapWrapper::CleanupBadDevice(IHandTrackingWrapper* DeviceWrapper)
 {
-	 DevicesToCleanup.AddUnique(DeviceWrapper);
+	// parallel capture reports bad devices from several task graph workers at once
+	FScopeLock ScopeLock(&DevicesToCleanupLock);
+	DevicesToCleanup.AddUnique(DeviceWrapper);
 }
 void FLeapWrapper::AddOpenXRDevice(LeapWrapperCallbackInterface* InCallbackDelegate)
 {
@@ -1003,4 +1090,28 @@ void FLeapWrapper::AddOpenXRDevice(LeapWrapperCallbackInterface* InCallbackDeleg
 	UE_LOG(
 		UltraleapTrackingLog, Log, TEXT("Add OpenXR Device %s %d."), *(Device->GetDeviceSerial()), Device->GetDeviceID());
 }
+bool FLeapWrapper::StartRecording(const FString& FilePath, const uint32_t DeviceID)
+{
+	return Recorder->Start(FilePath, DeviceID);
+}
+void FLeapWrapper::StopRecording()
+{
+	Recorder->Stop();
+}
+// Must be called from the game thread
+IHandTrackingWrapper* FLeapWrapper::AddRecordingDevice(const FString& FilePath, const float PlaybackSpeed, const bool bLoop)
+{
+	IHandTrackingWrapper* Device = new FLeapRecordingPlaybackWrapper(FilePath, PlaybackSpeed, bLoop);
+
+	if (!Device->IsConnected())
+	{
+		delete Device;
+		return nullptr;
+	}
+	Devices.Add(Device);
+
+	NotifyDeviceAdded(Device);
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Add Recording Device %s %d."), *(Device->GetDeviceSerial()), Device->GetDeviceID());
+	return Device;
+}
 #pragma endregion LeapC Wrapper
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "DeviceCombiner.h"
 #include "LeapAsync.h"
+#include "LeapGameThreadQueue.h"
 #include "LeapUtility.h"
 #include "FUltraleapCombinedDevice.h"
 #include "FUltraleapCombinedDeviceAngular.h"
@@ -190,7 +191,7 @@ void FDeviceCombiner::CleanupLastDevice()
 
 
 
-/** Called by ServiceMessageLoop() when a tracking event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a tracking event is returned by LeapPollConnection(). */
 void FDeviceCombiner::HandleTrackingEvent(const LEAP_TRACKING_EVENT* TrackingEvent)
 {
 }
@@ -205,21 +206,16 @@ void FDeviceCombiner::HandleImageEvent(const LEAP_IMAGE_EVENT* ImageEvent)
 	}
 }
 
-/** Called by ServiceMessageLoop() when a log event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a log event is returned by LeapPollConnection(). */
 void FDeviceCombiner::HandleLogEvent(const LEAP_LOG_EVENT* LogEvent)
 {
 	if (CallbackDelegate)
 	{
-		TaskRefLog = FLeapAsync::RunShortLambdaOnGameThread([LogEvent, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnLog(LogEvent->severity, LogEvent->timestamp, LogEvent->message);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueLog(CallbackDelegate, LogEvent->severity, LogEvent->timestamp, LogEvent->message);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a policy event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a policy event is returned by LeapPollConnection(). */
 void FDeviceCombiner::HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent)
 {
 	if (CallbackDelegate)
@@ -227,16 +223,11 @@ void FDeviceCombiner::HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent)
 		// this is always coming back as 0, this means either the Leap service refused to set any flags?
 		// or there's a bug in the policy notification system with Leap Motion V4.
 		const uint32_t CurrentPolicy = PolicyEvent->current_policy;
-		TaskRefPolicy = FLeapAsync::RunShortLambdaOnGameThread([CurrentPolicy, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnPolicy(CurrentPolicy);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueuePolicy(CallbackDelegate, CurrentPolicy);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a policy event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a policy event is returned by LeapPollConnection(). */
 void FDeviceCombiner::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT* TrackingModeEvent)
 {
 	if (CallbackDelegate)
@@ -244,40 +235,26 @@ void FDeviceCombiner::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT* Tr
 		// this is always coming back as 0, this means either the Leap service refused to set any flags?
 		// or there's a bug in the policy notification system with Leap Motion V4.
 		const uint32_t CurrentMode = TrackingModeEvent->current_tracking_mode;
-		TaskRefPolicy = FLeapAsync::RunShortLambdaOnGameThread([CurrentMode, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnTrackingMode((eLeapTrackingMode) CurrentMode);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueTrackingMode(CallbackDelegate, (eLeapTrackingMode) CurrentMode);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a config change event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a config change event is returned by LeapPollConnection(). */
 void FDeviceCombiner::HandleConfigChangeEvent(const LEAP_CONFIG_CHANGE_EVENT* ConfigChangeEvent)
 {
 	if (CallbackDelegate)
 	{
-		TaskRefConfigChange = FLeapAsync::RunShortLambdaOnGameThread([ConfigChangeEvent, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnConfigChange(ConfigChangeEvent->requestID, ConfigChangeEvent->status);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueConfigChange(CallbackDelegate, ConfigChangeEvent->requestID, ConfigChangeEvent->status);
 	}
 }
 
-/** Called by ServiceMessageLoop() when a config response event is returned by LeapPollConnection(). */
+/** Called by FLeapWrapper::HandleConnectionMessage() when a config response event is returned by LeapPollConnection(). */
 void FDeviceCombiner::HandleConfigResponseEvent(const LEAP_CONFIG_RESPONSE_EVENT* ConfigResponseEvent)
 {
 	if (CallbackDelegate)
 	{
-		TaskRefConfigResponse = FLeapAsync::RunShortLambdaOnGameThread([ConfigResponseEvent, this] {
-			if (CallbackDelegate)
-			{
-				CallbackDelegate->OnConfigResponse(ConfigResponseEvent->requestID, ConfigResponseEvent->value);
-			}
-		});
+		FLeapGameThreadQueue::Get().EnqueueConfigResponse(
+			CallbackDelegate, ConfigResponseEvent->requestID, ConfigResponseEvent->value);
 	}
 }
 bool FDeviceCombiner::MatchDevices(const TArray<FString> DeviceSerials, const ELeapDeviceCombinerClass DeviceCombinerClassIn)
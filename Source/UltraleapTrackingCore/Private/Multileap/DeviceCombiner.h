@@ -100,20 +100,6 @@ private:
 
 	FThreadSafeBool bIsRunning;
 
-	// TaskGraph event references are only stored to help with threading debug for now.
-	FGraphEventRef TaskRefConnection;
-	FGraphEventRef TaskRefConnectionLost;
-	FGraphEventRef TaskRefDeviceFound;
-	FGraphEventRef TaskRefDeviceLost;
-	FGraphEventRef TaskRefDeviceFailure;
-	FGraphEventRef TaskRefTracking;
-	FGraphEventRef TaskRefImageComplete;
-	FGraphEventRef TaskRefImageError;
-	FGraphEventRef TaskRefLog;
-	FGraphEventRef TaskRefPolicy;
-	FGraphEventRef TaskRefConfigChange;
-	FGraphEventRef TaskRefConfigResponse;
-
 	IHandTrackingWrapper* Connector;
 
 	// manages per device functionality in the same way as InputDevice used to
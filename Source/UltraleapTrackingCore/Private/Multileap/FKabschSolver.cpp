@@ -8,135 +8,274 @@
 
 #include "FKabschSolver.h"
 
+#include "Math/RandomStream.h"
 
-FKabschSolver::FKabschSolver()
+namespace
 {
-	DataCovariance.AddZeroed(3);
-	Translation = FVector::ZeroVector;
-	OptimalRotation = FQuat::Identity;
-}
-FMatrix FKabschSolver::SolveKabsch(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints,
-	const int OptimalRotationIterations , const bool SolveScale)
+// Jacobi converges quadratically, a 4x4 is at double precision after three or four sweeps
+const int32 MaxJacobiSweeps = 16;
+const int32 RobustSampleSize = 3;
+const int32 RobustSeed = 0x4b616273;
+
+template <typename FunctionType>
+void ForEachPoint(const int32 NumPoints, const TArray<int32>* Indices, FunctionType&& Function)
 {
-	if (InPoints.Num() != RefPoints.Num())
+	if (Indices)
 	{
-		return FMatrix::Identity;
+		for (const int32 Index : *Indices)
+		{
+			Function(Index);
+		}
+		return;
 	}
-	
-	TArray<FVector> InPts(InPoints);
-	TArray<FVector> RefPts(RefPoints);
-
-	// Calculate the centroid offset and construct the centroid-shifted point matrices
-	FVector InCentroid = FVector::ZeroVector;
-	FVector RefCentroid = FVector::ZeroVector;
-
-	for (int i = 0; i < InPts.Num(); i++)
+	for (int32 Index = 0; Index < NumPoints; ++Index)
 	{
-		InCentroid += InPts[i];
-		RefCentroid += RefPts[i];
+		Function(Index);
 	}
-	InCentroid /= InPts.Num();
-	RefCentroid /= RefPts.Num();
+}
+
+/** Eigenvector of the largest eigenvalue of the symmetric matrix N, which is destroyed */
+void LargestEigenvector(double N[4][4], double OutVector[4])
+{
+	double V[4][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
 
-	for (int i = 0; i < InPts.Num(); i++)
+	double Norm = 0;
+	for (int32 Row = 0; Row < 4; ++Row)
 	{
-		InPts[i] -= InCentroid;
-		RefPts[i] -= RefCentroid;
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			Norm += N[Row][Column] * N[Row][Column];
+		}
 	}
 
-	// why is this (translation) never used - same in Unity, for debug?
-	Translation = RefCentroid - InCentroid;
-
-	// Calculate the scale ratio
-	if (SolveScale && InPoints.Num() > 1)
+	for (int32 Sweep = 0; Sweep < MaxJacobiSweeps; ++Sweep)
 	{
-		float InScale = 0.0f, RefScale = 0.0f;
+		double OffDiagonal = 0;
+		for (int32 P = 0; P < 3; ++P)
+		{
+			for (int32 Q = P + 1; Q < 4; ++Q)
+			{
+				OffDiagonal += N[P][Q] * N[P][Q];
+			}
+		}
+		if (OffDiagonal <= Norm * 1e-30)
+		{
+			break;
+		}
 
-		for (int i = 0; i < InPoints.Num(); i++)
+		for (int32 P = 0; P < 3; ++P)
 		{
-			InScale += (FVector(InPoints[i].X, InPoints[i].Y, InPoints[i].Z) - InCentroid).Size();
-			RefScale += (FVector(RefPoints[i].X, RefPoints[i].Y, RefPoints[i].Z) - RefCentroid).Size();
+			for (int32 Q = P + 1; Q < 4; ++Q)
+			{
+				if (N[P][Q] == 0)
+				{
+					continue;
+				}
+				// rotation in the PQ plane that zeroes N[P][Q]
+				const double Theta = (N[Q][Q] - N[P][P]) / (2 * N[P][Q]);
+				const double T = (Theta >= 0 ? 1 : -1) / (FMath::Abs(Theta) + FMath::Sqrt(Theta * Theta + 1));
+				const double C = 1 / FMath::Sqrt(T * T + 1);
+				const double S = T * C;
+
+				for (int32 K = 0; K < 4; ++K)
+				{
+					const double KP = N[K][P];
+					const double KQ = N[K][Q];
+					N[K][P] = C * KP - S * KQ;
+					N[K][Q] = S * KP + C * KQ;
+				}
+				for (int32 K = 0; K < 4; ++K)
+				{
+					const double PK = N[P][K];
+					const double QK = N[Q][K];
+					N[P][K] = C * PK - S * QK;
+					N[Q][K] = S * PK + C * QK;
+				}
+				for (int32 K = 0; K < 4; ++K)
+				{
+					const double KP = V[K][P];
+					const double KQ = V[K][Q];
+					V[K][P] = C * KP - S * KQ;
+					V[K][Q] = S * KP + C * KQ;
+				}
+			}
 		}
-		ScaleRatio = (RefScale / InScale);
-	}
-	else
-	{
-		ScaleRatio = 1.0f;
 	}
 
-	if (InPoints.Num() != 1)
+	int32 Largest = 0;
+	for (int32 Index = 1; Index < 4; ++Index)
 	{
-		// Calculate the covariance matrix, is a 3x3 Matrix and Calculate the optimal rotation
-		TransposeMult(InPts, RefPts, DataCovariance);
-		ExtractRotation(DataCovariance, OptimalRotation, OptimalRotationIterations);
-		
-		
-		/* UE_LOG(UltraleapTrackingLog, Log,
-			TEXT("Kabsch Rotation P %f Y %f R %f"), OptimalRotation.Rotator().Pitch, OptimalRotation.Rotator().Yaw,
-				OptimalRotation.Rotator().Roll);
-		*/
-		 //OptimalRotation = FQuat::Identity;
+		if (N[Index][Index] > N[Largest][Largest])
+		{
+			Largest = Index;
+		}
 	}
-	else
+	for (int32 Index = 0; Index < 4; ++Index)
 	{
-		OptimalRotation = FQuat::Identity;
+		OutVector[Index] = V[Index][Largest];
 	}
-	FScaleRotationTranslationMatrix TSR1(FVector::OneVector * ScaleRatio, FRotator::ZeroRotator, RefCentroid);
-	FScaleRotationTranslationMatrix TSR2(FVector::OneVector, OptimalRotation.Rotator(), FVector::ZeroVector);
-	FScaleRotationTranslationMatrix TSR3(FVector::OneVector, FRotator::ZeroRotator, -InCentroid);
-	return TSR1 * TSR2 * TSR3;
 }
-void FillMatrixFromQuaternion(const FQuat& Q, TArray<FVector>& Matrix)
+}	 // namespace
+
+FKabschSolver::FKabschSolver()
 {
-	Matrix[0] = Q * FVector::ForwardVector;
-	Matrix[1] = Q * FVector::RightVector;	   // In Unity Up
-	Matrix[2] = Q * FVector::UpVector;			// In Unity Forward
+	Translation = FVector::ZeroVector;
+	OptimalRotation = FQuat::Identity;
 }
-void FKabschSolver::ExtractRotation(const TArray<FVector>& A, FQuat& Q, const int OptimalRotationIterations)
+FMatrix FKabschSolver::SolveKabsch(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const bool SolveScale)
 {
-	TArray<FVector> QuatBasis;
-	QuatBasis.AddZeroed(3);
+	return Solve(InPoints, RefPoints, TArray<float>(), nullptr, SolveScale);
+}
+FMatrix FKabschSolver::SolveKabsch(
+	const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const TArray<float>& Weights, const bool SolveScale)
+{
+	return Solve(InPoints, RefPoints, Weights, nullptr, SolveScale);
+}
+FMatrix FKabschSolver::SolveKabschRobust(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints,
+	const TArray<float>& Weights, const float InlierDistance, int32& OutNumInliers, const int32 NumSamples,
+	const bool SolveScale)
+{
+	OutNumInliers = 0;
+	const int32 NumPoints = InPoints.Num();
+	if (NumPoints != RefPoints.Num() || (Weights.Num() > 0 && Weights.Num() != NumPoints))
+	{
+		return FMatrix::Identity;
+	}
+	// nothing to vote with
+	if (NumPoints <= RobustSampleSize)
+	{
+		OutNumInliers = NumPoints;
+		return Solve(InPoints, RefPoints, Weights, nullptr, SolveScale);
+	}
 
-	for (int Iter = 0; Iter < OptimalRotationIterations; Iter++)
+	FRandomStream Random(RobustSeed);
+	float BestResidual = 0;
+	ScratchBestInliers.Reset();
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
 	{
-		FillMatrixFromQuaternion(Q, QuatBasis);
-
-		
-		FVector Omega = (	FVector::CrossProduct(QuatBasis[0], A[0]) + 
-							FVector::CrossProduct(QuatBasis[1], A[1]) +
-							FVector::CrossProduct(QuatBasis[2], A[2])) *
-		(1.0f / FMath::Abs(	FVector::DotProduct(QuatBasis[0], A[0]) + 
-							FVector::DotProduct(QuatBasis[1], A[1]) +
-							FVector::DotProduct(QuatBasis[2], A[2]) + 0.000000001f));
-
-		float W = Omega.Size();
-		if (W < 0.000000001f)
+		ScratchSample.Reset();
+		while (ScratchSample.Num() < RobustSampleSize)
 		{
-			break;
+			ScratchSample.AddUnique(Random.RandRange(0, NumPoints - 1));
+		}
+		const FMatrix Candidate = Solve(InPoints, RefPoints, Weights, &ScratchSample, SolveScale);
+		const float Residual = FindInliers(InPoints, RefPoints, Candidate, InlierDistance, ScratchInliers);
+		if (ScratchInliers.Num() > ScratchBestInliers.Num() ||
+			(ScratchInliers.Num() == ScratchBestInliers.Num() && Residual < BestResidual))
+		{
+			Swap(ScratchInliers, ScratchBestInliers);
+			BestResidual = Residual;
 		}
-		FVector NormalizedAngleAxisInput = Omega / W;
+	}
 
-		NormalizedAngleAxisInput.Normalize();
-		
-		FQuat AngleAxis(NormalizedAngleAxisInput, W);
-		Q = AngleAxis * Q;
-		Q.Normalize();
+	// no subset agreed on anything, better a least squares fit than a fit to three arbitrary points
+	if (ScratchBestInliers.Num() < RobustSampleSize)
+	{
+		const FMatrix Transform = Solve(InPoints, RefPoints, Weights, nullptr, SolveScale);
+		FindInliers(InPoints, RefPoints, Transform, InlierDistance, ScratchInliers);
+		OutNumInliers = ScratchInliers.Num();
+		return Transform;
 	}
+	OutNumInliers = ScratchBestInliers.Num();
+	return Solve(InPoints, RefPoints, Weights, &ScratchBestInliers, SolveScale);
 }
-
-void FKabschSolver::TransposeMult(
-	const TArray<FVector>& Vec1, const TArray<FVector>& Vec2, TArray<FVector>& Covariance)
+float FKabschSolver::FindInliers(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints,
+	const FMatrix& Transform, const float InlierDistance, TArray<int32>& OutInliers) const
 {
-	for (int i = 0; i < 3; i++)
-	{	
-		// i is the row in this matrix
-		Covariance[i] = FVector::ZeroVector;
-		for (int j = 0; j < 3; j++)
-		{	 // j is the column in the other matrix
-			for (int k = 0; k < Vec1.Num(); k++)
-			{	 // k is the column in this matrix
-				Covariance[i][j] += Vec1[k][i] * Vec2[k][j];
+	OutInliers.Reset();
+	const float InlierDistanceSquared = InlierDistance * InlierDistance;
+	float Residual = 0;
+	for (int32 Index = 0; Index < InPoints.Num(); ++Index)
+	{
+		const float DistanceSquared = FVector::DistSquared(Transform.TransformPosition(InPoints[Index]), RefPoints[Index]);
+		if (DistanceSquared <= InlierDistanceSquared)
+		{
+			OutInliers.Add(Index);
+			Residual += DistanceSquared;
+		}
+	}
+	return Residual;
+}
+FMatrix FKabschSolver::Solve(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints,
+	const TArray<float>& Weights, const TArray<int32>* Indices, const bool SolveScale)
+{
+	const int32 NumPoints = InPoints.Num();
+	if (NumPoints != RefPoints.Num() || (Weights.Num() > 0 && Weights.Num() != NumPoints))
+	{
+		return FMatrix::Identity;
+	}
+	auto GetWeight = [&Weights](const int32 Index) { return Weights.Num() > 0 ? FMath::Max(Weights[Index], 0.f) : 1.f; };
+
+	// Weighted centroids, the points are read in place rather than copied and shifted
+	FVector InCentroid = FVector::ZeroVector;
+	FVector RefCentroid = FVector::ZeroVector;
+	float TotalWeight = 0;
+	int32 NumWeighted = 0;
+	ForEachPoint(NumPoints, Indices, [&](const int32 Index) {
+		const float Weight = GetWeight(Index);
+		InCentroid += InPoints[Index] * Weight;
+		RefCentroid += RefPoints[Index] * Weight;
+		TotalWeight += Weight;
+		NumWeighted += Weight > 0 ? 1 : 0;
+	});
+	if (TotalWeight <= 0)
+	{
+		return FMatrix::Identity;
+	}
+	InCentroid /= TotalWeight;
+	RefCentroid /= TotalWeight;
+
+	// why is this (translation) never used - same in Unity, for debug?
+	Translation = RefCentroid - InCentroid;
+
+	// Cross covariance of the centred points, Covariance[A][B] = sum of In.A * Ref.B
+	double Covariance[3][3] = {};
+	float InScale = 0.0f;
+	float RefScale = 0.0f;
+	ForEachPoint(NumPoints, Indices, [&](const int32 Index) {
+		const float Weight = GetWeight(Index);
+		const FVector In = InPoints[Index] - InCentroid;
+		const FVector Ref = RefPoints[Index] - RefCentroid;
+		for (int32 A = 0; A < 3; ++A)
+		{
+			for (int32 B = 0; B < 3; ++B)
+			{
+				Covariance[A][B] += (double) Weight * In[A] * Ref[B];
 			}
 		}
+		InScale += Weight * In.Size();
+		RefScale += Weight * Ref.Size();
+	});
+
+	// Calculate the scale ratio
+	ScaleRatio = SolveScale && NumWeighted > 1 && InScale > 0 ? RefScale / InScale : 1.0f;
+
+	if (NumWeighted > 1)
+	{
+		// Horn, "Closed-form solution of absolute orientation using unit quaternions", 1987. The unit quaternion
+		// (W, X, Y, Z) rotating In onto Ref maximises q'Nq, so it is N's eigenvector of the largest eigenvalue
+		const double Sxx = Covariance[0][0], Sxy = Covariance[0][1], Sxz = Covariance[0][2];
+		const double Syx = Covariance[1][0], Syy = Covariance[1][1], Syz = Covariance[1][2];
+		const double Szx = Covariance[2][0], Szy = Covariance[2][1], Szz = Covariance[2][2];
+		double N[4][4] = {
+			{Sxx + Syy + Szz, Syz - Szy, Szx - Sxz, Sxy - Syx},
+			{Syz - Szy, Sxx - Syy - Szz, Sxy + Syx, Szx + Sxz},
+			{Szx - Sxz, Sxy + Syx, -Sxx + Syy - Szz, Syz + Szy},
+			{Sxy - Syx, Szx + Sxz, Syz + Szy, -Sxx - Syy + Szz},
+		};
+		double Q[4];
+		LargestEigenvector(N, Q);
+		OptimalRotation = FQuat(Q[1], Q[2], Q[3], Q[0]);
+		OptimalRotation.Normalize();
+	}
+	else
+	{
+		OptimalRotation = FQuat::Identity;
 	}
-}
\ No newline at end of file
+
+	// Row vectors, so applied left to right: centre In, rotate, then scale about and move onto the Ref centroid
+	FScaleRotationTranslationMatrix TSR1(FVector::OneVector * ScaleRatio, FRotator::ZeroRotator, RefCentroid);
+	FScaleRotationTranslationMatrix TSR2(FVector::OneVector, OptimalRotation.Rotator(), FVector::ZeroVector);
+	FScaleRotationTranslationMatrix TSR3(FVector::OneVector, FRotator::ZeroRotator, -InCentroid);
+	return TSR3 * TSR2 * TSR1;
+}
@@ -27,32 +27,49 @@ public:
 	}
 };
 
+/**
+ * Rigid (optionally scaled) fit of InPoints onto RefPoints. The rotation is Horn's closed-form quaternion, the
+ * eigenvector of the largest eigenvalue of the 4x4 matrix built from the cross covariance, so a solve costs one pass
+ * over the points and gives the same answer every time.
+ */
 class FKabschSolver
 {
 public:
 	FKabschSolver();
-	
-	FMatrix SolveKabsch(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints,
-		const int OptimalRotationIterations = 9,
+
+	/** Returns the transform taking InPoints onto RefPoints, identity if the sets don't match or are empty */
+	FMatrix SolveKabsch(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const bool SolveScale = false);
+	/** As above with a weight per point (e.g. joint confidences), points with zero weight are ignored.
+	 * Empty Weights weighs every point the same */
+	FMatrix SolveKabsch(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const TArray<float>& Weights,
 		const bool SolveScale = false);
+	/**
+	 * Outlier rejecting fit for calibration, where one device may be tracking a joint badly. Fits NumSamples random three
+	 * point subsets, keeps the one that brings the most points within InlierDistance of their reference and refits on
+	 * those. The samples come from a fixed seed so the result is repeatable. OutNumInliers is the size of the refit set
+	 */
+	FMatrix SolveKabschRobust(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const TArray<float>& Weights,
+		const float InlierDistance, int32& OutNumInliers, const int32 NumSamples = 32, const bool SolveScale = false);
 
 	FVector& GetTranslation()
 	{
 		return Translation;
 	}
 
-protected:
-		// https://animation.rwth-aachen.de/media/papers/2016-MIG-StableRotation.pdf
-		void ExtractRotation(const TArray<FVector>& A, FQuat& Q, const int OptimalRotationIterations = 9);
-
 private:
-	// Calculate Covariance Matrices --------------------------------------------------
-	void TransposeMult(const TArray<FVector>& Vec1, const TArray<FVector>& Vec2, TArray<FVector>& Covariance);
-	
+	/** Solves over the points in Indices, or all of them when null. Weights may be empty */
+	FMatrix Solve(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const TArray<float>& Weights,
+		const TArray<int32>* Indices, const bool SolveScale);
+	/** Indices of the points Transform brings within InlierDistance, returns the summed squared distance of those */
+	float FindInliers(const TArray<FVector>& InPoints, const TArray<FVector>& RefPoints, const FMatrix& Transform,
+		const float InlierDistance, TArray<int32>& OutInliers) const;
 
-	
-	TArray<FVector> DataCovariance;
 	FVector Translation = FVector::ZeroVector;
 	FQuat OptimalRotation = FQuat::Identity;
 	float ScaleRatio = 1.0f;
+
+	// reused by SolveKabschRobust
+	TArray<int32> ScratchSample;
+	TArray<int32> ScratchInliers;
+	TArray<int32> ScratchBestInliers;
 };
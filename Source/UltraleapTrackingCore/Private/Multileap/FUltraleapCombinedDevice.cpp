@@ -8,6 +8,13 @@
 
 #include "FUltraleapCombinedDevice.h"
 
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarLeapCombinerTimeAlignment(TEXT("leap.CombinerTimeAlignment"), 1,
+	TEXT("Resample every LeapC source of a combined device to the newest source frame's timestamp before merging, "
+		 "from the source's frame history. 0 merges each source's latest captured frame as is."),
+	ECVF_Default);
+
 int FUltraleapCombinedDevice::HandID = 0;
 
 
@@ -26,16 +33,22 @@ FUltraleapCombinedDevice::~FUltraleapCombinedDevice()
 }
 void FUltraleapCombinedDevice::TransformFrame(
 	FLeapFrameData& OutData, const FVector& TranslationOffset, const FRotator& RotationOffset)
-{	
-	OutData.RotateFrame(RotationOffset);
-	OutData.TranslateFrame(TranslationOffset);
+{
+	// rotate then translate, in one pass
+	OutData.TransformFrame(FTransform(RotationOffset, TranslationOffset));
+}
+void FUltraleapCombinedDevice::TransformFrame(
+	FLeapFramePose& OutData, const FVector& TranslationOffset, const FRotator& RotationOffset)
+{
+	OutData.Transform(FTransform(RotationOffset, TranslationOffset));
 }
-// Main loop event emitter and handler
-void FUltraleapCombinedDevice::SendControllerEvents()
+// Main loop capture, events are emitted by the base class
+void FUltraleapCombinedDevice::CaptureInput()
 {
+	bInputEventsPending = false;
+
 	// Create combined frame here and call parse
 	// the parent class will then behave as if it had one device
-	TArray<FLeapFrameData> SourceFrames;
 	FTransform VRDeviceOrigin;
 
 	bool AreAnyVR = false;
@@ -44,8 +57,6 @@ void FUltraleapCombinedDevice::SendControllerEvents()
 		auto InternalSourceDevice = SourceDevice->GetDevice();
 		if (InternalSourceDevice)
 		{
-			FLeapFrameData SourceFrame;
-
 			const bool IsVR = InternalSourceDevice->GetOptions().Mode == LEAP_MODE_VR;
 			if (IsVR)
 			{
@@ -55,48 +66,86 @@ void FUltraleapCombinedDevice::SendControllerEvents()
 			}
 		}
 	}
+	// Sources track at their own phase, so their latest frames can be up to a tracking period apart. Merging those
+	// favours whichever hands are stalest, so sample every source that shares the LeapC clock at the newest timestamp
+	int64 AlignedTimeStamp = 0;
+	if (CVarLeapCombinerTimeAlignment.GetValueOnAnyThread())
+	{
+		for (auto SourceDevice : DevicesToCombine)
+		{
+			auto InternalSourceDevice = SourceDevice->GetDevice();
+			if (InternalSourceDevice && SourceDevice->GetDeviceType() == IHandTrackingWrapper::DEVICE_TYPE_LEAP)
+			{
+				AlignedTimeStamp = FMath::Max(AlignedTimeStamp, InternalSourceDevice->GetCapturedTimeStamp());
+			}
+		}
+	}
+
 	// add combiner logic based on DevicesToCombine List. All devices will have ticked before this is called
+	int32 NumSourceFrames = 0;
 	for (auto SourceDevice : DevicesToCombine)
 	{
 		auto InternalSourceDevice = SourceDevice->GetDevice();
 		if (InternalSourceDevice)
 		{
-			FLeapFrameData SourceFrame;
+			const bool bAligned = AlignedTimeStamp > 0 && SourceDevice->GetDeviceType() == IHandTrackingWrapper::DEVICE_TYPE_LEAP &&
+								  InternalSourceDevice->SamplePoseAtTime(AlignedTimeStamp, ScratchSourcePose);
+			if (!bAligned)
+			{
+				// Borrow the source's shared snapshot and transform a flat copy, rather than deep copying it as frame data
+				FLeapFrameSnapshotPtr Snapshot = InternalSourceDevice->GetLatestFrameSnapshot();
+				if (Snapshot.IsValid())
+				{
+					ScratchSourcePose.SetFromFrameData(*Snapshot);
+				}
+				else
+				{
+					ScratchSourcePose.NumHands = 0;
+				}
+			}
 
 			// For VR/XR mounted devices, the frame here is already transformed by the HMD position
 			// so we don't want to re-apply the device origin as this will transform it twice
 			// BUT the device origin is still required for confidence calcs
 			const bool IsVR = InternalSourceDevice->GetOptions().Mode == LEAP_MODE_VR;
-			const bool IsScreenTop = InternalSourceDevice->GetOptions().Mode == LEAP_MODE_SCREENTOP;
 
-			InternalSourceDevice->GetLatestFrameData(SourceFrame, !IsVR);
-			
 			if (IsVR)
 			{
 				// Transform HMD into Desktop rotation
 				FRotator Rotation(90, 0, 180);
 				FUltraleapCombinedDevice::TransformFrame(
-					SourceFrame,  VRDeviceOrigin.GetLocation(), Rotation.GetInverse());
+					ScratchSourcePose, VRDeviceOrigin.GetLocation(), Rotation.GetInverse());
 			}
-			// comment in for debugging desktop devices only in the combined hand -> 
-			//if (IsScreenTop)
+			else
 			{
-				SourceFrames.Add(SourceFrame);
+				const FTransform& Origin = InternalSourceDevice->GetDeviceOrigin();
+				ScratchSourcePose.Transform(FTransform(Origin.GetRotation(), Origin.GetLocation()));
 			}
+
+			if (ScratchSourceFrames.Num() <= NumSourceFrames)
+			{
+				ScratchSourceFrames.AddDefaulted();
+			}
+			ScratchSourcePose.ToFrameData(ScratchSourceFrames[NumSourceFrames++]);
 		}
 	}
+	ScratchSourceFrames.SetNum(NumSourceFrames);
 	
-	CombineFrame(SourceFrames);
+	CombineFrame(ScratchSourceFrames);
+	// combiners only write the hands
+	CombinedFrame.TimeStamp = AlignedTimeStamp;
+	CurrentPose.SetFromFrameData(CombinedFrame);
 
 	if (AreAnyVR)
 	{
 		// from desktop rotation to HMD rotation
 		FRotator Rotation(90, 0, 180);
-		FUltraleapCombinedDevice::TransformFrame(CurrentFrame,  -Rotation.RotateVector(VRDeviceOrigin.GetLocation()), Rotation);
+		FUltraleapCombinedDevice::TransformFrame(CurrentPose, -Rotation.RotateVector(VRDeviceOrigin.GetLocation()), Rotation);
 	}
 	
 
-	ParseEvents();
+	TransformCurrentPose();
+	bInputEventsPending = true;
 }
 FVector ToLocal(const FVector& WorldPoint,const FVector& LocalOrigin,const FQuat& LocalRot)
 {
@@ -222,17 +271,15 @@ void FUltraleapCombinedDevice::ConvertToWorldSpaceHand(
 void FUltraleapCombinedDevice::CreateLinearJointListInterp(
 	const FLeapHandData& HandA, const FLeapHandData& HandB, TArray<FVector>& Joints, const float Alpha, FVector& PalmPos, FQuat& PalmRot)
 {
-	TArray<FVector> JointsA;
-	TArray<FVector> JointsB;
-
-	Joints.Empty();
+	// Reset keeps the allocations
+	Joints.Reset();
 	Joints.AddZeroed(NumJointPositions);
 
-	JointsA.AddZeroed(NumJointPositions);
-	JointsB.AddZeroed(NumJointPositions);
+	ScratchJointsA.SetNumUninitialized(NumJointPositions);
+	ScratchJointsB.SetNumUninitialized(NumJointPositions);
 
-	CreateLocalLinearJointList(HandA, JointsA);
-	CreateLocalLinearJointList(HandB, JointsB);
+	CreateLocalLinearJointList(HandA, ScratchJointsA);
+	CreateLocalLinearJointList(HandB, ScratchJointsB);
 
 	if (HandA.HandType != HandB.HandType)
 	{
@@ -246,7 +293,7 @@ void FUltraleapCombinedDevice::CreateLinearJointListInterp(
 	
 	for (int i = 0; i < Joints.Num(); i++)
 	{
-		Joints[i] = FMath::Lerp(JointsA[i], JointsB[i], Alpha);
+		Joints[i] = FMath::Lerp(ScratchJointsA[i], ScratchJointsB[i], Alpha);
 	}
 	return;
 }
@@ -18,13 +18,18 @@ public:
 	
 
 	/** Poll for controller state and send events if needed */
-	virtual void SendControllerEvents() override;
+	virtual void CaptureInput() override;
 		
 	// Based on VectorHand.NUM_JOINT_POSITIONS
 	static const int NumJointPositions = 25;
 
 	static void TransformFrame(
 		FLeapFrameData& OutData, const FVector& TranslationOffset, const FRotator& RotationOffset);
+	static void TransformFrame(
+		FLeapFramePose& OutData, const FVector& TranslationOffset, const FRotator& RotationOffset);
+
+	// calls CombineFrame directly
+	friend class FLeapPipelineBenchmark;
 
 protected:
 	// override this in any custom combiners
@@ -33,6 +38,16 @@ protected:
 
 	// the combined devices
 	TArray<IHandTrackingWrapper*> DevicesToCombine;
+	// CombineFrame output, converted into CurrentPose. Value initialised, combiners only write the hands
+	FLeapFrameData CombinedFrame = FLeapFrameData();
+
+	// Scratch kept from tick to tick, so once the hand counts settle combining doesn't allocate.
+	// Frame data is only ever written element-wise (FLeapFramePose::ToFrameData, InitFromEmpty) so the nested digit and
+	// bone arrays are reused, assigning a whole FLeapFrameData or FLeapHandData would rebuild them
+	FLeapFramePose ScratchSourcePose;
+	TArray<FLeapFrameData> ScratchSourceFrames;
+	TArray<FVector> ScratchJointsA;
+	TArray<FVector> ScratchJointsB;
 
 	// Helpers ported from VectorHand.cs, used from multiple Combiners
 	// Equivalent of VectorHand.Encode
@@ -15,8 +15,7 @@ void FUltraleapCombinedDeviceAngular::CombineFrame(const TArray<FLeapFrameData>&
 		return;
 	}
 
-	CurrentFrame.Hands.Empty();
-	MergeHands(SourceFrames, CurrentFrame.Hands, CurrentFrame.LeftHandVisible, CurrentFrame.RightHandVisible);
+	MergeHands(SourceFrames, CombinedFrame.Hands, CombinedFrame.LeftHandVisible, CombinedFrame.RightHandVisible);
 }
 /*
  * Utility function of running average
@@ -36,10 +35,8 @@ void FUltraleapCombinedDeviceAngular::MergeHands(const TArray<FLeapFrameData>& S
 {
 	// Sort Left and Right hands (some values may be null since never know how many hands are visible, but we clean it up at the
 	// end)
-	TArray<const FLeapHandData*> LeftHands;
-	TArray<const FLeapHandData*> RightHands;
-	
-
+	ScratchLeftHands.Reset();
+	ScratchRightHands.Reset();
 
 	for (int i = 0; i < SourceFrames.Num(); i++)
 	{
@@ -47,31 +44,31 @@ void FUltraleapCombinedDeviceAngular::MergeHands(const TArray<FLeapFrameData>& S
 		{
 			if (TempHand.HandType == LEAP_HAND_LEFT)
 			{
-				LeftHands.Add(&TempHand);
+				ScratchLeftHands.Add(&TempHand);
 			}
 			else
 			{
-				RightHands.Add(&TempHand);
+				ScratchRightHands.Add(&TempHand);
 			}
 		}
 	}
 
 	// combine hands using relative angle between devices:
-	FLeapHandData ConfidentLeft;
-	FLeapHandData ConfidentRight;
-
-	const bool LeftValid = AngularInterpolate(LeftHands, Cam1Alpha, LeftAngle, ConfidentLeft);
-	const bool RightValid = AngularInterpolate(RightHands,Cam2Alpha, RightAngle, ConfidentRight);
+	const bool LeftValid = AngularInterpolate(ScratchLeftHands, Cam1Alpha, LeftAngle, ScratchConfidentLeft);
+	const bool RightValid = AngularInterpolate(ScratchRightHands, Cam2Alpha, RightAngle, ScratchConfidentRight);
 
 	// clean up and return hand arrays with only valid hands
+	// hands already in MergedHands are written over rather than rebuilt
+	MergedHands.SetNum((LeftValid ? 1 : 0) + (RightValid ? 1 : 0));
+	int32 HandIndex = 0;
 	if (LeftValid)
 	{
-		MergedHands.Add(ConfidentLeft);
+		MergedHands[HandIndex++].CopyFrom(ScratchConfidentLeft);
 		LeftHandVisible = true;
 	}
 	if (RightValid)
 	{
-		MergedHands.Add(ConfidentRight);
+		MergedHands[HandIndex++].CopyFrom(ScratchConfidentRight);
 		RightHandVisible = true;
 	}
 }
@@ -105,7 +102,7 @@ bool FUltraleapCombinedDeviceAngular::AngularInterpolate(
 		{
 			if (!HandInit)
 			{
-				MergedHand = *Hand;
+				MergedHand.CopyFrom(*Hand);
 				HandInit = true;
 			}
 			else
@@ -165,12 +162,11 @@ bool FUltraleapCombinedDeviceAngular::AngularInterpolate(
 		// Interpolate using alpha:
 		if (NumValidHands > 1)	   // Note: this implementation only works with first 2 hands:
 		{
-			TArray<FVector> JointsCombined;
 			FVector MergedPalmPos;
 			FQuat MergedPalmRot;
 		
-			CreateLinearJointListInterp(*HandList[0], *HandList[1], JointsCombined, Alpha, MergedPalmPos, MergedPalmRot);
-			ConvertToWorldSpaceHand(MergedHand, IsLeft, MergedPalmPos, MergedPalmRot, JointsCombined);
+			CreateLinearJointListInterp(*HandList[0], *HandList[1], ScratchJointsCombined, Alpha, MergedPalmPos, MergedPalmRot);
+			ConvertToWorldSpaceHand(MergedHand, IsLeft, MergedPalmPos, MergedPalmRot, ScratchJointsCombined);
 		}
 	}
 	return HandInit;
@@ -40,6 +40,13 @@ private:
 	FVector MidDevicePointForward;
 	FVector MidDevicePointUp;
 
+	// MergeHands scratch, kept so merging reuses the hand and joint allocations
+	TArray<const FLeapHandData*> ScratchLeftHands;
+	TArray<const FLeapHandData*> ScratchRightHands;
+	FLeapHandData ScratchConfidentLeft;
+	FLeapHandData ScratchConfidentRight;
+	TArray<FVector> ScratchJointsCombined;
+
 	void MergeHands(
 		const TArray<FLeapFrameData>& SourceFrames, TArray<FLeapHandData>& Hands, bool& LeftHandVisible, bool& RightHandVisible);
 	static float AngleSigned(const FVector& V1, const FVector& V2, const FVector& N);
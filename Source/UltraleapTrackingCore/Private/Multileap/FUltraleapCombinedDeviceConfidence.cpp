@@ -40,12 +40,12 @@ float SumFloatArray(const TArray<float>& ToSum, const int NumElements)
 	}
 	return Ret;
 }
-float Sum2DFloatArray(const TArray<TArray<float>>& ToSum, const int Index)
+float Sum2DFloatArray(const TArray<TArray<float>>& ToSum, const int NumRows, const int Index)
 {
 	float Ret = 0;
-	for (auto jValue : ToSum)
+	for (int Row = 0; Row < NumRows; Row++)
 	{
-		Ret += jValue[Index];
+		Ret += ToSum[Row][Index];
 	}
 	return Ret;
 }
@@ -173,20 +173,25 @@ FColourMap* GetColourMapForDevice(AJointOcclusionActor* Actor, IHandTrackingWrap
 }
 void FUltraleapCombinedDeviceConfidence::CombineFrame(const TArray<FLeapFrameData>& SourceFrames)
 {
-	MergeFrames(SourceFrames, CurrentFrame);
+	MergeFrames(SourceFrames, CombinedFrame);
 }
 // direct port from Unity
 void FUltraleapCombinedDeviceConfidence::MergeFrames(const TArray<FLeapFrameData>& SourceFrames, FLeapFrameData& CombinedFrame )
 {	
-	TArray<const FLeapHandData*> LeftHands;
-	TArray<const FLeapHandData*> RightHands;
+	// scratch from the previous tick, joint confidence rows are only ever added so they keep their allocations
+	TArray<const FLeapHandData*>& LeftHands = ScratchLeftHands;
+	TArray<const FLeapHandData*>& RightHands = ScratchRightHands;
 
-	TArray<float> LeftHandConfidences;
-	TArray<float> RightHandConfidences;
+	TArray<float>& LeftHandConfidences = ScratchLeftHandConfidences;
+	TArray<float>& RightHandConfidences = ScratchRightHandConfidences;
 
-	TArray<TArray<float>> LeftJointConfidences;
-	TArray<TArray<float>> RightJointConfidences;
+	TArray<TArray<float>>& LeftJointConfidences = ScratchLeftJointConfidences;
+	TArray<TArray<float>>& RightJointConfidences = ScratchRightJointConfidences;
 
+	LeftHands.Reset();
+	RightHands.Reset();
+	LeftHandConfidences.Reset();
+	RightHandConfidences.Reset();
 
 	// make lists of all left and right hands found in each frame and also make a list of their confidences
 	for (int FrameIdx = 0; FrameIdx < SourceFrames.Num(); FrameIdx++)
@@ -199,25 +204,27 @@ void FUltraleapCombinedDeviceConfidence::MergeFrames(const TArray<FLeapFrameData
 		{
 			if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 			{
-				LeftHands.Add(&Hand);
-
 				float HandConfidence = CalculateHandConfidence(FrameIdx, Hand);
-				TArray<float> JointConfidencesLocal;
-				CalculateJointConfidence(FrameIdx, Hand, JointConfidencesLocal);
+				if (LeftJointConfidences.Num() <= LeftHands.Num())
+				{
+					LeftJointConfidences.AddDefaulted();
+				}
+				CalculateJointConfidence(FrameIdx, Hand, LeftJointConfidences[LeftHands.Num()]);
 
+				LeftHands.Add(&Hand);
 				LeftHandConfidences.Add(HandConfidence);
-				LeftJointConfidences.Add(JointConfidencesLocal);
 			}
 			else
 			{
-				RightHands.Add(&Hand);
-
 				float HandConfidence = CalculateHandConfidence(FrameIdx, Hand);
-				TArray<float> JointConfidencesLocal;
-				CalculateJointConfidence(FrameIdx, Hand, JointConfidencesLocal);
+				if (RightJointConfidences.Num() <= RightHands.Num())
+				{
+					RightJointConfidences.AddDefaulted();
+				}
+				CalculateJointConfidence(FrameIdx, Hand, RightJointConfidences[RightHands.Num()]);
 
+				RightHands.Add(&Hand);
 				RightHandConfidences.Add(HandConfidence);
-				RightJointConfidences.Add(JointConfidencesLocal);
 			}
 		}
 	}
@@ -258,47 +265,47 @@ void FUltraleapCombinedDeviceConfidence::MergeFrames(const TArray<FLeapFrameData
 	// normalize joint confidences:
 	for (int JointIdx = 0; JointIdx < NumJointPositions; JointIdx++)
 	{
-		Sum = Sum2DFloatArray(LeftJointConfidences, JointIdx);
+		Sum = Sum2DFloatArray(LeftJointConfidences, LeftHands.Num(), JointIdx);
 
 		if (Sum != 0)
 		{
-			for (int HandsIdx = 0; HandsIdx < LeftJointConfidences.Num(); HandsIdx++)
+			for (int HandsIdx = 0; HandsIdx < LeftHands.Num(); HandsIdx++)
 			{
 				LeftJointConfidences[HandsIdx][JointIdx] /= Sum;
 			}
 		}
 		else
 		{
-			for (int HandsIdx = 0; HandsIdx < LeftJointConfidences.Num(); HandsIdx++)
+			for (int HandsIdx = 0; HandsIdx < LeftHands.Num(); HandsIdx++)
 			{
-				LeftJointConfidences[HandsIdx][JointIdx] = 1.0f / LeftJointConfidences.Num();
+				LeftJointConfidences[HandsIdx][JointIdx] = 1.0f / LeftHands.Num();
 			}
 		}
 
-		Sum = Sum2DFloatArray(RightJointConfidences, JointIdx);
+		Sum = Sum2DFloatArray(RightJointConfidences, RightHands.Num(), JointIdx);
 		if (Sum != 0)
 		{
-			for (int HandsIdx = 0; HandsIdx < RightJointConfidences.Num(); HandsIdx++)
+			for (int HandsIdx = 0; HandsIdx < RightHands.Num(); HandsIdx++)
 			{
 				RightJointConfidences[HandsIdx][JointIdx] /= Sum;
 			}
 		}
 		else
 		{
-			for (int HandsIdx = 0; HandsIdx < RightJointConfidences.Num(); HandsIdx++)
+			for (int HandsIdx = 0; HandsIdx < RightHands.Num(); HandsIdx++)
 			{
-				RightJointConfidences[HandsIdx][JointIdx] = 1.0f / RightJointConfidences.Num();
+				RightJointConfidences[HandsIdx][JointIdx] = 1.0f / RightHands.Num();
 			}
 		}
 	}
 
-	// combine hands using their confidences
-	TArray<FLeapHandData> MergedHands;
+	// combine hands using their confidences, straight into the combined frame's hands so their arrays are reused
 	bool LeftHandVisible = false;
 	bool RightHandVisible = false;
+	CombinedFrame.Hands.SetNum((LeftHands.Num() > 0 ? 1 : 0) + (RightHands.Num() > 0 ? 1 : 0));
+	int32 MergedHandIndex = 0;
 	if (LeftHands.Num() > 0)
 	{
-		FLeapHandData Hand;
 		LeftHandVisible = true;
 #if PRINT_ONSCREEN_DEBUG
 		if (GEngine)
@@ -308,13 +315,11 @@ void FUltraleapCombinedDeviceConfidence::MergeFrames(const TArray<FLeapFrameData
 			GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, Message);
 		}
 #endif //PRINT_ONSCREEN_DEBUG
-		MergeHands(LeftHands, LeftHandConfidences, LeftJointConfidences, Hand);
-		MergedHands.Add(Hand);
+		MergeHands(LeftHands, LeftHandConfidences, LeftJointConfidences, CombinedFrame.Hands[MergedHandIndex++]);
 	}
 
 	if (RightHands.Num() > 0)
 	{
-		FLeapHandData Hand;
 		RightHandVisible = true;
 #if PRINT_ONSCREEN_DEBUG
 		if (GEngine)
@@ -324,14 +329,11 @@ void FUltraleapCombinedDeviceConfidence::MergeFrames(const TArray<FLeapFrameData
 			GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, Message);
 		}
 #endif
-		MergeHands(RightHands, RightHandConfidences, RightJointConfidences, Hand);
-		MergedHands.Add(Hand);
+		MergeHands(RightHands, RightHandConfidences, RightJointConfidences, CombinedFrame.Hands[MergedHandIndex++]);
 	}
 
-	// create new frame and add merged hands to it
 	// TODO: what about the other members of FLeapFrameData?
-	CombinedFrame.Hands = MergedHands;
-	CombinedFrame.NumberOfHandsVisible = MergedHands.Num();
+	CombinedFrame.NumberOfHandsVisible = CombinedFrame.Hands.Num();
 	CombinedFrame.LeftHandVisible = LeftHandVisible;
 	CombinedFrame.RightHandVisible = RightHandVisible;
 	
@@ -347,7 +349,7 @@ void FUltraleapCombinedDeviceConfidence::AddFrameToTimeVisibleDicts(const TArray
 {
 	bool HandsVisible[2] = {false};
 	
-	for(auto Hand : Frames[FrameIdx].Hands)
+	for(const auto& Hand : Frames[FrameIdx].Hands)
 	{
 		if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 		{
@@ -418,24 +420,11 @@ float FUltraleapCombinedDeviceConfidence::CalculateHandConfidence(int FrameIdx,c
 	}
 
 	// average out new hand confidence with that of the last few frames
-	if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
-	{
-		if (!HandConfidenceHistoriesLeft.Contains(DevicesToCombine[FrameIdx]->GetDevice()))
-		{
-			HandConfidenceHistoriesLeft.Add(DevicesToCombine[FrameIdx]->GetDevice(),FHandConfidenceHistory());
-		}
-		HandConfidenceHistoriesLeft[DevicesToCombine[FrameIdx]->GetDevice()].AddConfidence(Confidence);
-		Confidence = HandConfidenceHistoriesLeft[DevicesToCombine[FrameIdx]->GetDevice()].GetAveragedConfidence();
-	}
-	else
-	{
-		if (!HandConfidenceHistoriesRight.Contains(DevicesToCombine[FrameIdx]->GetDevice()))
-		{
-			HandConfidenceHistoriesRight.Add(DevicesToCombine[FrameIdx]->GetDevice(), FHandConfidenceHistory());
-		}
-		HandConfidenceHistoriesRight[DevicesToCombine[FrameIdx]->GetDevice()].AddConfidence(Confidence);
-		Confidence = HandConfidenceHistoriesRight[DevicesToCombine[FrameIdx]->GetDevice()].GetAveragedConfidence();
-	}
+	TMap<IHandTrackingDevice*, FHandConfidenceHistory>& HandConfidenceHistories =
+		Hand.HandType == EHandType::LEAP_HAND_LEFT ? HandConfidenceHistoriesLeft : HandConfidenceHistoriesRight;
+	FHandConfidenceHistory& HandConfidenceHistory = HandConfidenceHistories.FindOrAdd(DevicesToCombine[FrameIdx]->GetDevice());
+	HandConfidenceHistory.AddConfidence(Confidence);
+	Confidence = HandConfidenceHistory.GetAveragedConfidence();
 
 	return Confidence;
 }
@@ -643,24 +632,16 @@ void FUltraleapCombinedDeviceConfidence::CalculateJointConfidence(
 	}
 
 	// average out new joint confidence with that of the last few frames
-	if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
-	{
-		if (!JointConfidenceHistoriesLeft.Contains(DevicesToCombine[FrameIdx]->GetDevice()))
-		{
-			JointConfidenceHistoriesLeft.Add(DevicesToCombine[FrameIdx]->GetDevice(), FJointConfidenceHistory(NumJointPositions));
-		}
-		JointConfidenceHistoriesLeft[DevicesToCombine[FrameIdx]->GetDevice()].AddConfidences(JointConfidences[idx]);
-		JointConfidences[idx] = JointConfidenceHistoriesLeft[DevicesToCombine[FrameIdx]->GetDevice()].GetAveragedConfidences();
-	}
-	else
+	IHandTrackingDevice* SourceDevice = DevicesToCombine[FrameIdx]->GetDevice();
+	TMap<IHandTrackingDevice*, FJointConfidenceHistory>& JointConfidenceHistories =
+		Hand.HandType == EHandType::LEAP_HAND_LEFT ? JointConfidenceHistoriesLeft : JointConfidenceHistoriesRight;
+	FJointConfidenceHistory* JointConfidenceHistory = JointConfidenceHistories.Find(SourceDevice);
+	if (!JointConfidenceHistory)
 	{
-		if (!JointConfidenceHistoriesRight.Contains(DevicesToCombine[FrameIdx]->GetDevice()))
-		{
-			JointConfidenceHistoriesRight.Add(DevicesToCombine[FrameIdx]->GetDevice(), FJointConfidenceHistory(NumJointPositions));
-		}
-		JointConfidenceHistoriesRight[DevicesToCombine[FrameIdx]->GetDevice()].AddConfidences(JointConfidences[idx]);
-		JointConfidences[idx] = JointConfidenceHistoriesRight[DevicesToCombine[FrameIdx]->GetDevice()].GetAveragedConfidences();
+		JointConfidenceHistory = &JointConfidenceHistories.Add(SourceDevice, FJointConfidenceHistory(NumJointPositions));
 	}
+	JointConfidenceHistory->AddConfidences(JointConfidences[idx]);
+	JointConfidenceHistory->GetAveragedConfidences(JointConfidences[idx]);
 
 	RetConfidences = JointConfidences[idx];
 }
@@ -684,21 +665,24 @@ void FUltraleapCombinedDeviceConfidence::MergeHands(const TArray<const FLeapHand
 		MergedPalmRot = FQuat::FastLerp(Hands[HandsIdx]->Palm.Orientation.Quaternion(), MergedPalmRot, LerpValue);
 	}
 
-	// joints
-	TArray<FVector> MergedJointPositions;
+	// joints, in scratch kept from the last merge
+	TArray<FVector>& MergedJointPositions = ScratchMergedJointPositions;
+	MergedJointPositions.Reset();
 	MergedJointPositions.AddZeroed(NumJointPositions);
 
-	 TArray<TArray<FVector>> JointPositionsList;
+	TArray<TArray<FVector>>& JointPositionsList = ScratchJointPositionsList;
 	
 	// in Unity, vector hand is used here to get the hand vectors in a
 	// linear list which is in local space relative to palm
-	for(auto Hand : Hands)
+	for (int HandsIdx = 0; HandsIdx < Hands.Num(); HandsIdx++)
 	{
-		TArray<FVector> JointPositions;
-		JointPositions.AddZeroed(NumJointPositions);
-		CreateLocalLinearJointList(*Hand, JointPositions);
+		if (JointPositionsList.Num() <= HandsIdx)
+		{
+			JointPositionsList.AddDefaulted();
+		}
 		// should be 25 vectors in here
-		JointPositionsList.Add(JointPositions);
+		JointPositionsList[HandsIdx].SetNumUninitialized(NumJointPositions);
+		CreateLocalLinearJointList(*Hands[HandsIdx], JointPositionsList[HandsIdx]);
 	}
 //#define DEBUG_PASSTHROUGH_CONFIDENCE
 #ifdef DEBUG_PASSTHROUGH_CONFIDENCE
@@ -751,7 +735,7 @@ void FUltraleapCombinedDeviceConfidence::ConfidenceRelativeJointRot(
 	}
 	static const int NumBones = 4;
 	int FingerIndex = 0;
-	for(auto Finger : Hand.Digits)
+	for(const auto& Finger : Hand.Digits)
 	{
 		for (int BoneIdx = 0; BoneIdx < NumBones; BoneIdx++)
 		{
@@ -793,7 +777,7 @@ void FUltraleapCombinedDeviceConfidence::ConfidenceRelativeJointRotToPalmRot(
 		Confidences.AddZeroed(NumJointPositions);
 	}
 
-	for(auto Finger : Hand.Digits)
+	for(const auto& Finger : Hand.Digits)
 	{
 		static const int NumBones = 4;
 		int FingerIndex = 0;
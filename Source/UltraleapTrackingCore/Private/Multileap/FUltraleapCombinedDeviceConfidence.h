@@ -10,20 +10,19 @@
 #include "FUltraleapCombinedDevice.h"
 #include "JointOcclusionActor.h"
 
+// ring of the last NumItems palm positions and the times they were seen
 class FHandPositionHistory
 {
 public:
 	FHandPositionHistory()
 	{
-		Positions.AddZeroed(NumItems);
-		Times.AddZeroed(NumItems);
 		Index = 0;
+		Count = 0;
 	}
 
 	void ClearAllPositions()
 	{
-		Positions.Empty();
-		Positions.AddZeroed(NumItems);
+		Count = 0;
 	}
 
 	void AddPosition(const FVector& Position, const float Time)
@@ -31,110 +30,102 @@ public:
 		Positions[Index] = Position;
 		Times[Index] = Time;
 		Index = (Index + 1) % NumItems;
+		Count = FMath::Min(Count + 1, NumItems);
 	}
 
-	bool GetPastPosition(const int PastIndex, FVector& Position, float& Time)
+	bool GetPastPosition(const int PastIndex, FVector& Position, float& Time) const
 	{
-		Position = Positions[(Index - 1 - PastIndex + NumItems) % NumItems];
-		Time = Times[(Index - 1 - PastIndex + NumItems) % NumItems];
-
-		if (Position == FVector::ZeroVector)
+		if (PastIndex >= Count)
 		{
+			Position = FVector::ZeroVector;
+			Time = 0;
 			return false;
 		}
-		else
-		{
-			return true;
-		}
+		Position = Positions[(Index - 1 - PastIndex + NumItems) % NumItems];
+		Time = Times[(Index - 1 - PastIndex + NumItems) % NumItems];
+		return true;
 	}
 
-	bool GetOldestPosition(FVector& Position, float& Time)
+	bool GetOldestPosition(FVector& Position, float& Time) const
 	{
-		for (int i = (NumItems - 1); i >= 0; i--)
-		{
-			if (GetPastPosition(i, Position, Time))
-			{
-				return true;
-			}
-		}
-
-		GetPastPosition(0, Position, Time);
-		return false;
+		return GetPastPosition(FMath::Max(Count - 1, 0), Position, Time);
 	}
 
 protected:
-	IHandTrackingDevice* Provider;
-	TArray<FVector> Positions;
-	TArray<float> Times;
-	int Index;
-
 	static const int NumItems = 10;
+
+	FVector Positions[NumItems];
+	float Times[NumItems];
+	int Index;
+	int Count;
 };
 
 // small helper class to save previous joint confidences and average over them
+// confidences live in one flat ring with a running sum per joint, so adding and averaging are O(1) per joint
 class FJointConfidenceHistory
 {
 
 public:
-	FJointConfidenceHistory(const int NumJointPositions, const int LengthIn = 60)
+	FJointConfidenceHistory(const int NumJointPositionsIn, const int LengthIn = 60)
 	{
 		Length = LengthIn;
-		JointConfidences.AddZeroed(Length);
-
-		for (int i = 0; i < Length; ++i)
-		{
-			JointConfidences[i].AddZeroed(NumJointPositions);
-		}
+		NumJointPositions = NumJointPositionsIn;
+		JointConfidences.AddZeroed(Length * NumJointPositions);
+		ConfidenceSums.AddZeroed(NumJointPositions);
 		Index = 0;
+		Count = 0;
 	}
 
 	void ClearAll()
 	{
-		ValidIndices.Empty();
+		FMemory::Memzero(ConfidenceSums.GetData(), ConfidenceSums.Num() * sizeof(double));
+		Count = 0;
 	}
 
 	void AddConfidences(const TArray<float>& Confidences)
 	{
-		for (int JointIndex = 0; JointIndex < Confidences.Num(); JointIndex++)
+		float* Slot = &JointConfidences[Index * NumJointPositions];
+		const int NumToAdd = FMath::Min(Confidences.Num(), NumJointPositions);
+		for (int JointIndex = 0; JointIndex < NumToAdd; JointIndex++)
 		{
-			JointConfidences[Index][JointIndex] = Confidences[JointIndex];
-		}
-		if (ValidIndices.Find(Index) == -1)
-		{
-			ValidIndices.Add(Index);
+			// the oldest entry leaves the sum once the ring is full
+			if (Count == Length)
+			{
+				ConfidenceSums[JointIndex] -= Slot[JointIndex];
+			}
+			Slot[JointIndex] = Confidences[JointIndex];
+			ConfidenceSums[JointIndex] += Slot[JointIndex];
 		}
 		Index = (Index + 1) % Length;
+		Count = FMath::Min(Count + 1, Length);
 	}
 
-	TArray<float> GetAveragedConfidences()
+	// OutAverages keeps its allocation from call to call, returns false (and empties it) with nothing recorded
+	bool GetAveragedConfidences(TArray<float>& OutAverages) const
 	{
-		TArray<float> EmptyRet;
-
-		if (ValidIndices.Num() == 0)
+		if (Count == 0)
 		{
-			return EmptyRet;
+			OutAverages.Reset();
+			return false;
 		}
 
-		AverageConfidences.Empty();
-		AverageConfidences.AddZeroed(JointConfidences[0].Num());
-
-		for (int i = 0; i < AverageConfidences.Num(); i++)
+		OutAverages.SetNumUninitialized(NumJointPositions, false);
+		for (int JointIndex = 0; JointIndex < NumJointPositions; JointIndex++)
 		{
-			for(int j : ValidIndices)
-			{
-				AverageConfidences[i] += JointConfidences[j][i] / ValidIndices.Num();
-			}
+			OutAverages[JointIndex] = (float) (ConfidenceSums[JointIndex] / Count);
 		}
-
-		return AverageConfidences;
+		return true;
 	}
 
 protected:
 	int Length;
-	TArray<TArray<float>> JointConfidences;
-	TArray<float> AverageConfidences;
+	int NumJointPositions;
+	// Length slots of NumJointPositions confidences
+	TArray<float> JointConfidences;
+	// double so adding and removing floats for the lifetime of a hand doesn't drift
+	TArray<double> ConfidenceSums;
 	int Index;
-	TArray<int> ValidIndices;
+	int Count;
 };
 
 // small helper class to save previous whole-hand confidences and average over them
@@ -146,45 +137,45 @@ public:
 		Length = LengthIn;
 		HandConfidences.AddZeroed(Length);
 		Index = 0;
+		Count = 0;
+		ConfidenceSum = 0;
 	}
 
 	void ClearAll()
 	{
-		ValidIndices.Empty();
+		Count = 0;
+		ConfidenceSum = 0;
 	}
 
 	void AddConfidence(const float Confidence)
 	{
-		HandConfidences[Index] = Confidence;
-
-		if (ValidIndices.Find(Index) == -1)
+		if (Count == Length)
 		{
-			ValidIndices.Add(Index);
+			ConfidenceSum -= HandConfidences[Index];
 		}
+		HandConfidences[Index] = Confidence;
+		ConfidenceSum += Confidence;
+
 		Index = (Index + 1) % Length;
+		Count = FMath::Min(Count + 1, Length);
 	}
 
-	float GetAveragedConfidence()
+	float GetAveragedConfidence() const
 	{
-		if (ValidIndices.Num() == 0)
+		if (Count == 0)
 		{
 			return 0;
 		}
 
-		float ConfidenceSum = 0;
-		for (int j : ValidIndices)
-		{
-			ConfidenceSum += HandConfidences[j];
-		}
-
-		return ConfidenceSum / ValidIndices.Num();
+		return (float) (ConfidenceSum / Count);
 	}
 
 protected:
 	int Length;
 	TArray<float> HandConfidences;
 	int Index;
-	TArray<int> ValidIndices;
+	int Count;
+	double ConfidenceSum;
 };
  
 
@@ -254,6 +245,17 @@ private:
 	int32 NumLeftHands = 0;
 	int32 NumRightHands = 0;
 
+	// MergeFrames and MergeHands scratch, kept so merging reuses its allocations from tick to tick.
+	// The row arrays only grow, the hand lists say how many rows are in use
+	TArray<const FLeapHandData*> ScratchLeftHands;
+	TArray<const FLeapHandData*> ScratchRightHands;
+	TArray<float> ScratchLeftHandConfidences;
+	TArray<float> ScratchRightHandConfidences;
+	TArray<TArray<float>> ScratchLeftJointConfidences;
+	TArray<TArray<float>> ScratchRightJointConfidences;
+	TArray<TArray<FVector>> ScratchJointPositionsList;
+	TArray<FVector> ScratchMergedJointPositions;
+
 	void MergeFrames(const TArray<FLeapFrameData>& SourceFrames, FLeapFrameData& CombinedFrame);
 	void AddFrameToTimeVisibleDicts(const TArray<FLeapFrameData>& Frames, const int FrameIdx);
 	float CalculateHandConfidence(int FrameIdx, const FLeapHandData& Hand);
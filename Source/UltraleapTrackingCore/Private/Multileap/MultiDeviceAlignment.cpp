@@ -7,14 +7,65 @@
  ******************************************************************************/
 
 #include "MultiDeviceAlignment.h"
+#include "LeapAsync.h"
 #include "LeapComponent.h"
 #include "FUltraleapDevice.h"
 #include "FUltraleapCombinedDevice.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+// a solve where fewer of the points agree is most likely two different hand shapes, don't trust it
+const float MinInlierFraction = 0.5f;
+const int32 NumRobustSamples = 64;
+
+FString GetCalibrationPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Ultraleap"), TEXT("MultiDeviceAlignment.txt"));
+}
+
+// serials can be display names with spaces ("Recording 1 file"), so they're written as escaped quoted strings
+FString QuoteSerial(const FString& Serial)
+{
+	return TEXT("\"") + Serial.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\"")) + TEXT("\"");
+}
+
+const TCHAR* SkipWhitespace(const TCHAR* Stream)
+{
+	while (FChar::IsWhitespace(*Stream))
+	{
+		++Stream;
+	}
+	return Stream;
+}
+
+/** Splits a calibration line into its two quoted serials and the transform after them */
+bool ParseCalibrationLine(const FString& Line, FString& OutSourceSerial, FString& OutTargetSerial, FString& OutTransform)
+{
+	const TCHAR* Stream = SkipWhitespace(*Line);
+	int32 NumRead = 0;
+	if (!FParse::QuotedString(Stream, OutSourceSerial, &NumRead))
+	{
+		return false;
+	}
+	Stream = SkipWhitespace(Stream + NumRead);
+	if (!FParse::QuotedString(Stream, OutTargetSerial, &NumRead))
+	{
+		return false;
+	}
+	OutTransform = FString(Stream + NumRead).TrimStartAndEnd();
+	return true;
+}
+}	 // namespace
 
 // Sets default values for this component's properties
 UMultiDeviceAlignment::UMultiDeviceAlignment()
 {
 	AlignmentVariance = 2;
+	SamplesPerSolve = 600;
+	bPersistCalibration = true;
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
@@ -32,6 +83,14 @@ void UMultiDeviceAlignment::BeginPlay()
 	
 }
 
+void UMultiDeviceAlignment::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// the solve task uses the solver and point buffers
+	ResetCalibration();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 
 // Called every frame
 void UMultiDeviceAlignment::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -42,10 +101,28 @@ void UMultiDeviceAlignment::TickComponent(float DeltaTime, ELevelTick TickType,
 }
 void UMultiDeviceAlignment::UpdateTrackingDevices()
 {
-	if (SourceDevice && TargetDevice)
+	// a different pair of devices, start over and look for its saved calibration
+	ResetCalibration();
+	PositioningComplete = false;
+	bTriedSavedCalibration = false;
+}
+void UMultiDeviceAlignment::Recalibrate()
+{
+	ResetCalibration();
+	// don't fall back to the saved calibration, the new one replaces it
+	bTriedSavedCalibration = true;
+	ReAlignProvider();
+}
+void UMultiDeviceAlignment::ResetCalibration()
+{
+	if (SolveFuture.IsValid())
 	{
-		
+		SolveFuture.Wait();
+		SolveFuture.Reset();
 	}
+	SourceSamples.Reset();
+	TargetSamples.Reset();
+	bHasPreviousSolve = false;
 }
 #if WITH_EDITOR
 // Property notifications
@@ -105,106 +182,229 @@ void UMultiDeviceAlignment::Update()
 	{
 		return;
 	}
-	if (!PositioningComplete)
+	if (PositioningComplete)
+	{
+		return;
+	}
+	if (!bTriedSavedCalibration)
+	{
+		bTriedSavedCalibration = true;
+		if (bPersistCalibration && ApplySavedCalibration())
+		{
+			PositioningComplete = true;
+			return;
+		}
+	}
+
+	if (SolveFuture.IsValid())
+	{
+		if (!SolveFuture.IsReady())
+		{
+			// keep collecting for the next solve meanwhile
+			CollectSamples();
+			return;
+		}
+		SolveFuture.Reset();
+		FinishSolve();
+		if (PositioningComplete)
+		{
+			return;
+		}
+	}
+
+	if (CollectSamples() && SourceSamples.Num() >= SamplesPerSolve)
 	{
-		FLeapFrameData SourceFrame;
-		FLeapFrameData TargetFrame;
+		StartSolve();
+	}
+}
+bool UMultiDeviceAlignment::CollectSamples()
+{
+	const FLeapFrameSnapshotPtr SourceFrame = SourceDevice->LeapComponent->GetLatestFrameSnapshot();
+	const FLeapFrameSnapshotPtr TargetFrame = TargetDevice->LeapComponent->GetLatestFrameSnapshot();
+	if (!SourceFrame.IsValid() || !TargetFrame.IsValid())
+	{
+		return false;
+	}
+	// the game ticks faster than the devices track, don't weight a frame by how many ticks it lasted
+	if (SourceFrame->TimeStamp == LastSourceTimeStamp && TargetFrame->TimeStamp == LastTargetTimeStamp)
+	{
+		return false;
+	}
+	LastSourceTimeStamp = SourceFrame->TimeStamp;
+	LastTargetTimeStamp = TargetFrame->TimeStamp;
 
-		FLeapFrameData SourceFrameRaw;
-		FLeapFrameData TargetFrameRaw;
+	FTransform SourceOrigin;
+	FTransform TargetOrigin;
+	SourceDevice->LeapComponent->GetDeviceOrigin(SourceOrigin);
+	TargetDevice->LeapComponent->GetDeviceOrigin(TargetOrigin);
 
-		const bool SourceIsVR = SourceDevice->LeapComponent->TrackingMode == LEAP_MODE_VR;
+	// Same spaces as GetLatestFrameData with the device origin applied. A VR frame is already transformed by the HMD,
+	// only the rotation into desktop space is missing
+	const bool SourceIsVR = SourceDevice->LeapComponent->TrackingMode == LEAP_MODE_VR;
+	const FTransform SourceTransform = SourceIsVR ? FTransform(FRotator(90, 0, 180).GetInverse(), SourceOrigin.GetLocation())
+												  : FTransform(SourceOrigin.GetRotation(), SourceOrigin.GetLocation());
+	const FTransform TargetTransform(TargetOrigin.GetRotation(), TargetOrigin.GetLocation());
 
-		// avoid applying DeviceOrigin twice if VR
-		SourceDevice->LeapComponent->GetLatestFrameData(SourceFrame, !SourceIsVR);
-		
+	static const int NumFingers = 5;
+	static const int NumJoints = 4;
 
-		TargetDevice->LeapComponent->GetLatestFrameData(TargetFrame, true);
-		if (SourceIsVR)
+	for (const FLeapHandData& SourceHand : SourceFrame->Hands)
+	{
+		const FLeapHandData* TargetHand = GetHandFromFrame(*TargetFrame, SourceHand.HandType);
+		if (TargetHand == nullptr)
 		{
-			FTransform VRDeviceOrigin;
-			const bool Success = SourceDevice->LeapComponent->GetDeviceOrigin(VRDeviceOrigin);
-			// Transform HMD into Desktop rotation
-			FRotator Rotation(90, 0, 180);
-			FUltraleapCombinedDevice::TransformFrame(
-				SourceFrame, VRDeviceOrigin.GetLocation(), Rotation.GetInverse());
+			continue;
 		}
-		
-		TArray<FVector> SourceHandPoints;
-		TArray<FVector> TargetHandPoints;
-		
-#ifdef DEBUG_ALIGNMENT
-		if (GEngine)
+		for (int j = 0; j < NumFingers; j++)
 		{
-			FString ToPrint = FString::Printf(TEXT("Num Hands %d %d"), SourceFrame.Hands.Num(), TargetFrame.Hands.Num());
+			for (int k = 0; k < NumJoints; k++)
+			{
+				const FLeapBoneData& SourceBone = SourceHand.Digits[j].Bones[k];
+				const FLeapBoneData& TargetBone = TargetHand->Digits[j].Bones[k];
+				SourceSamples.Add(SourceTransform.TransformPosition(CalcCentre(SourceBone.PrevJoint, SourceBone.NextJoint)));
+				TargetSamples.Add(TargetTransform.TransformPosition(CalcCentre(TargetBone.PrevJoint, TargetBone.NextJoint)));
+			}
+		}
+	}
+	return true;
+}
+void UMultiDeviceAlignment::StartSolve()
+{
+	Swap(SourceSamples, SolveSourcePoints);
+	Swap(TargetSamples, SolveTargetPoints);
+	SourceSamples.Reset();
+	TargetSamples.Reset();
 
-			GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, ToPrint);
-		}	
-#endif
-		int SourceIndex = 0;
-		for (auto& SourceHand : SourceFrame.Hands )
-		{
-			auto TargetHand = GetHandFromFrame(TargetFrame, SourceHand.HandType);
-			
-			static const int NumFingers = 5;
-			static const int NumJoints = 4;
+	const float InlierDistance = AlignmentVariance;
+	SolveFuture = FLeapAsync::RunLambdaOnBackGroundThreadPool([this, InlierDistance]() {
+		int32 NumInliers = 0;
+		SolvedTransform = Solver.SolveKabschRobust(
+			SolveTargetPoints, SolveSourcePoints, TArray<float>(), InlierDistance, NumInliers, NumRobustSamples);
+		bSolveReliable = NumInliers >= SolveTargetPoints.Num() * MinInlierFraction;
 
-			if (TargetHand != nullptr)
+		// stable once it moves no point further from where the previous solve put it than the variance allowed
+		bSolveStable = false;
+		if (bSolveReliable && bHasPreviousSolve)
+		{
+			float MaxShift = 0;
+			for (const FVector& Point : SolveTargetPoints)
 			{
-				for (int j = 0; j < NumFingers; j++)
-				{
-					for (int k = 0; k < NumJoints; k++)
-					{
-						SourceHandPoints.Add(CalcCentre(SourceHand.Digits[j].Bones[k].PrevJoint,SourceHand.Digits[j].Bones[k].NextJoint));
-						
-						TargetHandPoints.Add(
-							CalcCentre(TargetHand->Digits[j].Bones[k].PrevJoint, TargetHand->Digits[j].Bones[k].NextJoint));
-
-					}
-				}
-
-				// This is temporary while we check if any of the hands points are not close enough to each other
-				PositioningComplete = true;
-
-				for (int i = 0; i < SourceHandPoints.Num(); i++)
-				{
-					const auto Distance = FVector::Distance(SourceHandPoints[i], TargetHandPoints[i]);
-					
-					if (Distance > AlignmentVariance)
-					{
-#ifdef DEBUG_ALIGNMENT
-						if (GEngine)
-						{
-							FString ToPrint = FString::Printf(TEXT("Distance %f %f"), Distance, DistanceRaw);
-
-							GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, ToPrint);
-						}
-#endif
-						// we are already as aligned as we need to be, we can exit the alignment stage
-						PositioningComplete = false;
-						break;
-					}
-				}
-
-				if (PositioningComplete)
-				{
-					return;
-				}
-
-				FMatrix DeviceToOriginDeviceMatrix = Solver.SolveKabsch(TargetHandPoints, SourceHandPoints, 200);
-				FTransform ActorTransformFromSolver = FTransform(DeviceToOriginDeviceMatrix);
-				
-				// to move the target device, we need to be in UE space. This layer is in BSSpace so convert
-				ActorTransformFromSolver = ConvertBSToUETransform(ActorTransformFromSolver);
-				FTransform ActorTransform = TargetDevice->GetActorTransform();
-
-				ActorTransform *= ActorTransformFromSolver;
-				
-				TargetDevice->TeleportTo(ActorTransform.GetLocation(),
-					 ActorTransform.GetRotation().Rotator(), false, true);
-		
-				return;
+				MaxShift = FMath::Max(
+					MaxShift, FVector::Dist(SolvedTransform.TransformPosition(Point), PreviousSolve.TransformPosition(Point)));
 			}
+			bSolveStable = MaxShift <= InlierDistance;
+		}
+	});
+}
+void UMultiDeviceAlignment::FinishSolve()
+{
+	if (!bSolveReliable)
+	{
+		bHasPreviousSolve = false;
+		return;
+	}
+	if (!bSolveStable)
+	{
+		PreviousSolve = SolvedTransform;
+		bHasPreviousSolve = true;
+		return;
+	}
+
+	FTransform ActorTransformFromSolver = FTransform(SolvedTransform);
+
+	// to move the target device, we need to be in UE space. This layer is in BSSpace so convert
+	ActorTransformFromSolver = ConvertBSToUETransform(ActorTransformFromSolver);
+	FTransform ActorTransform = TargetDevice->GetActorTransform();
+
+	ActorTransform *= ActorTransformFromSolver;
+
+	TargetDevice->TeleportTo(ActorTransform.GetLocation(), ActorTransform.GetRotation().Rotator(), false, true);
+
+	PositioningComplete = true;
+	bHasPreviousSolve = false;
+	if (bPersistCalibration)
+	{
+		SaveCalibration();
+	}
+}
+bool UMultiDeviceAlignment::GetDeviceSerials(FString& OutSourceSerial, FString& OutTargetSerial) const
+{
+	OutSourceSerial = SourceDevice->LeapComponent->GetSubscribedDeviceSerial();
+	OutTargetSerial = TargetDevice->LeapComponent->GetSubscribedDeviceSerial();
+	return !OutSourceSerial.IsEmpty() && !OutTargetSerial.IsEmpty();
+}
+// One calibration per line: quoted source serial, quoted target serial and the target actor's transform relative to the
+// source actor
+bool UMultiDeviceAlignment::ApplySavedCalibration()
+{
+	FString SourceSerial;
+	FString TargetSerial;
+	TArray<FString> Lines;
+	if (!GetDeviceSerials(SourceSerial, TargetSerial) || !FFileHelper::LoadFileToStringArray(Lines, *GetCalibrationPath()))
+	{
+		return false;
+	}
+	for (const FString& Line : Lines)
+	{
+		FString LineSourceSerial;
+		FString LineTargetSerial;
+		FString LineTransform;
+		if (!ParseCalibrationLine(Line, LineSourceSerial, LineTargetSerial, LineTransform) || LineSourceSerial != SourceSerial ||
+			LineTargetSerial != TargetSerial)
+		{
+			continue;
+		}
+		FTransform Relative;
+		if (!Relative.InitFromString(LineTransform))
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("UMultiDeviceAlignment ignoring unreadable saved calibration for %s %s"),
+				*SourceSerial, *TargetSerial);
+			return false;
+		}
+		const FTransform ActorTransform = Relative * SourceDevice->GetActorTransform();
+		TargetDevice->TeleportTo(ActorTransform.GetLocation(), ActorTransform.GetRotation().Rotator(), false, true);
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("UMultiDeviceAlignment applied saved calibration for %s %s"), *SourceSerial,
+			*TargetSerial);
+		return true;
+	}
+	return false;
+}
+void UMultiDeviceAlignment::SaveCalibration()
+{
+	FString SourceSerial;
+	FString TargetSerial;
+	if (!GetDeviceSerials(SourceSerial, TargetSerial))
+	{
+		return;
+	}
+	const FString Path = GetCalibrationPath();
+	TArray<FString> Lines;
+	FFileHelper::LoadFileToStringArray(Lines, *Path);
+
+	const FTransform Relative = TargetDevice->GetActorTransform().GetRelativeTransform(SourceDevice->GetActorTransform());
+	const FString Calibration =
+		FString::Printf(TEXT("%s %s %s"), *QuoteSerial(SourceSerial), *QuoteSerial(TargetSerial), *Relative.ToString());
+
+	// replace this pair's line, keep everyone else's
+	bool bReplaced = false;
+	for (FString& Line : Lines)
+	{
+		FString LineSourceSerial;
+		FString LineTargetSerial;
+		FString LineTransform;
+		if (ParseCalibrationLine(Line, LineSourceSerial, LineTargetSerial, LineTransform) && LineSourceSerial == SourceSerial &&
+			LineTargetSerial == TargetSerial)
+		{
+			Line = Calibration;
+			bReplaced = true;
 		}
 	}
-}
\ No newline at end of file
+	if (!bReplaced)
+	{
+		Lines.Add(Calibration);
+	}
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *Path))
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("UMultiDeviceAlignment couldn't save calibration to %s"), *Path);
+	}
+}
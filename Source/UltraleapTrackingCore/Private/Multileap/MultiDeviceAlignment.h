@@ -9,6 +9,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "Components/ActorComponent.h"
 #include "FKabschSolver.h"
 #include "TrackingDeviceBaseActor.h"
@@ -33,7 +34,18 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Leap Devices")
 	float AlignmentVariance;
 
-	
+	/** Point pairs collected over as many frames as it takes before each solve */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Leap Devices")
+	int32 SamplesPerSolve;
+
+	/** Start from the last calibration of this pair of devices, and save new ones (Saved/Ultraleap) */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Leap Devices")
+	bool bPersistCalibration;
+
+	/** Discards the current calibration, saved or not, and calibrates again */
+	UFUNCTION(BlueprintCallable, Category = "Leap Devices")
+	void Recalibrate();
+
 
 #if WITH_EDITOR
 	// property change handlers
@@ -43,6 +55,7 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UFUNCTION()
 	void UpdateTrackingDevices();
@@ -56,8 +69,38 @@ public:
 private:
 
 	bool PositioningComplete = false;
+	bool bTriedSavedCalibration = false;
 
 	void ReAlignProvider();
 	void Update();
 
+	/** Adds this frame's bone centres of hands both devices see, false if there is no new frame since the last call */
+	bool CollectSamples();
+	void StartSolve();
+	void FinishSolve();
+	/** Waits out a solve in flight and forgets everything collected */
+	void ResetCalibration();
+
+	bool GetDeviceSerials(FString& OutSourceSerial, FString& OutTargetSerial) const;
+	bool ApplySavedCalibration();
+	void SaveCalibration();
+
+	// Collected on the game thread, in the target actor's space at the time. The actor isn't moved until a solve is
+	// stable so the samples stay comparable
+	TArray<FVector> SourceSamples;
+	TArray<FVector> TargetSamples;
+	int64 LastSourceTimeStamp = 0;
+	int64 LastTargetTimeStamp = 0;
+
+	// Owned by the solve task while SolveFuture is pending, swapped with the samples when it starts
+	TFuture<void> SolveFuture;
+	TArray<FVector> SolveSourcePoints;
+	TArray<FVector> SolveTargetPoints;
+	FMatrix SolvedTransform = FMatrix::Identity;
+	bool bSolveReliable = false;
+	bool bSolveStable = false;
+
+	// The previous reliable solve, the next one has to agree with it to be applied
+	FMatrix PreviousSolve = FMatrix::Identity;
+	bool bHasPreviousSolve = false;
 };
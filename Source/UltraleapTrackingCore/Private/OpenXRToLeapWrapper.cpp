@@ -25,6 +25,7 @@ FOpenXRToLeapWrapper::FOpenXRToLeapWrapper()
 	DeviceID = OpenXRDeviceID;
 
 	CurrentDeviceInfo = &DummyDeviceInfo;
+	Predictor = ILeapFramePredictor::Create();
 	DummyDeviceInfo = {0};
 	DummyDeviceInfo.size = sizeof(LEAP_DEVICE_INFO);
 	DummyDeviceInfo.serial = (char*) ("OpenXRDummyDevice");
@@ -525,7 +526,20 @@ void FOpenXRToLeapWrapper::ConvertToLeapSpace(LEAP_HAND& LeapHand, const TArray<
 
 LEAP_TRACKING_EVENT* FOpenXRToLeapWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
 {
-	return GetFrame();
+	LEAP_TRACKING_EVENT* Frame = Predictor->Predict(TimeStamp, PredictedFingerFrame);
+	return Frame ? Frame : &DummyLeapFrame;
+}
+bool FOpenXRToLeapWrapper::GetInterpolatedFramesAtTimes(
+	int64 FingerTimeStamp, int64 HandTimeStamp, LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame)
+{
+	OutFingerFrame = Predictor->Predict(FingerTimeStamp, PredictedFingerFrame);
+	OutHandFrame = Predictor->Predict(HandTimeStamp, PredictedHandFrame);
+	if (!OutFingerFrame || !OutHandFrame)
+	{
+		OutFingerFrame = &DummyLeapFrame;
+		OutHandFrame = &DummyLeapFrame;
+	}
+	return true;
 }
 void FOpenXRToLeapWrapper::UpdateHandState()
 {
@@ -602,6 +616,7 @@ LEAP_TRACKING_EVENT* FOpenXRToLeapWrapper::GetFrame()
 	{
 		RightHandVisible = false;
 	}
+	Predictor->Observe(&DummyLeapFrame);
 
 	return &DummyLeapFrame;
 }
@@ -620,6 +635,11 @@ void FOpenXRToLeapWrapper::SetWorld(UWorld* World)
 {
 	if (World!=nullptr)
 	{
+		// frames are timestamped with world time, which the new world starts over
+		if (World != CurrentWorld)
+		{
+			Predictor->Reset();
+		}
 		FLeapWrapperBase::SetWorld(World);
 	}
 	/* no delta TODO: get world framerate from somewhere if (World)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "LeapFramePredictor.h"
 #include "LeapWrapper.h"
 #include "SceneManagement.h"
 
@@ -62,7 +63,11 @@ public:
 	// FLeapWrapperBase overrides (base stubs out old leap calls)
 	virtual LEAP_CONNECTION* OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate, bool UseMultiDeviceMode) override;
 	virtual void CloseConnection() override;
+	/** Predicted from the frames GetFrame has sampled so far, OpenXR can't be asked about other times.
+	 * Falls back to the last sampled frame */
 	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override;
+	virtual bool GetInterpolatedFramesAtTimes(int64 FingerTimeStamp, int64 HandTimeStamp,
+		LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame) override;
 	virtual LEAP_TRACKING_EVENT* GetFrame() override;
 	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override;
 	virtual int64_t GetNow() override
@@ -107,6 +112,11 @@ private:
 	LEAP_HAND DummyLeapHands[2];
 	LEAP_DEVICE_INFO DummyDeviceInfo;
 
+	// Sampled frames, timestamped with the world time they were sampled at
+	TUniquePtr<ILeapFramePredictor> Predictor;
+	FLeapFrameHistory::FFrame PredictedFingerFrame;
+	FLeapFrameHistory::FFrame PredictedHandFrame;
+
 	void SetHandJointFromKeypoint(const int Keypoint, LEAP_HAND& LeapHand, const FVector& Position, const FQuat& Rotation);
 	void SetHandJointFromKeypointExt(const int Keypoint, LEAP_HAND& LeapHand, const FVector& Position, const FQuat& Rotation);
 
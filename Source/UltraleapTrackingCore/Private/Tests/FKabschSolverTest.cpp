@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Multileap/FKabschSolver.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+const int32 TestSeed = 0x4c656170;
+const FRotator KnownRotation(20.f, 35.f, -10.f);
+const FVector KnownTranslation(12.f, -5.f, 30.f);
+
+FVector ApplyKnownTransform(const FVector& Point)
+{
+	return KnownRotation.RotateVector(Point) + KnownTranslation;
+}
+
+/** Spread through a 200mm cube, roughly the span of two tracked hands */
+FVector RandomPoint(FRandomStream& Random)
+{
+	return FVector(Random.FRandRange(-100.f, 100.f), Random.FRandRange(-100.f, 100.f), Random.FRandRange(-100.f, 100.f));
+}
+
+void MakePoints(FRandomStream& Random, const int32 NumPoints, const float Noise, TArray<FVector>& OutInPoints,
+	TArray<FVector>& OutRefPoints)
+{
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		const FVector Point = RandomPoint(Random);
+		const FVector Jitter(Random.FRandRange(-Noise, Noise), Random.FRandRange(-Noise, Noise), Random.FRandRange(-Noise, Noise));
+		OutInPoints.Add(Point);
+		OutRefPoints.Add(ApplyKnownTransform(Point) + Jitter);
+	}
+}
+
+/** The solved transform must agree with the known one everywhere in the sampled volume, not only at the fitted points */
+void TestRecoversKnownTransform(FAutomationTestBase& Test, const FMatrix& Transform, const float Tolerance)
+{
+	const FVector Probes[] = {FVector::ZeroVector, FVector(100.f, 0.f, 0.f), FVector(0.f, 100.f, 0.f), FVector(0.f, 0.f, 100.f),
+		FVector(-80.f, 60.f, -40.f)};
+	for (const FVector& Probe : Probes)
+	{
+		const FVector Expected = ApplyKnownTransform(Probe);
+		const FVector Actual = Transform.TransformPosition(Probe);
+		Test.TestTrue(FString::Printf(TEXT("%s maps to %s, expected %s"), *Probe.ToString(), *Actual.ToString(),
+						  *Expected.ToString()),
+			FVector::Dist(Actual, Expected) <= Tolerance);
+	}
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKabschSolverKnownTransformTest, "UltraleapTracking.Multileap.KabschSolver.KnownTransform",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKabschSolverKnownTransformTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(TestSeed);
+	TArray<FVector> InPoints;
+	TArray<FVector> RefPoints;
+	MakePoints(Random, 40, 0.1f, InPoints, RefPoints);
+
+	FKabschSolver Solver;
+	TestRecoversKnownTransform(*this, Solver.SolveKabsch(InPoints, RefPoints), 0.5f);
+
+	// mismatched sets aren't solvable
+	RefPoints.Pop();
+	TestTrue(TEXT("Mismatched point counts give identity"), Solver.SolveKabsch(InPoints, RefPoints).Equals(FMatrix::Identity));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKabschSolverWeightedTest, "UltraleapTracking.Multileap.KabschSolver.Weighted",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKabschSolverWeightedTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(TestSeed);
+	TArray<FVector> InPoints;
+	TArray<FVector> RefPoints;
+	MakePoints(Random, 30, 0.f, InPoints, RefPoints);
+
+	// a badly tracked third of the joints, given no confidence
+	TArray<float> Weights;
+	for (int32 Index = 0; Index < InPoints.Num(); ++Index)
+	{
+		const bool bCorrupt = Index % 3 == 0;
+		if (bCorrupt)
+		{
+			RefPoints[Index] += FVector(50.f, -40.f, 30.f);
+		}
+		Weights.Add(bCorrupt ? 0.f : Random.FRandRange(0.2f, 1.f));
+	}
+
+	FKabschSolver Solver;
+	TestRecoversKnownTransform(*this, Solver.SolveKabsch(InPoints, RefPoints, Weights), 0.01f);
+
+	// and unweighted the corrupt points must pull the fit away, or the weights weren't what made the difference
+	const FMatrix Unweighted = Solver.SolveKabsch(InPoints, RefPoints);
+	TestTrue(TEXT("Unweighted fit is pulled by the corrupt points"),
+		FVector::Dist(Unweighted.TransformPosition(FVector::ZeroVector), ApplyKnownTransform(FVector::ZeroVector)) > 1.f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKabschSolverRobustTest, "UltraleapTracking.Multileap.KabschSolver.Robust",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKabschSolverRobustTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(TestSeed);
+	TArray<FVector> InPoints;
+	TArray<FVector> RefPoints;
+	const int32 NumInliers = 24;
+	MakePoints(Random, NumInliers, 0.1f, InPoints, RefPoints);
+
+	// gross outliers with no weights to tell them apart
+	const int32 NumOutliers = 6;
+	for (int32 Index = 0; Index < NumOutliers; ++Index)
+	{
+		const FVector Point = RandomPoint(Random);
+		InPoints.Add(Point);
+		RefPoints.Add(ApplyKnownTransform(Point) + Random.GetUnitVector() * Random.FRandRange(30.f, 80.f));
+	}
+
+	FKabschSolver Solver;
+	int32 NumFound = 0;
+	const FMatrix Transform = Solver.SolveKabschRobust(InPoints, RefPoints, TArray<float>(), 2.f, NumFound);
+	TestEqual(TEXT("Inliers found"), NumFound, NumInliers);
+	TestRecoversKnownTransform(*this, Transform, 0.5f);
+
+	// same seed, same answer
+	int32 NumFoundAgain = 0;
+	TestTrue(TEXT("Robust fit is repeatable"),
+		Solver.SolveKabschRobust(InPoints, RefPoints, TArray<float>(), 2.f, NumFoundAgain).Equals(Transform, 0.f));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKabschSolverDegenerateTest, "UltraleapTracking.Multileap.KabschSolver.Degenerate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKabschSolverDegenerateTest::RunTest(const FString& Parameters)
+{
+	// collinear, the roll about the line can't be recovered but the line itself must still land on the reference
+	TArray<FVector> InPoints;
+	TArray<FVector> RefPoints;
+	const FVector Direction = FVector(1.f, 2.f, -1.f).GetSafeNormal();
+	for (int32 Index = 0; Index < 10; ++Index)
+	{
+		const FVector Point = Direction * (Index * 15.f - 70.f);
+		InPoints.Add(Point);
+		RefPoints.Add(ApplyKnownTransform(Point));
+	}
+
+	FKabschSolver Solver;
+	const FMatrix Transform = Solver.SolveKabsch(InPoints, RefPoints);
+	TestFalse(TEXT("Collinear fit is finite"), Transform.ContainsNaN());
+	for (int32 Index = 0; Index < InPoints.Num(); ++Index)
+	{
+		TestTrue(FString::Printf(TEXT("Collinear point %d lands on its reference"), Index),
+			FVector::Dist(Transform.TransformPosition(InPoints[Index]), RefPoints[Index]) <= 0.01f);
+	}
+
+	// a single point only fixes the translation
+	const TArray<FVector> OneIn = {FVector(10.f, 20.f, 30.f)};
+	const TArray<FVector> OneRef = {FVector(-5.f, 0.f, 15.f)};
+	const FMatrix Translation = Solver.SolveKabsch(OneIn, OneRef);
+	TestTrue(TEXT("Single point fit is a translation"),
+		Translation.TransformVector(FVector::ForwardVector).Equals(FVector::ForwardVector));
+	TestTrue(TEXT("Single point lands on its reference"), Translation.TransformPosition(OneIn[0]).Equals(OneRef[0], 0.01f));
+
+	// nothing to fit
+	TestTrue(
+		TEXT("Empty sets give identity"), Solver.SolveKabsch(TArray<FVector>(), TArray<FVector>()).Equals(FMatrix::Identity));
+	return true;
+}
+
+#endif	  // WITH_DEV_AUTOMATION_TESTS
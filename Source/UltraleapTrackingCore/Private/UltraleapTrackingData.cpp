@@ -14,6 +14,75 @@
 #define MAX_DIGITS 5		 // almost all humans have 5?
 #define MAX_DIGIT_BONES 4	 // some bones don't have all bones, see Leap documentation
 
+namespace
+{
+void TransformBoneData(FLeapBoneData& Bone, const FLeapVectorTransform& Transform)
+{
+	Transform.TransformPosition(Bone.PrevJoint);
+	Transform.TransformPosition(Bone.NextJoint);
+	Transform.RotateRotator(Bone.Rotation);
+}
+
+void TransformDigitData(FLeapDigitData& Digit, const FLeapVectorTransform& Transform)
+{
+	for (auto& Bone : Digit.Bones)
+	{
+		TransformBoneData(Bone, Transform);
+	}
+
+	// the named bones are copies of the array, refresh them rather than transforming twice
+	if (Digit.Bones.Num() == MAX_DIGIT_BONES)
+	{
+		Digit.Metacarpal = Digit.Bones[0];
+		Digit.Proximal = Digit.Bones[1];
+		Digit.Intermediate = Digit.Bones[2];
+		Digit.Distal = Digit.Bones[3];
+	}
+	else
+	{
+		TransformBoneData(Digit.Metacarpal, Transform);
+		TransformBoneData(Digit.Proximal, Transform);
+		TransformBoneData(Digit.Intermediate, Transform);
+		TransformBoneData(Digit.Distal, Transform);
+	}
+}
+
+void TransformHandData(FLeapHandData& Hand, const FLeapVectorTransform& Transform)
+{
+	TransformBoneData(Hand.Arm, Transform);
+
+	Transform.TransformPosition(Hand.Palm.Position);
+	Transform.TransformPosition(Hand.Palm.StabilizedPosition);
+	Transform.TransformVector(Hand.Palm.Velocity);
+	Transform.RotateVector(Hand.Palm.Direction);
+	Transform.RotateVector(Hand.Palm.Normal);
+	Transform.RotateRotator(Hand.Palm.Orientation);
+
+	for (auto& Digit : Hand.Digits)
+	{
+		TransformDigitData(Digit, Transform);
+	}
+
+	// as with the bones, the named digits are copies of the array
+	if (Hand.Digits.Num() == MAX_DIGITS)
+	{
+		Hand.Thumb = Hand.Digits[0];
+		Hand.Index = Hand.Digits[1];
+		Hand.Middle = Hand.Digits[2];
+		Hand.Ring = Hand.Digits[3];
+		Hand.Pinky = Hand.Digits[4];
+	}
+	else
+	{
+		TransformDigitData(Hand.Thumb, Transform);
+		TransformDigitData(Hand.Index, Transform);
+		TransformDigitData(Hand.Middle, Transform);
+		TransformDigitData(Hand.Ring, Transform);
+		TransformDigitData(Hand.Pinky, Transform);
+	}
+}
+}	 // namespace
+
 FLeapHandData FLeapFrameData::HandForId(int32 HandId)
 {
 	for (auto& Hand : Hands)
@@ -102,25 +171,25 @@ void FLeapFrameData::SetInterpolationPartialFromLeapFrame(
 
 void FLeapFrameData::ScaleFrame(float InScale)
 {
-	for (auto& Hand : Hands)
-	{
-		Hand.ScaleHand(InScale);
-	}
+	TransformFrame(FTransform(FQuat::Identity, FVector::ZeroVector, FVector(InScale)));
 }
 
 void FLeapFrameData::RotateFrame(const FRotator& InRotation)
 {
-	for (auto& Hand : Hands)
-	{
-		Hand.RotateHand(InRotation);
-	}
+	TransformFrame(FTransform(InRotation));
 }
 
 void FLeapFrameData::TranslateFrame(const FVector& InTranslation)
 {
+	TransformFrame(FTransform(InTranslation));
+}
+
+void FLeapFrameData::TransformFrame(const FTransform& InTransform)
+{
+	const FLeapVectorTransform Transform(InTransform);
 	for (auto& Hand : Hands)
 	{
-		Hand.TranslateHand(InTranslation);
+		TransformHandData(Hand, Transform);
 	}
 }
 void FLeapHandData::InitFromEmpty(const EHandType HandTypeIn, const int HandID)
@@ -176,6 +245,30 @@ void FLeapHandData::UpdateFromDigits()
 	Pinky = Digits[4];
 	
 }
+void FLeapHandData::CopyFrom(const FLeapHandData& Other)
+{
+	Arm = Other.Arm;
+	Confidence = Other.Confidence;
+	Digits.SetNum(Other.Digits.Num());
+	for (int32 DigitIndex = 0; DigitIndex < Digits.Num(); ++DigitIndex)
+	{
+		Digits[DigitIndex].CopyFrom(Other.Digits[DigitIndex]);
+	}
+	Flags = Other.Flags;
+	GrabAngle = Other.GrabAngle;
+	GrabStrength = Other.GrabStrength;
+	HandType = Other.HandType;
+	Index.CopyFrom(Other.Index);
+	Middle.CopyFrom(Other.Middle);
+	Palm = Other.Palm;
+	PinchDistance = Other.PinchDistance;
+	PinchStrength = Other.PinchStrength;
+	Pinky.CopyFrom(Other.Pinky);
+	Ring.CopyFrom(Other.Ring);
+	Thumb.CopyFrom(Other.Thumb);
+	Id = Other.Id;
+	VisibleTime = Other.VisibleTime;
+}
 void FLeapHandData::SetFromLeapHand(
 	struct _LEAP_HAND* hand, const FVector& LeapMountTranslationOffset, const FQuat& LeapMountRotationOffset)
 {
@@ -197,11 +290,12 @@ void FLeapHandData::SetFromLeapHand(
 
 	Flags = hand->flags;
 
-	Index.SetFromLeapDigit((_LEAP_DIGIT*) &hand->index, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Middle.SetFromLeapDigit((_LEAP_DIGIT*) &hand->middle, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Pinky.SetFromLeapDigit((_LEAP_DIGIT*) &hand->pinky, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Ring.SetFromLeapDigit((_LEAP_DIGIT*) &hand->ring, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Thumb.SetFromLeapDigit((_LEAP_DIGIT*) &hand->thumb, LeapMountTranslationOffset, LeapMountRotationOffset);
+	// the named digits alias digits[] in LEAP_HAND, copy rather than convert them again
+	Thumb = Digits[0];
+	Index = Digits[1];
+	Middle = Digits[2];
+	Ring = Digits[3];
+	Pinky = Digits[4];
 
 	PinchDistance = FLeapUtility::ScaleLeapFloatToUE(hand->pinch_distance);
 	PinchStrength = hand->pinch_strength;
@@ -232,51 +326,22 @@ void FLeapHandData::SetArmPartialsFromLeapHand(struct _LEAP_HAND* hand, const FV
 
 void FLeapHandData::ScaleHand(float InScale)
 {
-	Arm.ScaleBone(InScale);
-
-	Index.ScaleDigit(InScale);
-	Middle.ScaleDigit(InScale);
-	Pinky.ScaleDigit(InScale);
-	Ring.ScaleDigit(InScale);
-	Thumb.ScaleDigit(InScale);
-
-	Palm.ScalePalm(InScale);
+	TransformHand(FTransform(FQuat::Identity, FVector::ZeroVector, FVector(InScale)));
 }
 
 void FLeapHandData::RotateHand(const FRotator& InRotation)
 {
-	Arm.RotateBone(InRotation);
-
-	Index.RotateDigit(InRotation);
-	Middle.RotateDigit(InRotation);
-	Pinky.RotateDigit(InRotation);
-	Ring.RotateDigit(InRotation);
-	Thumb.RotateDigit(InRotation);
-
-	Palm.RotatePalm(InRotation);
-
-	for (auto& Digit : Digits)
-	{
-		Digit.RotateDigit(InRotation);
-	}
+	TransformHand(FTransform(InRotation));
 }
 
 void FLeapHandData::TranslateHand(const FVector& InTranslation)
 {
-	Arm.TranslateBone(InTranslation);
-
-	Index.TranslateDigit(InTranslation);
-	Middle.TranslateDigit(InTranslation);
-	Pinky.TranslateDigit(InTranslation);
-	Ring.TranslateDigit(InTranslation);
-	Thumb.TranslateDigit(InTranslation);
-
-	Palm.TranslatePalm(InTranslation);
+	TransformHand(FTransform(InTranslation));
+}
 
-	for(auto& Digit : Digits)
-	{
-		Digit.TranslateDigit(InTranslation);
-	}
+void FLeapHandData::TransformHand(const FTransform& InTransform)
+{
+	TransformHandData(*this, FLeapVectorTransform(InTransform));
 }
 
 void FLeapBoneData::SetFromLeapBone(
@@ -323,15 +388,30 @@ void FLeapDigitData::SetFromLeapDigit(
 		Bones[i].SetFromLeapBone((_LEAP_BONE*) &digit->bones[i], LeapMountTranslationOffset, LeapMountRotationOffset);
 	}
 
-	Distal.SetFromLeapBone((_LEAP_BONE*) &digit->distal, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Intermediate.SetFromLeapBone((_LEAP_BONE*) &digit->intermediate, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Metacarpal.SetFromLeapBone((_LEAP_BONE*) &digit->metacarpal, LeapMountTranslationOffset, LeapMountRotationOffset);
-	Proximal.SetFromLeapBone((_LEAP_BONE*) &digit->proximal, LeapMountTranslationOffset, LeapMountRotationOffset);
+	// the named bones alias bones[] in LEAP_DIGIT
+	Metacarpal = Bones[0];
+	Proximal = Bones[1];
+	Intermediate = Bones[2];
+	Distal = Bones[3];
 
 	FingerId = digit->finger_id;
 	IsExtended = digit->is_extended == 1;
 }
 
+void FLeapDigitData::CopyFrom(const FLeapDigitData& Other)
+{
+	Bones.SetNum(Other.Bones.Num());
+	for (int32 BoneIndex = 0; BoneIndex < Bones.Num(); ++BoneIndex)
+	{
+		Bones[BoneIndex] = Other.Bones[BoneIndex];
+	}
+	Distal = Other.Distal;
+	FingerId = Other.FingerId;
+	Intermediate = Other.Intermediate;
+	IsExtended = Other.IsExtended;
+	Metacarpal = Other.Metacarpal;
+	Proximal = Other.Proximal;
+}
 void FLeapDigitData::ScaleDigit(float InScale)
 {
 	Distal.ScaleBone(InScale);
@@ -446,6 +526,20 @@ FLeapOptions::FLeapOptions()
 	// bEnableImageStreaming = false;		//default image streaming to off
 }
 
+FLeapFramePacingStats::FLeapFramePacingStats()
+	: ObservedFrameRate(0)
+	, DeviceFrameRate(0)
+	, FrameIntervalJitterInMS(0)
+	, MaxFrameIntervalInMS(0)
+	, DeliveryDelayInMS(0)
+	, MaxDeliveryDelayInMS(0)
+	, DroppedInPreprocessingQueue(0)
+	, DroppedInTrackingQueue(0)
+	, DroppedOther(0)
+	, MissedFrameIds(0)
+{
+}
+
 FLeapStats::FLeapStats() : FrameExtrapolationInMS(0)
 {
 }
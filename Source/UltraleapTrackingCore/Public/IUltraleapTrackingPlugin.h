@@ -12,6 +12,8 @@
 #include "UltraleapTrackingData.h"
 
 class ULeapComponent;
+class FLeapFrameHistory;
+struct FLeapFramePose;
 
 
 
@@ -23,8 +25,20 @@ public:
 
 	virtual void Tick(const float DeltaTime) = 0;
 	virtual void SendControllerEvents() = 0;
+	/** SendControllerEvents split in two. CaptureInput doesn't touch UObjects or Slate when CanCaptureOffGameThread()
+	 * so it may run on a task graph worker, EmitInputEvents then runs the gesture checks and events on the game thread */
+	virtual bool CanCaptureOffGameThread() = 0;
+	virtual void CaptureInput() = 0;
+	virtual void EmitInputEvents() = 0;
 
 	virtual void GetLatestFrameData(FLeapFrameData& OutData, const bool ApplyDeviceOrigin  = false) = 0;
+	/** Shared, no copy. Device origin is not applied. Never null, an empty frame with no hands before the first capture */
+	virtual FLeapFrameSnapshotPtr GetLatestFrameSnapshot() = 0;
+	/** Timestamp of the frame the last CaptureInput produced, in the wrapper's GetNow() clock. 0 before the first frame */
+	virtual int64 GetCapturedTimeStamp() = 0;
+	/** Resamples the device's frame history to TimeStamp and converts it the way CaptureInput would, device origin not
+	 * applied. Safe to call concurrently. False if the wrapper keeps no history or it doesn't cover TimeStamp */
+	virtual bool SamplePoseAtTime(const int64 TimeStamp, FLeapFramePose& OutPose) = 0;
 	virtual void AreHandsVisible(bool& LeftHandIsVisible, bool& RightHandIsVisible) = 0;
 	virtual void SetOptions(const FLeapOptions& InOptions) = 0;
 	virtual FLeapOptions GetOptions() = 0;
@@ -61,6 +75,7 @@ public:
 	virtual void OnPolicy(const uint32_t CurrentPolicies){};
 	virtual void OnTrackingMode(const eLeapTrackingMode current_tracking_mode){};
 	virtual void OnFrame(const LEAP_TRACKING_EVENT* TrackingEvent){};
+	virtual void OnDroppedFrame(const LEAP_DROPPED_FRAME_EVENT* DroppedFrameEvent){};
 	virtual void OnImage(const LEAP_IMAGE_EVENT* ImageEvent){};
 	virtual void OnLog(const eLeapLogSeverity Severity, const int64_t Timestamp, const char* Message){};
 	virtual void OnConfigChange(const uint32_t RequestID, const bool Success){};
@@ -72,7 +87,8 @@ public:
 	enum EDeviceType
 	{
 		DEVICE_TYPE_LEAP,
-		DEVICE_TYPE_OPENXR
+		DEVICE_TYPE_OPENXR,
+		DEVICE_TYPE_RECORDING
 	};
 
 	virtual ~IHandTrackingWrapper()
@@ -98,6 +114,10 @@ public:
 	/** Uses leap method to get an interpolated frame at a given leap timestamp in microseconds given by e.g. LeapGetNow()*/
 	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) = 0;
 	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTimeEx(int64 TimeStamp, const uint32_t DeviceID = 0) = 0;
+	/** Interpolates the finger and hand frames for one tick in a single call, both stay valid until the next call.
+	 * Returns false (and nullptrs) if either interpolation failed */
+	virtual bool GetInterpolatedFramesAtTimes(int64 FingerTimeStamp, int64 HandTimeStamp,
+		LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame) = 0;
 	virtual LEAP_DEVICE_INFO* GetDeviceProperties() = 0;
 
 	virtual const char* ResultString(eLeapRS Result) = 0;
@@ -109,6 +129,10 @@ public:
 	virtual void SetWorld(UWorld* World) = 0;
 
 	virtual int64_t GetNow() = 0;
+	/** Camera frame rate reported by the service, 0 if unknown */
+	virtual float GetDeviceFrameRate() = 0;
+	/** Recent frames kept by the wrapper itself, nullptr if it keeps none */
+	virtual const FLeapFrameHistory* GetFrameHistory() = 0;
 
 	virtual void SetSwizzles(
 		ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW) = 0;
@@ -155,6 +179,11 @@ public:
 	virtual void RemoveLeapConnnectorCallback(ILeapConnectorCallbacks* Callback) = 0;
 	// called when the engine is ready for input
 	virtual void PostEarlyInit() = 0;
+	// adds a device fed from a LeapC recording, PlaybackSpeed <= 0 plays as fast as possible
+	virtual class IHandTrackingWrapper* AddRecordingDevice(const FString& FilePath, const float PlaybackSpeed, const bool bLoop) = 0;
+	// records live tracking events to a LeapC recording, DeviceID 0 records the first device seen
+	virtual bool StartRecording(const FString& FilePath, const uint32_t DeviceID = 0) = 0;
+	virtual void StopRecording() = 0;
 };
 /**
  * The public interface to this module.  In most cases, this interface is only public to sibling modules
@@ -26,6 +26,24 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLeapHandSignature, const FLeapHandD
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLeapPolicySignature, TArray<TEnumAsByte<ELeapPolicyFlag>>, Flags);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FLeapImageEventSignature, UTexture2D*, Texture, ELeapImageType, ImageType);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLeapTrackingModeSignature, ELeapMode, Flag);
+DECLARE_MULTICAST_DELEGATE_OneParam(FLeapFrameSnapshotSignature, const FLeapFrameSnapshotRef&);
+
+/** Groups of ULeapComponent events, a component is subscribed to a group while any of its delegates are bound */
+enum class ELeapEventSubscription : uint32
+{
+	None = 0,
+	TrackingData = 1 << 0,    // OnLeapTrackingData, OnLeapFrameSnapshot
+	HandGrab = 1 << 1,        // OnHandGrabbed, OnHandReleased
+	HandPinch = 1 << 2,       // OnHandPinched, OnHandUnpinched
+	HandTracking = 1 << 3,    // OnHandBeginTracking, OnHandEndTracking
+	HandVisibility = 1 << 4,  // OnLeftHandVisibilityChanged, OnRightHandVisibilityChanged
+	Device = 1 << 5,          // OnLeapDeviceAttached, OnLeapDeviceDetached
+	Service = 1 << 6,         // OnLeapServiceConnected, OnLeapServiceDisconnected
+	Policies = 1 << 7,        // OnLeapPoliciesUpdated
+	TrackingMode = 1 << 8,    // OnLeapTrackingModeUpdated
+	Images = 1 << 9,          // OnImageEvent
+};
+ENUM_CLASS_FLAGS(ELeapEventSubscription)
 
 UCLASS(ClassGroup = "Input Controller", meta = (BlueprintSpawnableComponent))
 
@@ -47,6 +65,9 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Leap Events")
 	FLeapFrameSignature OnLeapTrackingData;
 
+	/** C++ only equivalent of OnLeapTrackingData. Every listener receives the same immutable frame instead of a copy */
+	FLeapFrameSnapshotSignature OnLeapFrameSnapshot;
+
 	/** Event called when a leap hand grab gesture is detected */
 	UPROPERTY(BlueprintAssignable, Category = "Leap Events")
 	FLeapHandSignature OnHandGrabbed;
@@ -119,6 +140,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Leap Functions")
 	void GetLatestFrameData(FLeapFrameData& OutData, const bool ApplyDeviceOrigin = false);
 
+	/** C++ only polling without the copy, device origin is not applied. Null without a device, empty before its first frame */
+	FLeapFrameSnapshotPtr GetLatestFrameSnapshot() const;
+
+	/** Event groups with at least one bound delegate. Bindings can change at any time, so this is computed on each call */
+	ELeapEventSubscription GetSubscriptionMask() const;
+	bool IsSubscribedTo(const ELeapEventSubscription Events) const
+	{
+		return EnumHasAnyFlags(GetSubscriptionMask(), Events);
+	}
+
 	UFUNCTION(BlueprintCallable, Category = "Leap Functions")
 	void SetSwizzles(ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW);
 	
@@ -219,6 +250,10 @@ public:
 	UFUNCTION()
 	bool GetDeviceOrigin(FTransform& DeviceOrigin);
 
+	/** Serial of the device this component is subscribed to, empty if none */
+	UFUNCTION(BlueprintCallable, Category = "Leap Functions")
+	FString GetSubscribedDeviceSerial() const;
+
  protected:
 	virtual void InitializeComponent() override;
 	virtual void UninitializeComponent() override;
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+/**
+ * Persistent destination for LeapInterpolateFrame(Ex). The buffer only ever grows, so once it has seen the largest
+ * frame (most hands) the interpolation path makes no allocations. The capacity doubles as the cached result of
+ * LeapGetFrameSize(Ex): callers interpolate straight into it and only query the size again on eLeapRS_InsufficientBuffer.
+ */
+class FLeapInterpolatedFrameBuffer
+{
+public:
+	FLeapInterpolatedFrameBuffer() : Frame(nullptr), Capacity(0)
+	{
+	}
+	~FLeapInterpolatedFrameBuffer()
+	{
+		FMemory::Free(Frame);
+	}
+	FLeapInterpolatedFrameBuffer(const FLeapInterpolatedFrameBuffer&) = delete;
+	FLeapInterpolatedFrameBuffer& operator=(const FLeapInterpolatedFrameBuffer&) = delete;
+
+	/** Grows to at least FrameSize bytes, never shrinks */
+	void Reserve(const uint64 FrameSize)
+	{
+		if (FrameSize > Capacity)
+		{
+			Frame = (LEAP_TRACKING_EVENT*) FMemory::Realloc(Frame, FrameSize);
+			Capacity = FrameSize;
+		}
+	}
+
+	LEAP_TRACKING_EVENT* GetFrame() const
+	{
+		return Frame;
+	}
+	uint64 GetCapacity() const
+	{
+		return Capacity;
+	}
+
+private:
+	LEAP_TRACKING_EVENT* Frame;
+	uint64 Capacity;
+};
@@ -9,8 +9,10 @@
 #pragma once
 #include "Async/Async.h"
 #include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
 #include "HAL/ThreadSafeBool.h"
 #include "LeapC.h"
+#include "LeapInterpolatedFrameBuffer.h"
 #include "UltraleapTrackingData.h"
 #include "IUltraleapTrackingPlugin.h"
 
@@ -67,6 +69,18 @@ public:
 	{
 		return nullptr;
 	}
+	// Fine for wrappers that ignore the timestamp, both frames may alias
+	virtual bool GetInterpolatedFramesAtTimes(int64 FingerTimeStamp, int64 HandTimeStamp,
+		LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame) override
+	{
+		OutFingerFrame = GetInterpolatedFrameAtTime(FingerTimeStamp);
+		OutHandFrame = OutFingerFrame ? GetInterpolatedFrameAtTime(HandTimeStamp) : nullptr;
+		if (!OutHandFrame)
+		{
+			OutFingerFrame = nullptr;
+		}
+		return OutHandFrame != nullptr;
+	}
 	
 	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override
 	{
@@ -89,6 +103,14 @@ public:
 	{
 		CurrentWorld = World;
 	}
+	virtual float GetDeviceFrameRate() override
+	{
+		return 0;
+	}
+	virtual const FLeapFrameHistory* GetFrameHistory() override
+	{
+		return nullptr;
+	}
 
 	virtual void SetSwizzles(
 		ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW) override
@@ -201,6 +223,8 @@ public:
 	/** Uses leap method to get an interpolated frame at a given leap timestamp in microseconds given by e.g. LeapGetNow()*/
 	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override;
 	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTimeEx(int64 TimeStamp, const uint32_t DeviceID = 0) override;
+	virtual bool GetInterpolatedFramesAtTimes(int64 FingerTimeStamp, int64 HandTimeStamp,
+		LEAP_TRACKING_EVENT*& OutFingerFrame, LEAP_TRACKING_EVENT*& OutHandFrame) override;
 
 	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override
 	{
@@ -230,6 +254,12 @@ public:
 	{
 		return LeapGetNow();
 	}
+	virtual float GetDeviceFrameRate() override;
+	// the per device wrappers keep the histories
+	virtual const FLeapFrameHistory* GetFrameHistory() override
+	{
+		return nullptr;
+	}
 	virtual FString GetDeviceSerial() override
 	{
 		return TEXT("LeapWrapper/Connector");
@@ -264,6 +294,9 @@ public:
 	virtual void AddLeapConnectorCallback(ILeapConnectorCallbacks* Callback) override;
 	virtual void RemoveLeapConnnectorCallback(ILeapConnectorCallbacks* Callback) override;
 	virtual void PostEarlyInit() override;
+	virtual IHandTrackingWrapper* AddRecordingDevice(const FString& FilePath, const float PlaybackSpeed, const bool bLoop) override;
+	virtual bool StartRecording(const FString& FilePath, const uint32_t DeviceID = 0) override;
+	virtual void StopRecording() override;
 	// End of ILeapConnector
 
 	// This will handle when an app is deactivated, when system goes to sleep
@@ -283,7 +316,9 @@ private:
 	// Frame and handle data
 	// Actual connected devices
 	TArray <IHandTrackingWrapper*> Devices;
+	// Added to from capture tasks (see CleanupBadDevice), emptied on the game thread in TickDevices
 	TArray<IHandTrackingWrapper*> DevicesToCleanup;
+	FCriticalSection DevicesToCleanupLock;
 	// Aggregated/combined devices
 	TArray<IHandTrackingWrapper*> CombinedDevices;
 
@@ -293,24 +328,20 @@ private:
 
 	// Threading variables
 	FCriticalSection* DataLock;
-	TFuture<void> ProducerLambdaFuture;
-
-	LEAP_TRACKING_EVENT* InterpolatedFrame;
-	uint64 InterpolatedFrameSize;
-
-	// TaskGraph event references are only stored to help with threading debug for now.
-	FGraphEventRef TaskRefConnection;
-	FGraphEventRef TaskRefConnectionLost;
-	FGraphEventRef TaskRefDeviceFound;
-	FGraphEventRef TaskRefDeviceLost;
-	FGraphEventRef TaskRefDeviceFailure;
-	FGraphEventRef TaskRefTracking;
-	FGraphEventRef TaskRefImageComplete;
-	FGraphEventRef TaskRefImageError;
-	FGraphEventRef TaskRefLog;
-	FGraphEventRef TaskRefPolicy;
-	FGraphEventRef TaskRefConfigChange;
-	FGraphEventRef TaskRefConfigResponse;
+	// Dedicated LeapPollConnection thread for ConnectionHandle
+	class FLeapPollThread* PollThread = nullptr;
+
+	// Optional pooled allocator registered with LeapC, outlives the connection
+	class FLeapPooledAllocator* PooledAllocator = nullptr;
+
+	// Grow only, one per timestamp so the finger and hand frames can be held at the same time
+	FLeapInterpolatedFrameBuffer FingerFrameBuffer;
+	FLeapInterpolatedFrameBuffer HandFrameBuffer;
+	/** DeviceHandle nullptr uses the non Ex (default device) LeapC calls */
+	LEAP_TRACKING_EVENT* InterpolateFrame(const int64 TimeStamp, const LEAP_DEVICE DeviceHandle, FLeapInterpolatedFrameBuffer& Buffer);
+
+	// Streams tracking events to disk off the poll thread when recording
+	class FLeapTrackingRecorder* Recorder;
 
 	// Delegate to access the deactivation event
 	FDelegateHandle HasDeactivateHandle;
@@ -320,7 +351,7 @@ private:
 	//void SetDevice(const LEAP_DEVICE_INFO* DeviceProps);
 	
 
-	void ServiceMessageLoop(void* unused = nullptr);
+	void HandleConnectionMessage(const LEAP_CONNECTION_MESSAGE& Msg);
 
 	// Received LeapC callbacks converted into game thread events
 	void HandleConnectionEvent(const LEAP_CONNECTION_EVENT* ConnectionEvent);
@@ -329,6 +360,7 @@ private:
 	void HandleDeviceLostEvent(const LEAP_DEVICE_EVENT* DeviceEvent);
 	void HandleDeviceFailureEvent(const LEAP_DEVICE_FAILURE_EVENT* DeviceFailureEvent, const uint32_t DeviceID);
 	void HandleTrackingEvent(const LEAP_TRACKING_EVENT* TrackingEvent, const uint32_t DeviceID);
+	void HandleDroppedFrameEvent(const LEAP_DROPPED_FRAME_EVENT* DroppedFrameEvent, const uint32_t DeviceID);
 	void HandleImageEvent(const LEAP_IMAGE_EVENT* ImageEvent, const uint32_t DeviceID);
 	void HandleLogEvent(const LEAP_LOG_EVENT* LogEvent, const uint32_t DeviceID);
 	void HandlePolicyEvent(const LEAP_POLICY_EVENT* PolicyEvent, const uint32_t DeviceID);
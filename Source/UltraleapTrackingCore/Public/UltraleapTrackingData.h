@@ -160,6 +160,51 @@ struct ULTRALEAPTRACKING_API FLeapDevice
 	void SetFromLeapDevice(struct _LEAP_DEVICE_INFO* LeapInfo);
 };
 
+/** Frame delivery from the tracking service, refreshed about once a second. Rates and timings cover the last second,
+ * drop counts are totals since the device was opened. */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapFramePacingStats
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapFramePacingStats();
+
+	/** Tracking frames per second received by the plugin. */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float ObservedFrameRate;
+
+	/** Camera frame rate reported by the service (LeapGetDeviceFrameRateEx), 0 if unknown. */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float DeviceFrameRate;
+
+	/** Standard deviation of the interval between tracking frame timestamps. */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float FrameIntervalJitterInMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float MaxFrameIntervalInMS;
+
+	/** Time from the service timestamping a frame to the plugin receiving it. */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float DeliveryDelayInMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float MaxDeliveryDelayInMS;
+
+	/** Frames the service reported dropping, by reason. */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 DroppedInPreprocessingQueue;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 DroppedInTrackingQueue;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 DroppedOther;
+
+	/** Gaps in the tracking frame ids received. More than the service drops points at the plugin side. */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 MissedFrameIds;
+};
+
 /** Read only stats from the plugin such as version and prediction interval. */
 USTRUCT(BlueprintType)
 struct ULTRALEAPTRACKING_API FLeapStats
@@ -175,6 +220,9 @@ struct ULTRALEAPTRACKING_API FLeapStats
 
 	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
 	float FrameExtrapolationInMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	FLeapFramePacingStats FramePacing;
 };
 
 USTRUCT(BlueprintType)
@@ -347,6 +395,8 @@ struct ULTRALEAPTRACKING_API FLeapDigitData
 	void ScaleDigit(float Scale);
 	void RotateDigit(const FRotator& InRotation);
 	void TranslateDigit(const FVector& InTranslation);
+	/** Assignment that writes into the existing Bones array, plain assignment frees and reallocates it */
+	void CopyFrom(const FLeapDigitData& Other);
 };
 
 USTRUCT(BlueprintType)
@@ -415,9 +465,13 @@ struct ULTRALEAPTRACKING_API FLeapHandData
 	void ScaleHand(float Scale);
 	void RotateHand(const FRotator& InRotation);
 	void TranslateHand(const FVector& InTranslation);
+	/** Scale, rotate and translate in a single pass */
+	void TransformHand(const FTransform& InTransform);
 
 	void InitFromEmpty(const EHandType HandTypeIn, const int HandID);
 	void UpdateFromDigits();
+	/** Assignment that writes into the existing digit and bone arrays, plain assignment frees and reallocates them */
+	void CopyFrom(const FLeapHandData& Other);
 };
 
 USTRUCT(BlueprintType)
@@ -459,7 +513,14 @@ struct ULTRALEAPTRACKING_API FLeapFrameData
 	void ScaleFrame(float Scale);
 	void RotateFrame(const FRotator& InRotation);
 	void TranslateFrame(const FVector& InTranslation);
+	/** Scale, rotate and translate in a single pass */
+	void TransformFrame(const FTransform& InTransform);
 };
+
+/** Immutable frame shared by every native listener of a device for one tick, safe to hold on to */
+typedef TSharedRef<const FLeapFrameData, ESPMode::ThreadSafe> FLeapFrameSnapshotRef;
+typedef TSharedPtr<const FLeapFrameData, ESPMode::ThreadSafe> FLeapFrameSnapshotPtr;
+
 UENUM()
 enum class ELeapQuatSwizzleAxisB : uint8
 {
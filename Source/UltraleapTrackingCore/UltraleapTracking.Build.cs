@@ -146,7 +146,19 @@ namespace UnrealBuildTool.Rules
 
             PublicIncludePathModuleNames.AddRange(new string[] { "Launch" });
 
-            LoadLeapLib(Target);
+			// Headless runs without the tracking service: ULTRALEAP_LEAPC_STUB=1 compiles the in-process
+			// LeapC stub (Private/LeapCStub) instead of linking against LeapC
+			if (System.Environment.GetEnvironmentVariable("ULTRALEAP_LEAPC_STUB") == "1")
+			{
+				System.Console.WriteLine("UltraleapTracking using the LeapC stub");
+				PrivateDefinitions.Add("ULTRALEAP_LEAPC_STUB=1");
+				PrivateDefinitions.Add("LEAP_EXPORT=");
+			}
+			else
+			{
+				PrivateDefinitions.Add("ULTRALEAP_LEAPC_STUB=0");
+				LoadLeapLib(Target);
+			}
 		}
 
 		public string GetUProjectPath()